@@ -1,25 +1,44 @@
+import os
 import launch
 import launch_ros
 from ament_index_python.packages import get_package_share_directory
+from launch.conditions import LaunchConfigurationEquals
 from launch.launch_description_sources import PythonLaunchDescriptionSource
+from launch.substitutions import LaunchConfiguration, PythonExpression
+from launch_ros.descriptions import ComposableNode
 
 def generate_launch_description():
     fishbot_bringup_dir = get_package_share_directory(
         'fishbot_bringup')
     ydlidar_ros2_dir = get_package_share_directory(
         'ydlidar')
+    ydlidar_params = os.path.join(ydlidar_ros2_dir, 'params', 'ydlidar.yaml')
+
+    # 进程布局：
+    #   single: 雷达驱动和odom2tf加载到同一个组件容器，进程内通信不经过DDS
+    #   ui:     加载到LVGL界面进程中的组件容器（/lvgl_container），需先启动界面
+    #   multi:  每个节点单独一个进程
+    layout_declare = launch.actions.DeclareLaunchArgument(
+        'layout', default_value='single',
+        description='Process layout: single, ui or multi')
+
+    # 里程计来源：
+    #   wheel: odom2tf转发底盘的odom
+    #   laser: 雷达驱动做激光里程计（底盘odom作为预测），odom2tf改为转发laser_odom
+    odom_source_declare = launch.actions.DeclareLaunchArgument(
+        'odom_source', default_value='wheel',
+        description='Odometry for the odom -> base_footprint TF: wheel or laser')
+    use_laser_odom = PythonExpression(
+        ["'", LaunchConfiguration('odom_source'), "' == 'laser'"])
+    odom_topic = PythonExpression(
+        ["'laser_odom' if '", LaunchConfiguration('odom_source'),
+         "' == 'laser' else 'odom'"])
 
     urdf2tf = launch.actions.IncludeLaunchDescription(
         PythonLaunchDescriptionSource(
             [fishbot_bringup_dir, '/launch', '/urdf2tf.launch.py']),
     )
 
-    odom2tf = launch_ros.actions.Node(
-        package='fishbot_bringup',
-        executable='odom2tf',
-        output='screen'
-    )
-
     # microros_agent = launch_ros.actions.Node(
     #     package='micro_ros_agent',
     #     executable='micro_ros_agent',
@@ -27,25 +46,59 @@ def generate_launch_description():
     #     output='screen'
     # )
 
-    ros_serail2wifi =  launch_ros.actions.Node(
-        package='ros_serail2wifi',
-        executable='tcp_server',
-        parameters=[{'serial_port': '/tmp/tty_laser'}],
-        output='screen'
+    # 雷达驱动直接监听TCP端口，等待Wi-Fi串口桥连接
+    composable_nodes = [
+        ComposableNode(
+            package='ydlidar',
+            plugin='ydlidar_ros2::YdlidarNode',
+            name='ydlidar_node',
+            parameters=[ydlidar_params, {'laser_odom': use_laser_odom}],
+            extra_arguments=[{'use_intra_process_comms': True}]),
+        ComposableNode(
+            package='fishbot_bringup',
+            plugin='fishbot_bringup::OdomTopic2TF',
+            name='odom2tf',
+            remappings=[('odom', odom_topic)],
+            extra_arguments=[{'use_intra_process_comms': True}]),
+    ]
+
+    container = launch_ros.actions.ComposableNodeContainer(
+        name='fishbot_container',
+        namespace='',
+        package='rclcpp_components',
+        executable='component_container',
+        composable_node_descriptions=composable_nodes,
+        output='screen',
+        condition=LaunchConfigurationEquals('layout', 'single')
+    )
+
+    load_into_ui = launch_ros.actions.LoadComposableNodes(
+        target_container='/lvgl_container',
+        composable_node_descriptions=composable_nodes,
+        condition=LaunchConfigurationEquals('layout', 'ui')
+    )
+
+    odom2tf = launch_ros.actions.Node(
+        package='fishbot_bringup',
+        executable='odom2tf',
+        output='screen',
+        remappings=[('odom', odom_topic)],
+        condition=LaunchConfigurationEquals('layout', 'multi')
     )
 
     ydlidar = launch.actions.IncludeLaunchDescription(
         PythonLaunchDescriptionSource(
             [ydlidar_ros2_dir, '/launch', '/ydlidar_launch.py']),
+        launch_arguments={'laser_odom': use_laser_odom}.items(),
+        condition=LaunchConfigurationEquals('layout', 'multi')
     )
 
-    # 使用 TimerAction 启动后 5 秒执行 ydlidar 节点
-    ydlidar_delay = launch.actions.TimerAction(period=5.0, actions=[ydlidar])
-    
     return launch.LaunchDescription([
+        layout_declare,
+        odom_source_declare,
         urdf2tf,
+        container,
+        load_into_ui,
         odom2tf,
-        microros_agent,
-        ros_serail2wifi,
-        ydlidar_delay
-    ])
\ No newline at end of file
+        ydlidar
+    ])
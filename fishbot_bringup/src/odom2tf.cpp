@@ -3,42 +3,208 @@
 #include <tf2_ros/transform_broadcaster.h>
 #include <geometry_msgs/msg/transform_stamped.hpp>
 #include <nav_msgs/msg/odometry.hpp>
+#include <rclcpp_components/register_node_macro.hpp>
+#include <algorithm>
+#include <chrono>
+#include <vector>
 
+namespace fishbot_bringup {
+
+// 可加载到组件容器中，与雷达驱动等节点同进程运行
+// 里程计频率远高于TF的需要，按发布周期合并后批量广播
 class OdomTopic2TF : public rclcpp::Node {
 public:
-  OdomTopic2TF(std::string name) : Node(name) {
+  explicit OdomTopic2TF(const rclcpp::NodeOptions &options)
+      : Node("odom2tf", options) {
+    // 发布频率，0 表示每条里程计都立即广播
+    publish_rate_ = this->declare_parameter("publish_rate", 50.0);
+    // 是否插值到发布周期的整数倍时刻，TF 时间戳等间隔
+    interpolate_ = this->declare_parameter("interpolate", false);
+    // 统计输出间隔（秒），0 表示不输出
+    double stats_interval = this->declare_parameter("stats_interval", 10.0);
+    if (publish_rate_ <= 0.0) {
+      interpolate_ = false;
+    }
+
     // 创建 odom 话题订阅者，使用传感器数据的 Qos
     odom_subscribe_ = this->create_subscription<nav_msgs::msg::Odometry>(
         "odom", rclcpp::SensorDataQoS(),
         std::bind(&OdomTopic2TF::odom_callback_, this, std::placeholders::_1));
     // 创建一个tf2_ros::TransformBroadcaster用于广播坐标变换
     tf_broadcaster_ = std::make_unique<tf2_ros::TransformBroadcaster>(this);
+
+    if (publish_rate_ > 0.0) {
+      period_ns_ = static_cast<int64_t>(1e9 / publish_rate_);
+      publish_timer_ = this->create_wall_timer(
+          std::chrono::nanoseconds(period_ns_),
+          std::bind(&OdomTopic2TF::publish_, this));
+    }
+    if (stats_interval > 0.0) {
+      stats_timer_ = this->create_wall_timer(
+          std::chrono::duration<double>(stats_interval),
+          std::bind(&OdomTopic2TF::stats_callback_, this));
+    }
+    stats_start_ = this->now();
   }
 
 private:
+  // 每个子坐标系的状态，消息对象在回调之间复用
+  struct FrameState {
+    geometry_msgs::msg::TransformStamped prev; // 上一条里程计
+    geometry_msgs::msg::TransformStamped last; // 最新一条里程计
+    geometry_msgs::msg::TransformStamped out;  // 待广播的变换
+    bool has_last = false;
+    bool updated = false; // 上次广播后 out 是否有更新
+  };
+
   rclcpp::Subscription<nav_msgs::msg::Odometry>::SharedPtr odom_subscribe_;
   std::unique_ptr<tf2_ros::TransformBroadcaster> tf_broadcaster_;
+  rclcpp::TimerBase::SharedPtr publish_timer_;
+  rclcpp::TimerBase::SharedPtr stats_timer_;
+  double publish_rate_ = 0.0;
+  bool interpolate_ = false;
+  int64_t period_ns_ = 0;
+  std::vector<FrameState> frames_; // 通常只有 base_footprint 一个
+  std::vector<geometry_msgs::msg::TransformStamped> transforms_; // 批量广播的缓存
+
+  // 统计，回调与定时器在同一回调组中串行执行，无需加锁
+  uint64_t input_count_ = 0;
+  uint64_t output_count_ = 0;
+  double latency_sum_ms_ = 0.0;
+  double latency_max_ms_ = 0.0;
+  rclcpp::Time stats_start_;
+
+  FrameState &frame_(const std::string &child_frame_id) {
+    for (auto &f : frames_) {
+      if (f.last.child_frame_id == child_frame_id) {
+        return f;
+      }
+    }
+    frames_.emplace_back();
+    return frames_.back();
+  }
+
+  static void fill_transform_(const nav_msgs::msg::Odometry &msg,
+                              geometry_msgs::msg::TransformStamped &transform) {
+    transform.header = msg.header; // 使用消息的时间戳和框架ID
+    transform.child_frame_id = msg.child_frame_id;
+    transform.transform.translation.x = msg.pose.pose.position.x;
+    transform.transform.translation.y = msg.pose.pose.position.y;
+    transform.transform.translation.z = msg.pose.pose.position.z;
+    transform.transform.rotation = msg.pose.pose.orientation;
+  }
+
+  // 在 a、b 两条之间插值到 stamp_ns 时刻，平移线性插值，旋转球面插值
+  static void interpolate_transform_(
+      const geometry_msgs::msg::TransformStamped &a,
+      const geometry_msgs::msg::TransformStamped &b, int64_t stamp_ns,
+      geometry_msgs::msg::TransformStamped &out) {
+    const int64_t ta = rclcpp::Time(a.header.stamp).nanoseconds();
+    const int64_t tb = rclcpp::Time(b.header.stamp).nanoseconds();
+    const double s = static_cast<double>(stamp_ns - ta) / (tb - ta);
+
+    out.header.frame_id = b.header.frame_id;
+    out.header.stamp = rclcpp::Time(stamp_ns, RCL_ROS_TIME);
+    out.child_frame_id = b.child_frame_id;
+    const auto &pa = a.transform.translation;
+    const auto &pb = b.transform.translation;
+    out.transform.translation.x = pa.x + (pb.x - pa.x) * s;
+    out.transform.translation.y = pa.y + (pb.y - pa.y) * s;
+    out.transform.translation.z = pa.z + (pb.z - pa.z) * s;
+    const auto &ra = a.transform.rotation;
+    const auto &rb = b.transform.rotation;
+    tf2::Quaternion qa(ra.x, ra.y, ra.z, ra.w);
+    tf2::Quaternion qb(rb.x, rb.y, rb.z, rb.w);
+    tf2::Quaternion q = qa.slerp(qb, s);
+    out.transform.rotation.x = q.x();
+    out.transform.rotation.y = q.y();
+    out.transform.rotation.z = q.z();
+    out.transform.rotation.w = q.w();
+  }
+
   // 回调函数，处理接收到的odom消息，并发布tf
   void odom_callback_(const nav_msgs::msg::Odometry::SharedPtr msg) {
-    geometry_msgs::msg::TransformStamped transform;
-    transform.header = msg->header; // 使用消息的时间戳和框架ID
-    transform.child_frame_id = msg->child_frame_id;
-    transform.transform.translation.x = msg->pose.pose.position.x;
-    transform.transform.translation.y = msg->pose.pose.position.y;
-    transform.transform.translation.z = msg->pose.pose.position.z;
-    transform.transform.rotation.x = msg->pose.pose.orientation.x;
-    transform.transform.rotation.y = msg->pose.pose.orientation.y;
-    transform.transform.rotation.z = msg->pose.pose.orientation.z;
-    transform.transform.rotation.w = msg->pose.pose.orientation.w;
+    input_count_++;
+    FrameState &f = frame_(msg->child_frame_id);
+
+    if (interpolate_) {
+      // 新样本越过发布周期的整数倍时刻时，插值出该时刻的变换
+      const int64_t t = rclcpp::Time(msg->header.stamp).nanoseconds();
+      const int64_t grid = t - t % period_ns_;
+      if (f.has_last &&
+          grid > rclcpp::Time(f.last.header.stamp).nanoseconds()) {
+        std::swap(f.prev, f.last);
+        fill_transform_(*msg, f.last);
+        interpolate_transform_(f.prev, f.last, grid, f.out);
+        f.updated = true;
+      } else {
+        fill_transform_(*msg, f.last);
+      }
+      f.has_last = true;
+      return;
+    }
+
+    fill_transform_(*msg, f.out);
+    f.last.child_frame_id = msg->child_frame_id;
+    f.has_last = true;
+    f.updated = true;
+
+    if (!publish_timer_) {
+      publish_();
+    }
+  }
+
+  // 合并本周期内各坐标系的最新变换，一次广播
+  void publish_() {
+    size_t n = 0;
+    for (auto &f : frames_) {
+      if (!f.updated) {
+        continue;
+      }
+      if (transforms_.size() <= n) {
+        transforms_.emplace_back();
+      }
+      transforms_[n++] = f.out;
+      f.updated = false;
+    }
+    if (n == 0) {
+      return;
+    }
+    transforms_.resize(n);
+
     // 广播坐标变换信息
-    tf_broadcaster_->sendTransform(transform);
-  };
+    tf_broadcaster_->sendTransform(transforms_);
+
+    const rclcpp::Time now = this->now();
+    for (size_t i = 0; i < n; i++) {
+      double latency =
+          (now - rclcpp::Time(transforms_[i].header.stamp)).seconds() * 1e3;
+      latency_sum_ms_ += latency;
+      latency_max_ms_ = std::max(latency_max_ms_, latency);
+    }
+    output_count_ += n;
+  }
+
+  void stats_callback_() {
+    const rclcpp::Time now = this->now();
+    const double elapsed = (now - stats_start_).seconds();
+    if (elapsed <= 0.0) {
+      return;
+    }
+    RCLCPP_INFO(this->get_logger(),
+                "odom in %.1f Hz, tf out %.1f Hz, latency mean %.2f ms max %.2f ms",
+                input_count_ / elapsed, output_count_ / elapsed,
+                output_count_ ? latency_sum_ms_ / output_count_ : 0.0,
+                latency_max_ms_);
+    input_count_ = 0;
+    output_count_ = 0;
+    latency_sum_ms_ = 0.0;
+    latency_max_ms_ = 0.0;
+    stats_start_ = now;
+  }
 };
 
-int main(int argc, char **argv) {
-  rclcpp::init(argc, argv);
-  auto node = std::make_shared<OdomTopic2TF>("odom2tf");
-  rclcpp::spin(node);
-  rclcpp::shutdown();
-  return 0;
-}
\ No newline at end of file
+} // namespace fishbot_bringup
+
+// 注册组件，单独运行的 odom2tf 可执行文件由 CMake 生成
+RCLCPP_COMPONENTS_REGISTER_NODE(fishbot_bringup::OdomTopic2TF)
@@ -0,0 +1,131 @@
+#include "loop_manager.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+typedef struct {
+    int fd;
+    loop_fd_cb_t cb;
+    void *user_data;
+} LoopFd;
+
+static int epoll_fd = -1;
+static int timer_fd = -1;
+static int event_fd = -1;
+static LoopFd loop_fds[LOOP_MANAGER_MAX_FDS];
+static int loop_fd_count = 0;
+static int wakeup_pending = 0; // 已写eventfd但主循环尚未读取
+
+static int loop_watch(int fd, void *ptr)
+{
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = ptr;
+    return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+int loop_manager_init(void)
+{
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd < 0 || timer_fd < 0 || event_fd < 0) {
+        perror("loop_manager_init");
+        loop_manager_deinit();
+        return -1;
+    }
+    // 定时器和eventfd的data.ptr指向自身的描述符变量，以区分注册的文件描述符
+    if (loop_watch(timer_fd, &timer_fd) < 0 || loop_watch(event_fd, &event_fd) < 0) {
+        perror("loop_manager_init: epoll_ctl");
+        loop_manager_deinit();
+        return -1;
+    }
+    return 0;
+}
+
+void loop_manager_deinit(void)
+{
+    if (epoll_fd >= 0) close(epoll_fd);
+    if (timer_fd >= 0) close(timer_fd);
+    if (event_fd >= 0) close(event_fd);
+    epoll_fd = timer_fd = event_fd = -1;
+    loop_fd_count = 0;
+}
+
+int loop_manager_add_fd(int fd, loop_fd_cb_t cb, void *user_data)
+{
+    if (epoll_fd < 0 || loop_fd_count >= LOOP_MANAGER_MAX_FDS) {
+        return -1;
+    }
+    LoopFd *entry = &loop_fds[loop_fd_count];
+    entry->fd = fd;
+    entry->cb = cb;
+    entry->user_data = user_data;
+    if (loop_watch(fd, entry) < 0) {
+        perror("loop_manager_add_fd");
+        return -1;
+    }
+    loop_fd_count++;
+    return 0;
+}
+
+void loop_manager_wakeup(void)
+{
+    if (event_fd < 0) {
+        return;
+    }
+    // 主循环读取前只写一次，避免频繁的系统调用
+    if (__atomic_exchange_n(&wakeup_pending, 1, __ATOMIC_ACQ_REL)) {
+        return;
+    }
+    uint64_t one = 1;
+    if (write(event_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        __atomic_store_n(&wakeup_pending, 0, __ATOMIC_RELEASE);
+    }
+}
+
+void loop_manager_wait(uint32_t timeout_ms)
+{
+    if (epoll_fd < 0) {
+        usleep((timeout_ms == LOOP_MANAGER_WAIT_FOREVER ? 1 : timeout_ms) * 1000);
+        return;
+    }
+
+    // 超时为0时直接轮询，不必设置定时器
+    int epoll_timeout = 0;
+    if (timeout_ms > 0) {
+        struct itimerspec its;
+        memset(&its, 0, sizeof(its));
+        if (timeout_ms != LOOP_MANAGER_WAIT_FOREVER) {
+            its.it_value.tv_sec = timeout_ms / 1000;
+            its.it_value.tv_nsec = (long)(timeout_ms % 1000) * 1000000L;
+        }
+        // it_value全为0时解除定时器
+        timerfd_settime(timer_fd, 0, &its, NULL);
+        epoll_timeout = -1;
+    }
+
+    struct epoll_event events[LOOP_MANAGER_MAX_FDS + 2];
+    int n = epoll_wait(epoll_fd, events, LOOP_MANAGER_MAX_FDS + 2, epoll_timeout);
+    for (int i = 0; i < n; i++) {
+        uint64_t value;
+        if (events[i].data.ptr == &timer_fd) {
+            while (read(timer_fd, &value, sizeof(value)) > 0) {
+            }
+        } else if (events[i].data.ptr == &event_fd) {
+            // 先清标志再读，读之后的唤醒会重新写入
+            __atomic_store_n(&wakeup_pending, 0, __ATOMIC_RELEASE);
+            while (read(event_fd, &value, sizeof(value)) > 0) {
+            }
+        } else {
+            LoopFd *entry = (LoopFd *)events[i].data.ptr;
+            entry->cb(entry->fd, entry->user_data);
+        }
+    }
+}
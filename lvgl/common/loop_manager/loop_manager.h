@@ -0,0 +1,40 @@
+#ifndef LOOP_MANAGER_H
+#define LOOP_MANAGER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 主循环的事件等待：用epoll同时等待定时器(timerfd)、跨线程唤醒(eventfd)和注册的文件描述符，
+// 没有事件时主线程阻塞，不再按固定间隔usleep轮询
+
+#define LOOP_MANAGER_MAX_FDS 8          // 可注册的文件描述符数量
+#define LOOP_MANAGER_WAIT_FOREVER 0xFFFFFFFF
+
+// 文件描述符可读时在主线程中调用
+typedef void (*loop_fd_cb_t)(int fd, void *user_data);
+
+// 初始化，成功返回0
+int loop_manager_init(void);
+
+// 释放资源，不关闭注册的文件描述符
+void loop_manager_deinit(void);
+
+// 注册文件描述符(需为非阻塞)，可读时调用cb，cb需读空数据，否则会被反复调用
+int loop_manager_add_fd(int fd, loop_fd_cb_t cb, void *user_data);
+
+// 唤醒主循环，任意线程可调用，多次调用会合并为一次唤醒
+void loop_manager_wakeup(void);
+
+// 阻塞直到超时、被唤醒或有文件描述符可读，并调用对应的回调
+// timeout_ms为LOOP_MANAGER_WAIT_FOREVER时一直等待
+void loop_manager_wait(uint32_t timeout_ms);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif // LOOP_MANAGER_H
@@ -0,0 +1,209 @@
+#include "trace_manager.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+
+typedef struct {
+    const char *name;
+    uint64_t ts;                    // ns
+    char ph;
+} TraceEvent;
+
+// 单生产者(所属线程)单消费者(写文件线程)的环形缓存
+typedef struct TraceRing {
+    TraceEvent events[TRACE_MANAGER_RING_SIZE];
+    size_t head;                    // 消费者写
+    size_t tail;                    // 生产者写
+    size_t dropped;
+    int retired;                    // 线程已退出，取空后释放
+    uint32_t tid;
+    struct TraceRing *next;
+} TraceRing;
+
+bool trace_manager_enabled = false;
+
+static int trace_fd = -1;
+static int trace_pid = 0;
+static TraceRing *trace_rings = NULL;
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;     // 保护环形缓存链表
+static pthread_key_t trace_key;
+static pthread_t trace_thread;
+static pthread_mutex_t trace_stop_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t trace_stop_cond = PTHREAD_COND_INITIALIZER;
+static bool trace_stop = false;
+static char trace_out[64 * 1024];
+
+static uint64_t trace_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// 线程退出时标记其缓存，由写文件线程取空后释放
+static void trace_ring_retire(void *arg)
+{
+    TraceRing *ring = (TraceRing *)arg;
+    __atomic_store_n(&ring->retired, 1, __ATOMIC_RELEASE);
+}
+
+static TraceRing *trace_local_ring(void)
+{
+    TraceRing *ring = (TraceRing *)pthread_getspecific(trace_key);
+    if (ring) {
+        return ring;
+    }
+    ring = (TraceRing *)calloc(1, sizeof(TraceRing));
+    if (!ring) {
+        return NULL;
+    }
+    ring->tid = (uint32_t)syscall(SYS_gettid);
+    pthread_mutex_lock(&trace_mutex);
+    ring->next = trace_rings;
+    trace_rings = ring;
+    pthread_mutex_unlock(&trace_mutex);
+    pthread_setspecific(trace_key, ring);
+    return ring;
+}
+
+void trace_manager_record(const char *name, char ph)
+{
+    TraceRing *ring = trace_local_ring();
+    if (!ring) {
+        return;
+    }
+    size_t tail = ring->tail;
+    if (tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) >= TRACE_MANAGER_RING_SIZE) {
+        __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    TraceEvent *e = &ring->events[tail & (TRACE_MANAGER_RING_SIZE - 1)];
+    e->name = name;
+    e->ts = trace_now();
+    e->ph = ph;
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+// 整块一次写入，与其他写入者的追加不会交错
+static void trace_write(size_t *len)
+{
+    if (*len && write(trace_fd, trace_out, *len) < 0) {
+        perror("trace_manager");
+    }
+    *len = 0;
+}
+
+static void trace_drain(TraceRing *ring, size_t *len)
+{
+    size_t head = ring->head;
+    size_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    for (; head != tail; head++) {
+        const TraceEvent *e = &ring->events[head & (TRACE_MANAGER_RING_SIZE - 1)];
+        if (sizeof(trace_out) - *len < 256) {
+            trace_write(len);
+        }
+        int n = snprintf(trace_out + *len, 256,
+                         "{\"name\":\"%s\",\"ph\":\"%c\",%s\"ts\":%llu.%03u,\"pid\":%d,\"tid\":%u},\n",
+                         e->name, e->ph, e->ph == 'i' ? "\"s\":\"t\"," : "",
+                         (unsigned long long)(e->ts / 1000), (unsigned)(e->ts % 1000), trace_pid, ring->tid);
+        if (n > 0 && n < 256) {
+            *len += n;
+        }
+    }
+    __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+
+    size_t dropped = __atomic_exchange_n(&ring->dropped, 0, __ATOMIC_RELAXED);
+    if (dropped) {
+        fprintf(stderr, "trace_manager: dropped %zu events on thread %u\n", dropped, ring->tid);
+    }
+}
+
+static void trace_flush(void)
+{
+    size_t len = 0;
+    pthread_mutex_lock(&trace_mutex);
+    TraceRing **link = &trace_rings;
+    while (*link) {
+        TraceRing *ring = *link;
+        trace_drain(ring, &len);
+        if (__atomic_load_n(&ring->retired, __ATOMIC_ACQUIRE) &&
+            ring->head == __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE)) {
+            *link = ring->next;
+            free(ring);
+            continue;
+        }
+        link = &ring->next;
+    }
+    trace_write(&len);
+    pthread_mutex_unlock(&trace_mutex);
+}
+
+static void *trace_thread_func(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&trace_stop_mutex);
+    while (!trace_stop) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_sec += 1;
+        pthread_cond_timedwait(&trace_stop_cond, &trace_stop_mutex, &ts);
+        pthread_mutex_unlock(&trace_stop_mutex);
+        trace_flush();
+        pthread_mutex_lock(&trace_stop_mutex);
+    }
+    pthread_mutex_unlock(&trace_stop_mutex);
+    return NULL;
+}
+
+void trace_manager_init(void)
+{
+    const char *path = getenv(TRACE_MANAGER_FILE_ENV);
+    if (trace_manager_enabled || !path || !*path) {
+        return;
+    }
+    // 首个打开文件的写入者写数组开头，之后都只追加，结尾的]可省略
+    trace_fd = open(path, O_WRONLY | O_CREAT | O_EXCL | O_APPEND | O_CLOEXEC, 0644);
+    if (trace_fd >= 0) {
+        if (write(trace_fd, "[\n", 2) < 0) {
+            perror("trace_manager");
+        }
+    } else if (errno == EEXIST) {
+        trace_fd = open(path, O_WRONLY | O_APPEND | O_CLOEXEC);
+    }
+    if (trace_fd < 0) {
+        fprintf(stderr, "trace_manager: failed to open %s\n", path);
+        return;
+    }
+    trace_pid = getpid();
+    pthread_key_create(&trace_key, trace_ring_retire);
+    trace_stop = false;
+    if (pthread_create(&trace_thread, NULL, trace_thread_func, NULL) != 0) {
+        close(trace_fd);
+        trace_fd = -1;
+        return;
+    }
+    trace_manager_enabled = true;
+}
+
+void trace_manager_deinit(void)
+{
+    if (!trace_manager_enabled) {
+        return;
+    }
+    trace_manager_enabled = false;
+    pthread_mutex_lock(&trace_stop_mutex);
+    trace_stop = true;
+    pthread_cond_signal(&trace_stop_cond);
+    pthread_mutex_unlock(&trace_stop_mutex);
+    pthread_join(trace_thread, NULL);
+    trace_flush();
+    close(trace_fd);
+    trace_fd = -1;
+}
@@ -0,0 +1,44 @@
+#ifndef TRACE_MANAGER_H
+#define TRACE_MANAGER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+
+// 耗时追踪，输出Chrome/Perfetto的trace JSON。
+// 环境变量PIPELINE_TRACE_FILE指定输出文件，未设置时不记录。
+// 与雷达SDK的追踪格式相同、都只追加写入同一个文件，时间戳都是CLOCK_MONOTONIC，
+// 在Perfetto中打开即可在一条时间线上看到雷达、ROS和界面。
+// LVGL的LV_PROFILER_BEGIN/END也记录到这里(见lv_conf.h)。
+
+#define TRACE_MANAGER_FILE_ENV "PIPELINE_TRACE_FILE"
+#define TRACE_MANAGER_RING_SIZE 8192    // 每个线程两次写文件之间可缓存的事件数，必须为2的幂
+
+extern bool trace_manager_enabled;
+
+// 读取环境变量并启动写文件线程，需在其他线程开始记录前调用
+void trace_manager_init(void);
+
+// 写出剩余事件并关闭文件
+void trace_manager_deinit(void);
+
+// 记录一个事件，ph为'B'开始、'E'结束、'i'瞬时；name需为字符串常量
+void trace_manager_record(const char *name, char ph);
+
+static inline void trace_manager_begin(const char *name)
+{
+    if (trace_manager_enabled) trace_manager_record(name, 'B');
+}
+
+static inline void trace_manager_end(const char *name)
+{
+    if (trace_manager_enabled) trace_manager_record(name, 'E');
+}
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif // TRACE_MANAGER_H
@@ -0,0 +1,137 @@
+#include "ros_bridge.h"
+#include "../../../common/loop_manager/loop_manager.h"
+#include "../../../common/trace_manager/trace_manager.h"
+#include <stdint.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+///////////////////// MAILBOX ////////////////////
+
+// 有界多生产者单消费者无锁队列，每个槽位用序号区分空/满 (Vyukov)
+class UiMailbox
+{
+    public:
+        UiMailbox()
+        : enqueue_pos_(0), dequeue_pos_(0)
+        {
+            for(size_t i = 0; i < ROS_BRIDGE_MAILBOX_SIZE; i++)
+            {
+                cells_[i].seq.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        bool post(std::function<void()> && task)
+        {
+            Cell * cell;
+            size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+            for(;;)
+            {
+                cell = &cells_[pos & (ROS_BRIDGE_MAILBOX_SIZE - 1)];
+                size_t seq = cell->seq.load(std::memory_order_acquire);
+                intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+                if(dif == 0)
+                {
+                    if(enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if(dif < 0)
+                {
+                    return false; // 满
+                }
+                else
+                {
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+            cell->task = std::move(task);
+            cell->seq.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 只由UI线程调用；最多执行一轮容量的任务，任务中再投递的留到下一帧
+        void drain()
+        {
+            for(size_t n = 0; n < ROS_BRIDGE_MAILBOX_SIZE; n++)
+            {
+                Cell & cell = cells_[dequeue_pos_ & (ROS_BRIDGE_MAILBOX_SIZE - 1)];
+                size_t seq = cell.seq.load(std::memory_order_acquire);
+                if((intptr_t)seq - (intptr_t)(dequeue_pos_ + 1) < 0)
+                {
+                    return; // 空
+                }
+                std::function<void()> task = std::move(cell.task);
+                cell.task = nullptr;
+                cell.seq.store(dequeue_pos_ + ROS_BRIDGE_MAILBOX_SIZE, std::memory_order_release);
+                dequeue_pos_++;
+                task();
+            }
+        }
+
+    private:
+        static_assert((ROS_BRIDGE_MAILBOX_SIZE & (ROS_BRIDGE_MAILBOX_SIZE - 1)) == 0, "mailbox size must be a power of two");
+
+        struct Cell {
+            std::atomic<size_t> seq;
+            std::function<void()> task;
+        };
+
+        Cell cells_[ROS_BRIDGE_MAILBOX_SIZE];
+        alignas(64) std::atomic<size_t> enqueue_pos_;
+        alignas(64) size_t dequeue_pos_;
+};
+
+///////////////////// VARIABLES ////////////////////
+
+static UiMailbox g_mailbox;
+static std::thread g_spin_thread;
+static std::atomic<bool> g_spin_stop(false);
+
+///////////////////// FUNCTIONS ////////////////////
+
+void ros_bridge_start(const std::shared_ptr<rclcpp::Executor> & executor)
+{
+    if(g_spin_thread.joinable())
+    {
+        return;
+    }
+    g_spin_stop.store(false);
+    g_spin_thread = std::thread([executor]()
+    {
+        // 不用spin()+cancel()：cancel()若早于spin()开始会丢失，线程无法退出
+        while(rclcpp::ok() && !g_spin_stop.load())
+        {
+            executor->spin_once(std::chrono::milliseconds(100));
+        }
+    });
+}
+
+void ros_bridge_stop(void)
+{
+    if(!g_spin_thread.joinable())
+    {
+        return;
+    }
+    g_spin_stop.store(true);
+    g_spin_thread.join();
+}
+
+bool ros_bridge_post(std::function<void()> task)
+{
+    if(!g_mailbox.post(std::move(task)))
+    {
+        return false;
+    }
+    // UI线程可能阻塞在epoll中
+    loop_manager_wakeup();
+    return true;
+}
+
+void ros_bridge_drain(void)
+{
+    trace_manager_begin("ros_bridge_drain");
+    g_mailbox.drain();
+    trace_manager_end("ros_bridge_drain");
+}
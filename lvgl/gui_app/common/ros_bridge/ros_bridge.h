@@ -0,0 +1,106 @@
+#ifndef ROS_BRIDGE_H
+#define ROS_BRIDGE_H
+
+// ROS执行器在独立线程中运行，不再与lv_timer_handler()轮流占用UI线程。
+// ROS线程的结果通过无锁邮箱交给UI线程，UI线程每帧取一次，LVGL对象只在UI线程访问。
+
+#include "rclcpp/rclcpp.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+
+#define ROS_BRIDGE_MAILBOX_SIZE 256 // 邮箱容量，必须为2的幂
+
+// 在独立线程中spin执行器，只能启动一个
+void ros_bridge_start(const std::shared_ptr<rclcpp::Executor> & executor);
+
+// 停止执行器并等待线程退出
+void ros_bridge_stop(void);
+
+// 投递一个在UI线程执行的任务，任意线程可调用
+// 邮箱满时返回false，任务被丢弃
+bool ros_bridge_post(std::function<void()> task);
+
+// UI线程每帧调用一次，执行已投递的任务
+void ros_bridge_drain(void);
+
+// 回调在UI线程执行的订阅，由ros_bridge_subscribe()创建。
+// UI来不及处理时只保留最新一条消息，中间的消息被丢弃，消息再多邮箱里也最多只有一个任务。
+// 释放最后一个SharedPtr后取消订阅，已投递但未执行的回调不再调用。
+template<typename MsgT>
+class UiSubscription : public std::enable_shared_from_this<UiSubscription<MsgT>>
+{
+    public:
+        using SharedPtr = std::shared_ptr<UiSubscription<MsgT>>;
+        using Callback = std::function<void(std::shared_ptr<const MsgT>)>;
+
+        explicit UiSubscription(Callback callback)
+        : callback_(std::move(callback)), pending_(false)
+        {
+        }
+
+        static SharedPtr create(rclcpp::Node & node, const std::string & topic, const rclcpp::QoS & qos, Callback callback)
+        {
+            SharedPtr self = std::make_shared<UiSubscription<MsgT>>(std::move(callback));
+            std::weak_ptr<UiSubscription<MsgT>> weak = self;
+            self->sub_ = node.create_subscription<MsgT>(topic, qos,
+                [weak](std::shared_ptr<const MsgT> msg)
+                {
+                    if(auto s = weak.lock())
+                    {
+                        s->on_message(std::move(msg));
+                    }
+                });
+            return self;
+        }
+
+    private:
+        // ROS线程
+        void on_message(std::shared_ptr<const MsgT> msg)
+        {
+            std::atomic_store(&latest_, std::move(msg));
+            if(pending_.exchange(true))
+            {
+                return; // 已有任务在邮箱中，届时取最新的一条
+            }
+            std::weak_ptr<UiSubscription<MsgT>> weak = this->weak_from_this();
+            if(!ros_bridge_post([weak]
+                {
+                    if(auto s = weak.lock())
+                    {
+                        s->deliver();
+                    }
+                }))
+            {
+                pending_.store(false);
+            }
+        }
+
+        // UI线程
+        void deliver()
+        {
+            // 先清标志再取消息，之后到达的消息会重新投递
+            pending_.store(false);
+            std::shared_ptr<const MsgT> msg = std::atomic_exchange(&latest_, std::shared_ptr<const MsgT>());
+            if(msg)
+            {
+                callback_(msg);
+            }
+        }
+
+        Callback callback_;
+        typename rclcpp::Subscription<MsgT>::SharedPtr sub_;
+        std::shared_ptr<const MsgT> latest_;
+        std::atomic<bool> pending_;
+};
+
+// 订阅话题，回调在UI线程执行，可直接操作LVGL对象
+template<typename MsgT>
+typename UiSubscription<MsgT>::SharedPtr ros_bridge_subscribe(rclcpp::Node & node, const std::string & topic, const rclcpp::QoS & qos,
+                                                              typename UiSubscription<MsgT>::Callback callback)
+{
+    return UiSubscription<MsgT>::create(node, topic, qos, std::move(callback));
+}
+
+#endif
@@ -0,0 +1,431 @@
+#include "ui_LidarPage.h"
+#include "../../common/ros_bridge/ros_bridge.h"
+#include "../../../common/trace_manager/trace_manager.h"
+#include "rclcpp/rclcpp.hpp"
+#include "sensor_msgs/msg/laser_scan.hpp"
+#include "nav_msgs/msg/odometry.hpp"
+#include <math.h>
+#include <string.h>
+#include <mutex>
+#include <vector>
+
+///////////////////// VARIABLES ////////////////////
+
+#define LIDAR_CANVAS_SIZE   UI_SCREEN_WIDTH  // 画布为正方形，雷达位于中心
+#define LIDAR_TILE_SIZE     32               // 统计脏区域的分块大小
+#define LIDAR_TILES         (LIDAR_CANVAS_SIZE / LIDAR_TILE_SIZE)
+#define LIDAR_MAX_INV_AREAS 16               // 每帧提交的刷新区域上限，超过LV_INV_BUF_SIZE时LVGL会整屏刷新
+#define LIDAR_FRAME_PERIOD  33               // 刷新周期(ms)，30fps
+#define LIDAR_BG_COLOR      0x000000
+#define LIDAR_POINT_COLOR   0x00FF40
+
+// 画布缓冲区，RGB565
+static uint16_t lidar_canvas_buf[LIDAR_CANVAS_SIZE * LIDAR_CANVAS_SIZE];
+static lv_obj_t * lidar_canvas;
+static lv_obj_t * lidar_info_label;
+static lv_obj_t * lidar_pose_label;
+static lv_timer_t * lidar_timer;
+
+// 显示量程(m)，点击缩放按钮循环切换
+static const float lidar_ranges[] = {2.0f, 4.0f, 8.0f, 16.0f};
+static int lidar_range_index = 1;
+static bool lidar_redraw = false;
+
+// 上一帧和本帧画出的点在画布中的偏移，下一帧按偏移擦除，不清整个画布
+static std::vector<uint32_t> lidar_prev_offsets;
+static std::vector<uint32_t> lidar_cur_offsets;
+static uint8_t lidar_dirty[LIDAR_TILES][LIDAR_TILES];
+
+// 扫描角度的正余弦表，角度参数不变时复用
+static std::vector<float> lidar_cos;
+static std::vector<float> lidar_sin;
+static float lidar_lut_min = 0.0f;
+static float lidar_lut_inc = 0.0f;
+
+static sensor_msgs::msg::LaserScan::UniquePtr lidar_last_scan;
+
+///////////////////// ROS ////////////////////
+
+// ROS线程和UI线程之间交接的一圈数据
+struct LidarScanSlot
+{
+    std::mutex lock;
+    sensor_msgs::msg::LaserScan::UniquePtr scan;
+};
+
+// 扫描回调只交接消息，转换和绘制在LVGL定时器中按帧率进行
+class LidarViewNode : public rclcpp::Node
+{
+    public:
+        LidarViewNode()
+        : Node("lvgl_lidar_view", rclcpp::NodeOptions().use_intra_process_comms(true)),
+          slot_(std::make_shared<LidarScanSlot>())
+        {
+            // 同进程发布时消息以unique_ptr直接移交，不拷贝。
+            // 回调在ROS线程执行，UI线程可能同时释放本节点，回调不能访问this，
+            // 只通过weak_ptr访问交接槽，执行期间交接槽不会被释放
+            std::weak_ptr<LidarScanSlot> weak = slot_;
+            scan_sub_ = this->create_subscription<sensor_msgs::msg::LaserScan>(
+                "/scan", rclcpp::SensorDataQoS(),
+                [weak](sensor_msgs::msg::LaserScan::UniquePtr msg)
+                {
+                    if(auto slot = weak.lock())
+                    {
+                        std::lock_guard<std::mutex> lock(slot->lock);
+                        slot->scan = std::move(msg); // 未及绘制的旧一圈直接丢弃
+                    }
+                });
+        }
+
+        // 是否订阅里程计显示机器人位姿
+        void enable_pose(bool enable)
+        {
+            if(!enable)
+            {
+                odom_sub_.reset();
+                return;
+            }
+            if(odom_sub_)
+            {
+                return;
+            }
+            // 回调在UI线程执行，直接更新标签
+            odom_sub_ = ros_bridge_subscribe<nav_msgs::msg::Odometry>(*this, "/odom", rclcpp::SensorDataQoS(),
+                [](std::shared_ptr<const nav_msgs::msg::Odometry> msg)
+                {
+                    const auto & q = msg->pose.pose.orientation;
+                    double yaw = atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.y * q.y + q.z * q.z));
+                    lv_label_set_text_fmt(lidar_pose_label, "x %.2f  y %.2f  yaw %.1f",
+                                          msg->pose.pose.position.x, msg->pose.pose.position.y, yaw * 180.0 / M_PI);
+                });
+        }
+
+        bool pose_enabled() const
+        {
+            return odom_sub_ != nullptr;
+        }
+
+        sensor_msgs::msg::LaserScan::UniquePtr take_scan()
+        {
+            std::lock_guard<std::mutex> lock(slot_->lock);
+            return std::move(slot_->scan);
+        }
+
+    private:
+        rclcpp::Subscription<sensor_msgs::msg::LaserScan>::SharedPtr scan_sub_;
+        UiSubscription<nav_msgs::msg::Odometry>::SharedPtr odom_sub_;
+        std::shared_ptr<LidarScanSlot> slot_;
+};
+
+static std::shared_ptr<LidarViewNode> g_lidar_view_node;
+static rclcpp::executors::SingleThreadedExecutor * g_lidar_executor = nullptr;
+
+///////////////////// FUNCTIONS ////////////////////
+
+// RGB565点绘制内核：每个点为2x2像素，偏移为左上角像素
+static inline void lidar_blit_points(uint16_t * buf, const uint32_t * offsets, size_t n, uint16_t color)
+{
+    for(size_t i = 0; i < n; i++)
+    {
+        uint16_t * p = buf + offsets[i];
+        p[0] = color;
+        p[1] = color;
+        p[LIDAR_CANVAS_SIZE] = color;
+        p[LIDAR_CANVAS_SIZE + 1] = color;
+    }
+}
+
+static void lidar_mark_dirty(const std::vector<uint32_t> & offsets)
+{
+    for(size_t i = 0; i < offsets.size(); i++)
+    {
+        uint32_t x = offsets[i] % LIDAR_CANVAS_SIZE;
+        uint32_t y = offsets[i] / LIDAR_CANVAS_SIZE;
+        lidar_dirty[y / LIDAR_TILE_SIZE][x / LIDAR_TILE_SIZE] = 1;
+        // 2x2的点可能跨到右侧或下方的分块
+        lidar_dirty[(y + 1) / LIDAR_TILE_SIZE][(x + 1) / LIDAR_TILE_SIZE] = 1;
+        lidar_dirty[y / LIDAR_TILE_SIZE][(x + 1) / LIDAR_TILE_SIZE] = 1;
+        lidar_dirty[(y + 1) / LIDAR_TILE_SIZE][x / LIDAR_TILE_SIZE] = 1;
+    }
+}
+
+// 将脏分块合并为区域提交刷新：每行相邻的脏分块合并为一段，
+// 段数超过上限时每行只提交一段
+static void lidar_invalidate_dirty(void)
+{
+    lv_area_t coords;
+    lv_obj_get_coords(lidar_canvas, &coords);
+
+    lv_area_t areas[LIDAR_TILES * (LIDAR_TILES + 1) / 2];
+    int count = 0;
+    for(int ty = 0; ty < LIDAR_TILES; ty++)
+    {
+        int tx = 0;
+        while(tx < LIDAR_TILES)
+        {
+            if(!lidar_dirty[ty][tx])
+            {
+                tx++;
+                continue;
+            }
+            int start = tx;
+            while(tx < LIDAR_TILES && lidar_dirty[ty][tx])
+            {
+                tx++;
+            }
+            lv_area_set(&areas[count++], start * LIDAR_TILE_SIZE, ty * LIDAR_TILE_SIZE,
+                        tx * LIDAR_TILE_SIZE - 1, (ty + 1) * LIDAR_TILE_SIZE - 1);
+        }
+    }
+
+    if(count > LIDAR_MAX_INV_AREAS)
+    {
+        // 合并为每行一段
+        int merged = 0;
+        for(int i = 0; i < count; i++)
+        {
+            if(merged > 0 && areas[merged - 1].y1 == areas[i].y1)
+            {
+                areas[merged - 1].x2 = areas[i].x2;
+            }
+            else
+            {
+                areas[merged++] = areas[i];
+            }
+        }
+        count = merged;
+    }
+
+    for(int i = 0; i < count; i++)
+    {
+        lv_area_move(&areas[i], coords.x1, coords.y1);
+        lv_obj_invalidate_area(lidar_canvas, &areas[i]);
+    }
+}
+
+static void lidar_update_lut(const sensor_msgs::msg::LaserScan & scan)
+{
+    const size_t n = scan.ranges.size();
+    if(lidar_cos.size() == n && lidar_lut_min == scan.angle_min && lidar_lut_inc == scan.angle_increment)
+    {
+        return;
+    }
+    lidar_cos.resize(n);
+    lidar_sin.resize(n);
+    for(size_t i = 0; i < n; i++)
+    {
+        float a = scan.angle_min + i * scan.angle_increment;
+        lidar_cos[i] = cosf(a);
+        lidar_sin[i] = sinf(a);
+    }
+    lidar_lut_min = scan.angle_min;
+    lidar_lut_inc = scan.angle_increment;
+}
+
+// 极坐标转画布像素偏移，雷达前方朝上
+static void lidar_project(const sensor_msgs::msg::LaserScan & scan, std::vector<uint32_t> & offsets)
+{
+    lidar_update_lut(scan);
+    offsets.clear();
+
+    const float center = LIDAR_CANVAS_SIZE / 2;
+    const float scale = (LIDAR_CANVAS_SIZE / 2 - 2) / lidar_ranges[lidar_range_index];
+    const float * ranges = scan.ranges.data();
+    for(size_t i = 0; i < scan.ranges.size(); i++)
+    {
+        float r = ranges[i];
+        // NaN和inf也在这里过滤
+        if(!(r >= scan.range_min && r <= scan.range_max))
+        {
+            continue;
+        }
+        int px = (int)lrintf(center - r * lidar_sin[i] * scale);
+        int py = (int)lrintf(center - r * lidar_cos[i] * scale);
+        if(px < 0 || py < 0 || px >= LIDAR_CANVAS_SIZE - 1 || py >= LIDAR_CANVAS_SIZE - 1)
+        {
+            continue;
+        }
+        offsets.push_back((uint32_t)py * LIDAR_CANVAS_SIZE + px);
+    }
+}
+
+static void lidar_render(const sensor_msgs::msg::LaserScan & scan)
+{
+    trace_manager_begin("lidar_render");
+    memset(lidar_dirty, 0, sizeof(lidar_dirty));
+
+    // 擦除上一帧的点
+    lidar_blit_points(lidar_canvas_buf, lidar_prev_offsets.data(), lidar_prev_offsets.size(),
+                      lv_color_to_u16(lv_color_hex(LIDAR_BG_COLOR)));
+    lidar_mark_dirty(lidar_prev_offsets);
+
+    // 绘制本帧
+    lidar_project(scan, lidar_cur_offsets);
+    lidar_blit_points(lidar_canvas_buf, lidar_cur_offsets.data(), lidar_cur_offsets.size(),
+                      lv_color_to_u16(lv_color_hex(LIDAR_POINT_COLOR)));
+    lidar_mark_dirty(lidar_cur_offsets);
+
+    lidar_invalidate_dirty();
+    // 交换后两个数组的容量都保留，不再分配
+    lidar_prev_offsets.swap(lidar_cur_offsets);
+
+    lv_label_set_text_fmt(lidar_info_label, "%d m  %u pts", (int)lidar_ranges[lidar_range_index],
+                          (unsigned)lidar_prev_offsets.size());
+    trace_manager_end("lidar_render");
+}
+
+static void lidar_timer_cb(lv_timer_t * t)
+{
+    LV_UNUSED(t);
+    if(!g_lidar_view_node)
+    {
+        return;
+    }
+
+    sensor_msgs::msg::LaserScan::UniquePtr scan = g_lidar_view_node->take_scan();
+    if(scan)
+    {
+        lidar_last_scan = std::move(scan);
+    }
+    else if(!lidar_redraw || !lidar_last_scan)
+    {
+        // 没有新的一圈，不绘制
+        return;
+    }
+    lidar_redraw = false;
+    lidar_render(*lidar_last_scan);
+}
+
+static void ui_event_back_btn(lv_event_t * e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+    if(code == LV_EVENT_CLICKED)
+    {
+        lv_lib_pm_OpenPrePage(&page_manager);
+    }
+}
+
+static void ui_event_zoom_btn(lv_event_t * e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+    if(code == LV_EVENT_CLICKED)
+    {
+        lidar_range_index = (lidar_range_index + 1) % (int)(sizeof(lidar_ranges) / sizeof(lidar_ranges[0]));
+        // 按新的比例重画最后一圈
+        lidar_redraw = true;
+    }
+}
+
+static void ui_event_pose_btn(lv_event_t * e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+    if(code == LV_EVENT_CLICKED && g_lidar_view_node)
+    {
+        bool enable = !g_lidar_view_node->pose_enabled();
+        g_lidar_view_node->enable_pose(enable);
+        lv_label_set_text(lidar_pose_label, enable ? "waiting for /odom" : "");
+    }
+}
+
+static lv_obj_t * ui_create_top_button(lv_obj_t * parent, const char * text, lv_align_t align, int x, lv_event_cb_t cb)
+{
+    lv_obj_t * btn = lv_btn_create(parent);
+    lv_obj_align(btn, align, x, 10);
+    lv_obj_set_size(btn, 75, 40);
+    lv_obj_t * label = lv_label_create(btn);
+    lv_label_set_text(label, text);
+    lv_obj_align(label, LV_ALIGN_CENTER, 0, 0);
+    lv_obj_set_style_text_font(label, &lv_font_montserrat_20, 0);
+    lv_obj_add_event_cb(btn, cb, LV_EVENT_ALL, NULL);
+    return btn;
+}
+
+///////////////////// SCREEN init ////////////////////
+
+void ui_LidarPage_init(void *arg)
+{
+    g_lidar_executor = (rclcpp::executors::SingleThreadedExecutor *)arg;
+    lv_obj_t * LidarPage = lv_obj_create(NULL);
+    lv_obj_remove_flag(LidarPage, LV_OBJ_FLAG_SCROLLABLE);
+
+    if(!g_lidar_view_node)
+    {
+        g_lidar_view_node = std::make_shared<LidarViewNode>();
+        if(g_lidar_executor)
+        {
+            g_lidar_executor->add_node(g_lidar_view_node);
+        }
+    }
+
+    // 画布只在打开页面时整体填充一次，之后只改写点所在的像素
+    lidar_canvas = lv_canvas_create(LidarPage);
+    lv_canvas_set_buffer(lidar_canvas, lidar_canvas_buf, LIDAR_CANVAS_SIZE, LIDAR_CANVAS_SIZE, LV_COLOR_FORMAT_RGB565);
+    lv_obj_align(lidar_canvas, LV_ALIGN_CENTER, 0, 20);
+    lv_canvas_fill_bg(lidar_canvas, lv_color_hex(LIDAR_BG_COLOR), LV_OPA_COVER);
+    lidar_prev_offsets.clear();
+    lidar_redraw = true;
+
+    // 雷达位置标记，放在画布之上，不会被擦点覆盖
+    lv_obj_t * robot = lv_obj_create(LidarPage);
+    lv_obj_set_size(robot, 10, 10);
+    lv_obj_set_style_radius(robot, LV_RADIUS_CIRCLE, 0);
+    lv_obj_set_style_bg_color(robot, lv_palette_main(LV_PALETTE_RED), 0);
+    lv_obj_set_style_border_width(robot, 0, 0);
+    lv_obj_align_to(robot, lidar_canvas, LV_ALIGN_CENTER, 0, 0);
+
+    ui_create_top_button(LidarPage, "Back", LV_ALIGN_TOP_LEFT, 5, ui_event_back_btn);
+    ui_create_top_button(LidarPage, "Zoom", LV_ALIGN_TOP_MID, -40, ui_event_zoom_btn);
+    ui_create_top_button(LidarPage, "Pose", LV_ALIGN_TOP_MID, 40, ui_event_pose_btn);
+
+    lidar_info_label = lv_label_create(LidarPage);
+    lv_obj_align(lidar_info_label, LV_ALIGN_TOP_RIGHT, -10, 20);
+    lv_obj_set_style_text_font(lidar_info_label, &lv_font_montserrat_20, 0);
+    lv_label_set_text(lidar_info_label, "waiting for /scan");
+
+    lidar_pose_label = lv_label_create(LidarPage);
+    lv_obj_align_to(lidar_pose_label, lidar_canvas, LV_ALIGN_OUT_BOTTOM_MID, 0, 10);
+    lv_obj_set_style_text_font(lidar_pose_label, &lv_font_montserrat_20, 0);
+    lv_label_set_text(lidar_pose_label, g_lidar_view_node->pose_enabled() ? "waiting for /odom" : "");
+
+    lidar_timer = lv_timer_create(lidar_timer_cb, LIDAR_FRAME_PERIOD, NULL);
+
+    // load page
+    lv_scr_load_anim(LidarPage, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 100, 0, true);
+}
+
+/////////////////// SCREEN deinit ////////////////////
+
+void ui_LidarPage_deinit()
+{
+    // deinit
+    if(lidar_timer)
+    {
+        lv_timer_delete(lidar_timer);
+        lidar_timer = NULL;
+    }
+    if(g_lidar_view_node && g_lidar_executor)
+    {
+        g_lidar_executor->remove_node(g_lidar_view_node);
+    }
+    g_lidar_view_node.reset();
+    lidar_last_scan.reset();
+}
+
+
+void ui_lidar_button(lv_obj_t * ui_HomeScreen, lv_obj_t * ui_AppIconContainer, int x, int y, void (*button_cb)(lv_event_t *)){
+    lv_obj_t * ui_LidarBtn = lv_button_create(ui_AppIconContainer);
+    lv_obj_set_width(ui_LidarBtn, 70);
+    lv_obj_set_height(ui_LidarBtn, 70);
+    lv_obj_set_x(ui_LidarBtn, x);
+    lv_obj_set_y(ui_LidarBtn, y);
+    lv_obj_add_flag(ui_LidarBtn, LV_OBJ_FLAG_SCROLL_ON_FOCUS);
+    lv_obj_remove_flag(ui_LidarBtn, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_style_radius(ui_LidarBtn, 15, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_color(ui_LidarBtn, lv_color_hex(0x2E7D32), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(ui_LidarBtn, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_t * ui_LidarBtnLabel = lv_label_create(ui_LidarBtn);
+    lv_label_set_text(ui_LidarBtnLabel, "Lidar");
+    lv_obj_set_style_text_font(ui_LidarBtnLabel, &lv_font_montserrat_20, 0);
+    lv_obj_center(ui_LidarBtnLabel);
+    lv_obj_add_event_cb(ui_LidarBtn, button_cb, LV_EVENT_CLICKED, (void *)"LidarPage");
+}
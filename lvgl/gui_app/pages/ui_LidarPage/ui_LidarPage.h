@@ -0,0 +1,18 @@
+#ifndef _UI_LIDARPAGE_H
+#define _UI_LIDARPAGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../ui.h"
+
+void ui_LidarPage_init(void *arg);
+void ui_LidarPage_deinit(void);
+void ui_lidar_button(lv_obj_t * ui_HomeScreen, lv_obj_t * ui_AppIconContainer, int x, int y, void (*button_cb)(lv_event_t *));
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif
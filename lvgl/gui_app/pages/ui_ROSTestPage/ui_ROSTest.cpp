@@ -25,7 +25,7 @@ class PublisherNode : public rclcpp::Node
 {
     public:
         PublisherNode()
-        : Node("topic_helloworld_pub") // ROS2节点父类初始化
+        : Node("topic_helloworld_pub", rclcpp::NodeOptions().use_intra_process_comms(true)) // ROS2节点父类初始化，启用进程内通信
         {
             // 创建发布者对象（消息类型、话题名、队列长度）
             publisher_ = this->create_publisher<geometry_msgs::msg::Twist>("/turtle1/cmd_vel", 10);
@@ -33,14 +33,15 @@ class PublisherNode : public rclcpp::Node
 
         void publish_twist(float linear_x, float angular_z)
         {
-            geometry_msgs::msg::Twist msg;
-            msg.linear.x = linear_x;
-            msg.linear.y = 0.0f;
-            msg.linear.z = 0.0f;
-            msg.angular.x = 0.0f;
-            msg.angular.y = 0.0f;
-            msg.angular.z = angular_z;
-            publisher_->publish(msg);
+            // 以unique_ptr发布，同进程的订阅者直接接收，不拷贝
+            auto msg = std::make_unique<geometry_msgs::msg::Twist>();
+            msg->linear.x = linear_x;
+            msg->linear.y = 0.0f;
+            msg->linear.z = 0.0f;
+            msg->angular.x = 0.0f;
+            msg->angular.y = 0.0f;
+            msg->angular.z = angular_z;
+            publisher_->publish(std::move(msg));
         }
 
     private:
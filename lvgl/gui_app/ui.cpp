@@ -13,6 +13,7 @@
 #include "./pages/ui_CalculatorPage/ui_CalculatorPage.h"
 #include "./pages/ui_TimerPage/ui_TimerPage.h"
 #include "./pages/ui_snake_ai/ui_snake_ai.h"
+#include "./pages/ui_LidarPage/ui_LidarPage.h"
 
 #include "rclcpp/rclcpp.hpp"
 #include <string>
@@ -130,6 +131,14 @@ ui_app_data_t ui_apps[] =
         .arg = (void *)&g_executor
 
     },
+    {
+        .name = "LidarPage",
+        .init = ui_LidarPage_init,
+        .deinit = ui_LidarPage_deinit,
+        .page_obj = NULL,
+        .button_init = ui_lidar_button,
+        .arg = (void *)&g_executor
+    },
     {
         .name = "TimerPage",
         .init = ui_TimerPage_init,
@@ -331,7 +340,8 @@ void ui_init(void)
     lv_lib_pm_page_t *pm_page[_APP_NUMS];
     for(int i = 0; i < _APP_NUMS; i++)
     {
-        if(ui_apps[i].name && strcmp(ui_apps[i].name, "ROSTestPage") == 0)
+        if(ui_apps[i].name && (strcmp(ui_apps[i].name, "ROSTestPage") == 0 ||
+                                strcmp(ui_apps[i].name, "LidarPage") == 0))
         {
             ui_apps[i].arg = (void *)g_executor;
         }
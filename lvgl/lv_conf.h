@@ -890,29 +890,30 @@
 #endif /*LV_USE_SYSMON*/
 
 /*1: Enable the runtime performance profiler*/
-#define LV_USE_PROFILER 0
+/*记录到common/trace_manager，与雷达SDK写同一个trace文件；未设置PIPELINE_TRACE_FILE时只有一次判断*/
+#define LV_USE_PROFILER 1
 #if LV_USE_PROFILER
     /*1: Enable the built-in profiler*/
-    #define LV_USE_PROFILER_BUILTIN 1
+    #define LV_USE_PROFILER_BUILTIN 0
     #if LV_USE_PROFILER_BUILTIN
         /*Default profiler trace buffer size*/
         #define LV_PROFILER_BUILTIN_BUF_SIZE (16 * 1024)     /*[bytes]*/
     #endif
 
     /*Header to include for the profiler*/
-    #define LV_PROFILER_INCLUDE "lvgl/src/misc/lv_profiler_builtin.h"
+    #define LV_PROFILER_INCLUDE "common/trace_manager/trace_manager.h"
 
     /*Profiler start point function*/
-    #define LV_PROFILER_BEGIN    LV_PROFILER_BUILTIN_BEGIN
+    #define LV_PROFILER_BEGIN    trace_manager_begin(__func__)
 
     /*Profiler end point function*/
-    #define LV_PROFILER_END      LV_PROFILER_BUILTIN_END
+    #define LV_PROFILER_END      trace_manager_end(__func__)
 
     /*Profiler start point function with custom tag*/
-    #define LV_PROFILER_BEGIN_TAG LV_PROFILER_BUILTIN_BEGIN_TAG
+    #define LV_PROFILER_BEGIN_TAG(tag) trace_manager_begin(tag)
 
     /*Profiler end point function with custom tag*/
-    #define LV_PROFILER_END_TAG   LV_PROFILER_BUILTIN_END_TAG
+    #define LV_PROFILER_END_TAG(tag)   trace_manager_end(tag)
 #endif
 
 /*1: Enable Monkey test*/
@@ -1000,6 +1001,12 @@
     #define LV_LINUX_FBDEV_RENDER_MODE   LV_DISPLAY_RENDER_MODE_PARTIAL
     #define LV_LINUX_FBDEV_BUFFER_COUNT  2
     #define LV_LINUX_FBDEV_BUFFER_SIZE   60
+    /*1: Render into a double height virtual framebuffer and flip with FBIOPAN_DISPLAY instead of copying.
+     *   Ignores the render mode and buffer settings above, falls back to them if the driver can't pan*/
+    /*省去每帧从绘制缓冲到/dev/fb0的拷贝，翻页避免撕裂*/
+    #define LV_LINUX_FBDEV_PAN_DISPLAY   1
+    /*1: Wait for vertical sync after each flip (FBIO_WAITFORVSYNC)*/
+    #define LV_LINUX_FBDEV_WAIT_VSYNC    1
 #endif
 
 /*Use Nuttx to open window and handle touchscreen*/
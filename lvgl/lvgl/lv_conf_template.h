@@ -997,6 +997,11 @@
     #define LV_LINUX_FBDEV_RENDER_MODE   LV_DISPLAY_RENDER_MODE_PARTIAL
     #define LV_LINUX_FBDEV_BUFFER_COUNT  0
     #define LV_LINUX_FBDEV_BUFFER_SIZE   60
+    /*1: Render into a double height virtual framebuffer and flip with FBIOPAN_DISPLAY instead of copying.
+     *   Ignores the render mode and buffer settings above, falls back to them if the driver can't pan*/
+    #define LV_LINUX_FBDEV_PAN_DISPLAY   0
+    /*1: Wait for vertical sync after each flip (FBIO_WAITFORVSYNC)*/
+    #define LV_LINUX_FBDEV_WAIT_VSYNC    0
 #endif
 
 /*Use Nuttx to open window and handle touchscreen*/
@@ -17,6 +17,8 @@
 #include <sys/mman.h>
 #include <sys/ioctl.h>
 #include <time.h>
+#include <errno.h>
+#include <string.h>
 
 #if LV_LINUX_FBDEV_BSD
     #include <sys/fcntl.h>
@@ -65,6 +67,10 @@ typedef struct {
     long int screensize;
     int fbfd;
     bool force_refresh;
+    bool pan;               /*Render directly into the two halves of the virtual framebuffer*/
+    bool wait_vsync;
+    lv_draw_buf_t buf1;
+    lv_draw_buf_t buf2;
 } lv_linux_fb_t;
 
 /**********************
@@ -73,6 +79,10 @@ typedef struct {
 
 static void flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * color_p);
 static uint32_t tick_get_cb(void);
+#if LV_LINUX_FBDEV_PAN_DISPLAY && !LV_LINUX_FBDEV_BSD
+    static bool fbdev_init_pan(lv_linux_fb_t * dsc);
+    static void flush_pan(lv_display_t * disp, lv_linux_fb_t * dsc, uint8_t * color_p);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -176,6 +186,11 @@ void lv_linux_fbdev_set_file(lv_display_t * disp, const char * file)
         perror("Error reading variable information");
         return;
     }
+
+#if LV_LINUX_FBDEV_PAN_DISPLAY
+    /* Has to be set up before mapping, the virtual resolution may change the memory size*/
+    dsc->pan = fbdev_init_pan(dsc);
+#endif
 #endif /* LV_LINUX_FBDEV_BSD */
 
     LV_LOG_INFO("%dx%d, %dbpp", dsc->vinfo.xres, dsc->vinfo.yres, dsc->vinfo.bits_per_pixel);
@@ -213,6 +228,31 @@ void lv_linux_fbdev_set_file(lv_display_t * disp, const char * file)
     int32_t hor_res = dsc->vinfo.xres;
     int32_t ver_res = dsc->vinfo.yres;
     int32_t width = dsc->vinfo.width;
+
+    if(dsc->pan) {
+        /* LVGL renders straight into the framebuffer. The top half is on screen now,
+         * so the first frame goes to the bottom half. In double buffered direct mode
+         * LVGL copies the areas changed in the previous frame to the other half itself.*/
+        lv_color_format_t cf = lv_display_get_color_format(disp);
+        uint32_t stride = dsc->finfo.line_length;
+        uint32_t data_size = stride * ver_res;
+        uint8_t * fbp = (uint8_t *)dsc->fbp;
+        lv_draw_buf_init(&dsc->buf1, hor_res, ver_res, cf, stride, fbp + data_size, data_size);
+        lv_draw_buf_init(&dsc->buf2, hor_res, ver_res, cf, stride, fbp, data_size);
+
+        lv_display_set_resolution(disp, hor_res, ver_res);
+        lv_display_set_draw_buffers(disp, &dsc->buf1, &dsc->buf2);
+        lv_display_set_render_mode(disp, LV_DISPLAY_RENDER_MODE_DIRECT);
+
+        if(width > 0) {
+            lv_display_set_dpi(disp, DIV_ROUND_UP(hor_res * 254, width * 10));
+        }
+
+        LV_LOG_INFO("Page flipping %" LV_PRId32 "x%" LV_PRId32 ", vsync %s", hor_res, ver_res,
+                    dsc->wait_vsync ? "on" : "off");
+        return;
+    }
+
     uint32_t draw_buf_size = hor_res * (dsc->vinfo.bits_per_pixel >> 3);
     if(LV_LINUX_FBDEV_RENDER_MODE == LV_DISPLAY_RENDER_MODE_PARTIAL) {
         draw_buf_size *= LV_LINUX_FBDEV_BUFFER_SIZE;
@@ -259,6 +299,13 @@ static void flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * colo
         return;
     }
 
+#if LV_LINUX_FBDEV_PAN_DISPLAY && !LV_LINUX_FBDEV_BSD
+    if(dsc->pan) {
+        flush_pan(disp, dsc, color_p);
+        return;
+    }
+#endif
+
     int32_t w = lv_area_get_width(area);
     int32_t h = lv_area_get_height(area);
     lv_color_format_t cf = lv_display_get_color_format(disp);
@@ -348,6 +395,80 @@ static void flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * colo
     lv_display_flush_ready(disp);
 }
 
+#if LV_LINUX_FBDEV_PAN_DISPLAY && !LV_LINUX_FBDEV_BSD
+/**
+ * Switch to a virtual framebuffer twice the screen height and check that the driver can pan it.
+ * On failure flush_cb keeps copying into the page the device reports as visible.
+ */
+static bool fbdev_init_pan(lv_linux_fb_t * dsc)
+{
+    struct fb_var_screeninfo vinfo = dsc->vinfo;
+
+    if(dsc->finfo.ypanstep == 0 || vinfo.yres % dsc->finfo.ypanstep != 0) {
+        LV_LOG_WARN("The framebuffer driver can't pan by %" LV_PRIu32 " lines, copying instead", vinfo.yres);
+        return false;
+    }
+
+    if(vinfo.yres_virtual < vinfo.yres * 2 || vinfo.xoffset != 0 || vinfo.yoffset != 0) {
+        vinfo.yres_virtual = vinfo.yres * 2;
+        vinfo.xoffset = 0;
+        vinfo.yoffset = 0;
+        vinfo.activate = FB_ACTIVATE_NOW;
+        if(ioctl(dsc->fbfd, FBIOPUT_VSCREENINFO, &vinfo) == -1) {
+            LV_LOG_WARN("Can't set virtual resolution %" LV_PRIu32 "x%" LV_PRIu32 ": %s, copying instead",
+                        vinfo.xres_virtual, vinfo.yres_virtual, strerror(errno));
+            return false;
+        }
+
+        /* The driver may adjust the request, and the line length and memory size along with it*/
+        if(ioctl(dsc->fbfd, FBIOGET_VSCREENINFO, &dsc->vinfo) == -1 ||
+           ioctl(dsc->fbfd, FBIOGET_FSCREENINFO, &dsc->finfo) == -1) {
+            perror("Error reading screen information");
+            return false;
+        }
+    }
+
+    if(dsc->vinfo.yres_virtual < dsc->vinfo.yres * 2 ||
+       dsc->finfo.smem_len < dsc->finfo.line_length * dsc->vinfo.yres * 2) {
+        LV_LOG_WARN("Not enough framebuffer memory for two pages, copying instead");
+        return false;
+    }
+
+    if(ioctl(dsc->fbfd, FBIOPAN_DISPLAY, &dsc->vinfo) == -1) {
+        LV_LOG_WARN("ioctl(FBIOPAN_DISPLAY) failed: %s, copying instead", strerror(errno));
+        return false;
+    }
+
+    dsc->wait_vsync = LV_LINUX_FBDEV_WAIT_VSYNC;
+    return true;
+}
+
+static void flush_pan(lv_display_t * disp, lv_linux_fb_t * dsc, uint8_t * color_p)
+{
+    /* Areas are already rendered in place, flip once the whole frame is done*/
+    if(!lv_display_flush_is_last(disp)) {
+        lv_display_flush_ready(disp);
+        return;
+    }
+
+    dsc->vinfo.yoffset = color_p == (uint8_t *)dsc->fbp ? 0 : dsc->vinfo.yres;
+    if(ioctl(dsc->fbfd, FBIOPAN_DISPLAY, &dsc->vinfo) == -1) {
+        perror("ioctl(FBIOPAN_DISPLAY)");
+    }
+
+    /* Don't return before the old page has left the screen, LVGL draws the next frame into it*/
+    if(dsc->wait_vsync) {
+        uint32_t crtc = 0;
+        if(ioctl(dsc->fbfd, FBIO_WAITFORVSYNC, &crtc) == -1) {
+            LV_LOG_WARN("ioctl(FBIO_WAITFORVSYNC) failed: %s, not waiting for vsync", strerror(errno));
+            dsc->wait_vsync = false;
+        }
+    }
+
+    lv_display_flush_ready(disp);
+}
+#endif /*LV_LINUX_FBDEV_PAN_DISPLAY*/
+
 static uint32_t tick_get_cb(void)
 {
     struct timespec t;
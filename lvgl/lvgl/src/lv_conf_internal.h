@@ -3292,6 +3292,20 @@
             #define LV_LINUX_FBDEV_BUFFER_SIZE   60
         #endif
     #endif
+    #ifndef LV_LINUX_FBDEV_PAN_DISPLAY
+        #ifdef CONFIG_LV_LINUX_FBDEV_PAN_DISPLAY
+            #define LV_LINUX_FBDEV_PAN_DISPLAY CONFIG_LV_LINUX_FBDEV_PAN_DISPLAY
+        #else
+            #define LV_LINUX_FBDEV_PAN_DISPLAY   0
+        #endif
+    #endif
+    #ifndef LV_LINUX_FBDEV_WAIT_VSYNC
+        #ifdef CONFIG_LV_LINUX_FBDEV_WAIT_VSYNC
+            #define LV_LINUX_FBDEV_WAIT_VSYNC CONFIG_LV_LINUX_FBDEV_WAIT_VSYNC
+        #else
+            #define LV_LINUX_FBDEV_WAIT_VSYNC    0
+        #endif
+    #endif
 #endif
 
 /*Use Nuttx to open window and handle touchscreen*/
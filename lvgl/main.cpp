@@ -6,6 +6,7 @@
 #include <src/misc/lv_event.h>
 #include <src/misc/lv_types.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <pthread.h>
 #include <time.h>
 #include <stdio.h>
@@ -14,8 +15,12 @@
 
 #include "gui_app/common/lv_lib.h"
 #include "gui_app/ui.h"
+#include "gui_app/common/ros_bridge/ros_bridge.h"
+#include "common/loop_manager/loop_manager.h"
+#include "common/trace_manager/trace_manager.h"
 
 #include "rclcpp/rclcpp.hpp"
+#include "rclcpp_components/component_manager.hpp"
 
 static const char *getenv_default(const char *name, const char *dflt)
 {
@@ -23,13 +28,36 @@ static const char *getenv_default(const char *name, const char *dflt)
 }
 
 #if LV_USE_EVDEV
+// 触摸设备有数据时立即读取，不等读取定时器
+static void touch_fd_cb(int fd, void *user_data)
+{
+    char buf[256];
+    // 这里只用于唤醒，事件由evdev驱动自己的描述符读取
+    while(read(fd, buf, sizeof(buf)) > 0) {
+    }
+    lv_indev_read((lv_indev_t *)user_data);
+}
+
 // 实际开发板运行的
 // https://docs.lvgl.io/9.2/integration/driver/touchpad/evdev.html
 static void lv_linux_indev_init(void)
 {
     lv_indev_t * touch;
+    const char *device = "/dev/input/event1";
     // 设置使用的时间设备
-    touch = lv_evdev_create(LV_INDEV_TYPE_POINTER, "/dev/input/event1");
+    touch = lv_evdev_create(LV_INDEV_TYPE_POINTER, device);
+    if(touch == NULL) {
+        return;
+    }
+    // 另开一个描述符监听同一设备，evdev会把事件发给每个打开者。
+    // 事件模式下松开后读取定时器暂停，按下期间LVGL会恢复它处理长按
+    int fd = open(device, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if(fd >= 0 && loop_manager_add_fd(fd, touch_fd_cb, touch) == 0) {
+        lv_indev_set_mode(touch, LV_INDEV_MODE_EVENT);
+    }
+    else if(fd >= 0) {
+        close(fd);
+    }
 }
 #endif
 
@@ -71,6 +99,18 @@ static void lv_linux_indev_init(void)
 #endif
 
 
+// 记录驱动flush回调(写fbdev/DRM)的耗时
+static void flush_trace_cb(lv_event_t * e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+    if(code == LV_EVENT_FLUSH_START) {
+        trace_manager_begin("flush_cb");
+    }
+    else if(code == LV_EVENT_FLUSH_FINISH) {
+        trace_manager_end("flush_cb");
+    }
+}
+
 void button_cb1(lv_event_t * e)
 {
     static bool state = false;
@@ -87,13 +127,27 @@ void button_cb1(lv_event_t * e)
 rclcpp::executors::SingleThreadedExecutor* g_executor = nullptr;
 int main(int argc, char **argv)
 {
+    // 需在ROS和LVGL的线程启动前初始化
+    trace_manager_init();
     rclcpp::init(argc, argv);
-    static rclcpp::executors::SingleThreadedExecutor executor;
-    g_executor = &executor;
+    auto executor = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+    g_executor = executor.get();
+    // 组件容器：bringup 以 layout:=ui 启动时，雷达驱动等节点加载到本进程，进程内通信
+    auto container = std::make_shared<rclcpp_components::ComponentManager>(executor, "lvgl_container");
+    executor->add_node(container);
     lv_init();
 
+    // 主循环在epoll中等待，LVGL定时器被创建或恢复时唤醒，重新计算等待时间
+    loop_manager_init();
+    lv_timer_handler_set_resume_cb([](void *) { loop_manager_wakeup(); }, NULL);
+    // Ctrl+C时rclcpp在其他线程关闭，唤醒主循环检查rclcpp::ok()
+    rclcpp::on_shutdown([]() { loop_manager_wakeup(); });
+
     /*Linux display device init*/
     lv_linux_disp_init();
+    if(trace_manager_enabled) {
+        lv_display_add_event_cb(lv_display_get_default(), flush_trace_cb, LV_EVENT_ALL, NULL);
+    }
 
     lv_linux_indev_init();
 
@@ -103,17 +157,24 @@ int main(int argc, char **argv)
     printf("Initializing UI...\n");
     ui_init();
 
+    // ROS回调在独立线程执行，慢回调不再卡住界面刷新
+    ros_bridge_start(executor);
+
     /*Handle LVGL tasks*/
     while(rclcpp::ok()) {
-        if(g_executor) {
-            g_executor->spin_some();
-        }
+        // 执行ROS线程投递给界面的任务
+        ros_bridge_drain();
+        // 返回距下一个定时器的时间，没有就绪的定时器时为LV_NO_TIMER_READY，一直等到有事件
         uint32_t sleep_ms = lv_timer_handler();
-        if(sleep_ms < 1) {
-            sleep_ms = 1;
-        }
-        usleep(sleep_ms * 1000);
+        loop_manager_wait(sleep_ms == LV_NO_TIMER_READY ? LOOP_MANAGER_WAIT_FOREVER : sleep_ms);
     }
+    ros_bridge_stop();
+    loop_manager_deinit();
+    trace_manager_deinit();
+    // 先卸载容器中的节点，再关闭ROS
+    executor->remove_node(container);
+    container.reset();
+    g_executor = nullptr;
     rclcpp::shutdown();
 
     return 0;
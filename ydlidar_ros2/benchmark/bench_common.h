@@ -0,0 +1,438 @@
+/*
+ *  YDLIDAR SYSTEM
+ *  YDLIDAR SDK benchmarks
+ *
+ *  Copyright 2017 - 2020 EAI TEAM
+ *  http://www.eaibot.com
+ *
+ */
+
+#ifndef YDLIDAR_BENCH_COMMON_H
+#define YDLIDAR_BENCH_COMMON_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+#include <core/common/ChannelCapture.h>
+#include "CYdLidar.h"
+
+namespace bench {
+
+inline uint64_t clockNs(clockid_t id) {
+  struct timespec t;
+  clock_gettime(id, &t);
+  return uint64_t(t.tv_sec) * 1000000000ull + t.tv_nsec;
+}
+
+/// 单调时钟
+inline uint64_t nowNs() {
+  return clockNs(CLOCK_MONOTONIC);
+}
+
+/// 当前线程占用的CPU时间，阻塞等待的时间不计入
+inline uint64_t threadCpuNs() {
+  return clockNs(CLOCK_THREAD_CPUTIME_ID);
+}
+
+/// 进程所有线程占用的CPU时间
+inline uint64_t processCpuNs() {
+  return clockNs(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+/// 样本统计
+class Stats {
+ public:
+  void add(double v) {
+    values_.push_back(v);
+  }
+
+  size_t size() const {
+    return values_.size();
+  }
+
+  double mean() const {
+    if (values_.empty()) {
+      return 0.0;
+    }
+
+    double sum = 0.0;
+
+    for (size_t i = 0; i < values_.size(); i++) {
+      sum += values_[i];
+    }
+
+    return sum / values_.size();
+  }
+
+  /// p取0..1
+  double percentile(double p) {
+    if (values_.empty()) {
+      return 0.0;
+    }
+
+    std::sort(values_.begin(), values_.end());
+    size_t i = static_cast<size_t>(p * (values_.size() - 1) + 0.5);
+    return values_[std::min(i, values_.size() - 1)];
+  }
+
+  double max() {
+    return percentile(1.0);
+  }
+
+  /// 打印一行：名称 均值 p50 p99 最大值
+  void print(const char *name, const char *unit) {
+    printf("  %-28s mean %10.1f  p50 %10.1f  p99 %10.1f  max %10.1f %s\n",
+           name, mean(), percentile(0.5), percentile(0.99), max(), unit);
+  }
+
+ private:
+  std::vector<double> values_;
+};
+
+/// 命令行参数，形如 name:=value，名称与params/ydlidar.yaml一致；
+/// 不带:=的参数按顺序作为位置参数
+class Options {
+ public:
+  Options(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+      std::string arg = argv[i];
+      size_t pos = arg.find(":=");
+
+      if (pos == std::string::npos) {
+        positional_.push_back(arg);
+      } else {
+        values_[arg.substr(0, pos)] = arg.substr(pos + 2);
+      }
+    }
+  }
+
+  bool has(const std::string &name) const {
+    return values_.count(name) != 0;
+  }
+
+  std::string str(const std::string &name, const std::string &dflt) const {
+    std::map<std::string, std::string>::const_iterator it = values_.find(name);
+    return it == values_.end() ? dflt : it->second;
+  }
+
+  int i(const std::string &name, int dflt) const {
+    return has(name) ? atoi(str(name, "").c_str()) : dflt;
+  }
+
+  float f(const std::string &name, float dflt) const {
+    return has(name) ? static_cast<float>(atof(str(name, "").c_str())) : dflt;
+  }
+
+  bool b(const std::string &name, bool dflt) const {
+    if (!has(name)) {
+      return dflt;
+    }
+
+    std::string v = str(name, "");
+    return v == "true" || v == "1";
+  }
+
+  const std::vector<std::string> &positional() const {
+    return positional_;
+  }
+
+ private:
+  std::map<std::string, std::string> values_;
+  std::vector<std::string> positional_;
+};
+
+/// 合成数据中雷达所在房间，矩形，雷达不在中心，房间内有一根圆柱
+struct Room {
+  double x_min = -1.7;
+  double x_max = 2.3;
+  double y_min = -1.3;
+  double y_max = 1.7;
+  double pillar_x = 0.9;
+  double pillar_y = 0.5;
+  double pillar_r = 0.12;
+
+  /// 从原点沿angle方向到墙或圆柱的距离(m)
+  double range(double angle) const {
+    return range(0.0, 0.0, angle);
+  }
+
+  /// 从(ox, oy)沿angle方向到墙或圆柱的距离(m)
+  double range(double ox, double oy, double angle) const {
+    double c = cos(angle);
+    double s = sin(angle);
+    double t = 1e9;
+    //射线与圆柱相交
+    double px = pillar_x - ox;
+    double py = pillar_y - oy;
+    double b = c * px + s * py;
+    double d = b * b - (px * px + py * py - pillar_r * pillar_r);
+
+    if (b > 0 && d >= 0) {
+      t = b - sqrt(d);
+    }
+
+    if (c > 1e-9) {
+      t = std::min(t, (x_max - ox) / c);
+    } else if (c < -1e-9) {
+      t = std::min(t, (x_min - ox) / c);
+    }
+
+    if (s > 1e-9) {
+      t = std::min(t, (y_max - oy) / s);
+    } else if (s < -1e-9) {
+      t = std::min(t, (y_min - oy) / s);
+    }
+
+    return t;
+  }
+};
+
+/// 合成的三角测距单通雷达数据流参数，默认与params/ydlidar.yaml中的雷达一致
+struct TriangleStream {
+  int revolutions = 100;
+  int points = 600;          ///< 每圈点数，3K采样率、5Hz
+  double frequency = 5.0;
+  bool intensity = true;     ///< 8位强度
+  uint32_t baudrate = 115200;
+  size_t chunk = 64;         ///< 每次读取到的字节数
+  double noise = 0.005;      ///< 距离噪声标准差(m)
+  double rotate = 0.0;       ///< 每圈房间转动的角度(rad)，模拟原地旋转
+  double circle = 0.0;       ///< 大于0时雷达沿此半径(m)的圆周前进，航向每圈转过rotate
+  double tail = 0.5;         ///< 一圈中圆柱边缘出现拖尾的概率
+};
+
+inline void put16(std::vector<uint8_t> &v, uint16_t x) {
+  v.push_back(x & 0xff);
+  v.push_back(x >> 8);
+}
+
+inline double gaussian(double sigma) {
+  double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+  double v = (rand() + 1.0) / (RAND_MAX + 2.0);
+  return sigma * sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+/// 按YDLIDAR三角雷达协议生成一包：包头、CT、点数、起止角、校验和、采样
+inline void appendTrianglePacket(std::vector<uint8_t> &out, uint8_t ct,
+                                 const std::vector<uint16_t> &dist,
+                                 double first_deg, double last_deg,
+                                 bool intensity) {
+  uint16_t fsa = uint16_t((uint16_t(first_deg * 64.0) << 1) | 1);
+  uint16_t lsa = uint16_t((uint16_t(last_deg * 64.0) << 1) | 1);
+  uint8_t n = static_cast<uint8_t>(dist.size());
+  uint16_t cs = 0x55AA ^ fsa ^ lsa ^ uint16_t(ct | (n << 8));
+  std::vector<uint8_t> samples;
+
+  for (size_t i = 0; i < dist.size(); i++) {
+    if (intensity) {
+      uint8_t qual = dist[i] ? 200 : 0;
+      samples.push_back(qual);
+      cs ^= qual;
+    }
+
+    put16(samples, dist[i]);
+    cs ^= dist[i];
+  }
+
+  out.push_back(0xAA);
+  out.push_back(0x55);
+  out.push_back(ct);
+  out.push_back(n);
+  put16(out, fsa);
+  put16(out, lsa);
+  put16(out, cs);
+  out.insert(out.end(), samples.begin(), samples.end());
+}
+
+/// 写入合成的抓包文件，格式见core/common/ChannelCapture.h
+inline bool writeTriangleCapture(const std::string &file,
+                                 const TriangleStream &cfg) {
+  using ydlidar::core::common::CaptureHeader;
+  Room room;
+  std::vector<uint8_t> stream;
+  const int per_packet = 40;
+  srand(1);
+
+  for (int r = 0; r < cfg.revolutions; r++) {
+    double step = 360.0 / cfg.points;
+    //雷达从原点出发，沿x方向前进并逐圈转向；一圈内视为不动
+    double heading = r * cfg.rotate;
+    double ox = cfg.circle * sin(heading);
+    double oy = cfg.circle * (1.0 - cos(heading));
+    bool tails = rand() < cfg.tail * RAND_MAX;
+    //零位包：CT最低位置1，高7位为转速(0.1Hz)
+    std::vector<uint16_t> zero(1, 0);
+    appendTrianglePacket(stream, uint8_t(0x01 | (int(cfg.frequency * 10) << 1)),
+                         zero, 0.0, 0.0, cfg.intensity);
+
+    for (int first = 0; first < cfg.points; first += per_packet) {
+      int n = std::min(per_packet, cfg.points - first);
+      std::vector<uint16_t> dist(n);
+
+      for (int i = 0; i < n; i++) {
+        double rad = (first + i) * step * M_PI / 180.0 + heading;
+        double range = room.range(ox, oy, rad);
+
+        //前景边缘外3个点内的背景点变为前后景之间的拖尾点
+        for (int j = 1; tails && j <= 3; j++) {
+          double fg = std::min(room.range(ox, oy, rad - j * step * M_PI / 180.0),
+                               room.range(ox, oy, rad + j * step * M_PI / 180.0));
+
+          if (range - fg > 0.3) {
+            range = fg + (range - fg) * j / 4.0;
+            break;
+          }
+        }
+
+        range += gaussian(cfg.noise);
+        //距离单位0.25mm，低2位为环境标志
+        int mm = static_cast<int>(range * 1000.0);
+        dist[i] = mm > 0 && mm < 16000 ? uint16_t(mm << 2) : 0;
+      }
+
+      appendTrianglePacket(stream, 0, dist, first * step,
+                           (first + n - 1) * step, cfg.intensity);
+    }
+  }
+
+  FILE *fp = fopen(file.c_str(), "wb");
+
+  if (!fp) {
+    fprintf(stderr, "Fail to create %s\n", file.c_str());
+    return false;
+  }
+
+  CaptureHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, CAPTURE_MAGIC, sizeof(header.magic));
+  header.version = CAPTURE_VERSION;
+  header.baudrate = cfg.baudrate;
+  fwrite(&header, sizeof(header), 1, fp);
+
+  //一圈的字节均匀分布在一个转动周期内
+  double us_per_byte = 1e6 / cfg.frequency / (stream.size() / cfg.revolutions);
+
+  for (size_t pos = 0; pos < stream.size();) {
+    uint16_t len = static_cast<uint16_t>(std::min(cfg.chunk, stream.size() - pos));
+    uint32_t delta = static_cast<uint32_t>(len * us_per_byte);
+    fwrite(&delta, sizeof(delta), 1, fp);
+    fwrite(&len, sizeof(len), 1, fp);
+    fwrite(&stream[pos], 1, len, fp);
+    pos += len;
+  }
+
+  fclose(fp);
+  printf("Synthesized %d revolutions, %d points each, %zu bytes -> %s\n",
+         cfg.revolutions, cfg.points, stream.size(), file.c_str());
+  return true;
+}
+
+/// 按params/ydlidar.yaml中的参数名和默认值配置回放雷达
+inline void setupReplay(CYdLidar &laser, const std::string &capture,
+                        const Options &opt) {
+  laser.setlidaropt(LidarPropSerialPort, capture.c_str(), capture.size());
+  std::string ignore = opt.str("ignore_array", "");
+  laser.setlidaropt(LidarPropIgnoreArray, ignore.c_str(), ignore.size());
+
+  int v = YDLIDAR_TYPE_REPLAY;
+  laser.setlidaropt(LidarPropDeviceType, &v, sizeof(int));
+  v = opt.i("baudrate", 115200);
+  laser.setlidaropt(LidarPropSerialBaudrate, &v, sizeof(int));
+  v = opt.i("lidar_type", TYPE_TRIANGLE);
+  laser.setlidaropt(LidarPropLidarType, &v, sizeof(int));
+  v = opt.i("sample_rate", 3);
+  laser.setlidaropt(LidarPropSampleRate, &v, sizeof(int));
+  v = opt.i("intensity_bit", 8);
+  laser.setlidaropt(LidarPropIntenstiyBit, &v, sizeof(int));
+  v = opt.i("abnormal_check_count", 4);
+  laser.setlidaropt(LidarPropAbnormalCheckCount, &v, sizeof(int));
+
+  float f = opt.f("angle_max", 180.f);
+  laser.setlidaropt(LidarPropMaxAngle, &f, sizeof(float));
+  f = opt.f("angle_min", -180.f);
+  laser.setlidaropt(LidarPropMinAngle, &f, sizeof(float));
+  f = opt.f("range_max", 64.f);
+  laser.setlidaropt(LidarPropMaxRange, &f, sizeof(float));
+  f = opt.f("range_min", 0.05f);
+  laser.setlidaropt(LidarPropMinRange, &f, sizeof(float));
+  f = opt.f("frequency", 5.f);
+  laser.setlidaropt(LidarPropScanFrequency, &f, sizeof(float));
+
+  bool b = opt.b("fixed_resolution", false);
+  laser.setlidaropt(LidarPropFixedResolution, &b, sizeof(bool));
+  b = opt.b("reversion", true);
+  laser.setlidaropt(LidarPropReversion, &b, sizeof(bool));
+  b = opt.b("inverted", true);
+  laser.setlidaropt(LidarPropInverted, &b, sizeof(bool));
+  b = opt.b("isSingleChannel", true);
+  laser.setlidaropt(LidarPropSingleChannel, &b, sizeof(bool));
+  b = opt.b("intensity", true);
+  laser.setlidaropt(LidarPropIntenstiy, &b, sizeof(bool));
+  //回放结束后不重连
+  b = false;
+  laser.setlidaropt(LidarPropAutoReconnect, &b, sizeof(bool));
+  laser.setlidaropt(LidarPropSupportMotorDtrCtrl, &b, sizeof(bool));
+  b = opt.b("replay_realtime", true);
+  laser.setlidaropt(LidarPropReplayRealtime, &b, sizeof(bool));
+}
+
+/// 取第一个位置参数作为抓包文件，带synthesize:=N时先合成N圈数据
+inline bool prepareCapture(int argc, char **argv, const Options &opt,
+                           std::string &capture) {
+  if (opt.positional().empty()) {
+    fprintf(stderr, "Usage: %s <capture file> [synthesize:=revolutions] "
+            "[name:=value ...]\n", argc > 0 ? argv[0] : "benchmark");
+    return false;
+  }
+
+  capture = opt.positional()[0];
+
+  if (!opt.has("synthesize")) {
+    return true;
+  }
+
+  TriangleStream cfg;
+  cfg.revolutions = opt.i("synthesize", cfg.revolutions);
+  cfg.frequency = opt.f("frequency", 5.f);
+  cfg.points = static_cast<int>(opt.i("sample_rate", 3) * 1000 / cfg.frequency);
+  cfg.intensity = opt.b("intensity", true);
+  //模拟移动：rotate每圈转向的角度(°)，circle圆周半径(m)
+  cfg.rotate = opt.f("rotate", 0.f) * M_PI / 180.0;
+  cfg.circle = opt.f("circle", 0.f);
+  return writeTriangleCapture(capture, cfg);
+}
+
+/// 回放抓包文件，收集全部的圈数据
+inline bool collectScans(const std::string &capture, const Options &opt,
+                         std::vector<LaserScan> &scans) {
+  ydlidar::os_init();
+  CYdLidar laser;
+  setupReplay(laser, capture, opt);
+
+  if (!laser.initialize() || !laser.turnOn()) {
+    fprintf(stderr, "Fail to start replay of %s\n", capture.c_str());
+    return false;
+  }
+
+  LaserScan scan;
+
+  //数据回放完后等待超时返回false
+  while (ydlidar::os_isOk() && laser.doProcessSimple(scan)) {
+    scans.push_back(scan);
+  }
+
+  laser.turnOff();
+  laser.disconnecting();
+  return !scans.empty();
+}
+
+}  // namespace bench
+
+#endif  // YDLIDAR_BENCH_COMMON_H
@@ -0,0 +1,155 @@
+/*
+ *  YDLIDAR SYSTEM
+ *  YDLIDAR SDK benchmarks
+ *
+ *  Copyright 2017 - 2020 EAI TEAM
+ *  http://www.eaibot.com
+ *
+ */
+
+/*
+ * 对比滤波器改为结构体数组形式（ScanArrays）前后的结果和耗时。
+ * 改动前的实现在reference目录下，类名加Ref前缀。
+ *
+ *   filter_benchmark <capture> [name:=value ...]
+ *   filter_benchmark /tmp/syn.cap synthesize:=50
+ *
+ * 先回放抓包文件收集全部圈数据，再对每一圈分别运行新旧滤波器。
+ */
+
+#include "bench_common.h"
+#include "filters/NoiseFilter.h"
+#include "filters/StrongLightFilter.h"
+#include "reference/RefNoiseFilter.h"
+#include "reference/RefStrongLightFilter.h"
+
+using namespace bench;
+
+/// 新旧滤波器输出的差异
+struct Diff {
+  size_t points = 0;        ///< 比较的点数
+  size_t size_mismatch = 0; ///< 输出点数不同的圈数
+  size_t removed_ref = 0;   ///< 旧实现滤掉的点数
+  size_t removed_new = 0;   ///< 新实现滤掉的点数
+  size_t flag_mismatch = 0; ///< 一个滤掉另一个保留的点数
+  double max_range = 0.0;   ///< 都保留的点的最大距离差(m)
+
+  void compare(const LaserScan &in, const LaserScan &ref,
+               const LaserScan &out) {
+    if (ref.points.size() != out.points.size()) {
+      size_mismatch++;
+      return;
+    }
+
+    for (size_t i = 0; i < ref.points.size(); i++) {
+      //StrongLightFilter会去掉无效点并按角度排序，按输出的下标比较
+      bool was_valid = i < in.points.size() && in.points[i].range > 0;
+      bool ref_kept = ref.points[i].range > 0;
+      bool new_kept = out.points[i].range > 0;
+      points++;
+      removed_ref += was_valid && !ref_kept;
+      removed_new += was_valid && !new_kept;
+      flag_mismatch += ref_kept != new_kept;
+
+      if (ref_kept && new_kept) {
+        max_range = std::max(max_range,
+                             double(fabsf(ref.points[i].range - out.points[i].range)));
+      }
+    }
+  }
+};
+
+/// 对全部圈数据运行reps遍，返回每个点的CPU时间(ns)
+static double timeFilter(FilterInterface &filter, const std::vector<LaserScan> &scans,
+                         int reps, std::vector<LaserScan> &outs) {
+  outs.resize(scans.size());
+  size_t points = 0;
+  uint64_t start = threadCpuNs();
+
+  for (int r = 0; r < reps; r++) {
+    for (size_t i = 0; i < scans.size(); i++) {
+      filter.filter(scans[i], 0, 0, outs[i]);
+      points += scans[i].points.size();
+    }
+  }
+
+  return points ? double(threadCpuNs() - start) / points : 0.0;
+}
+
+static void compareFilters(const char *name, FilterInterface &ref,
+                           FilterInterface &filter,
+                           const std::vector<LaserScan> &scans, int reps) {
+  std::vector<LaserScan> ref_out;
+  std::vector<LaserScan> new_out;
+  double ref_ns = timeFilter(ref, scans, reps, ref_out);
+  double new_ns = timeFilter(filter, scans, reps, new_out);
+  Diff diff;
+
+  for (size_t i = 0; i < scans.size(); i++) {
+    diff.compare(scans[i], ref_out[i], new_out[i]);
+  }
+
+  printf("%-18s %8.1f %8.1f %7.2fx %9zu %9zu %9zu %9zu %10.2e\n", name,
+         ref_ns, new_ns, new_ns > 0 ? ref_ns / new_ns : 0.0,
+         diff.removed_ref, diff.removed_new, diff.flag_mismatch,
+         diff.size_mismatch, diff.max_range);
+}
+
+int main(int argc, char **argv) {
+  Options opt(argc, argv);
+  std::string capture;
+
+  if (!prepareCapture(argc, argv, opt, capture)) {
+    return 1;
+  }
+
+  std::vector<LaserScan> scans;
+
+  if (!collectScans(capture, opt, scans)) {
+    return 1;
+  }
+
+  size_t points = 0;
+
+  for (size_t i = 0; i < scans.size(); i++) {
+    points += scans[i].points.size();
+  }
+
+  const int reps = opt.i("reps", 20);
+  printf("Filter %zu scans, %zu points, %d passes\n", scans.size(), points,
+         reps);
+  printf("%-18s %8s %8s %8s %9s %9s %9s %9s %10s\n", "", "ref ns", "new ns",
+         "speedup", "ref drop", "new drop", "mismatch", "size diff",
+         "max dr(m)");
+
+  const char *strategies[] = {"Noise Normal", "Noise Tail",
+                              "Noise TailStrong", "Noise TailWeek",
+                              "Noise TailStrong2"
+                             };
+
+  for (int s = NoiseFilter::FS_Normal; s <= NoiseFilter::FS_TailStrong2; s++) {
+    RefNoiseFilter ref;
+    NoiseFilter filter;
+    ref.setStrategy(s);
+    filter.setStrategy(s);
+    compareFilters(strategies[s], ref, filter, scans, reps);
+  }
+
+  RefStrongLightFilter ref;
+  StrongLightFilter filter;
+  compareFilters("StrongLight", ref, filter, scans, reps);
+
+  //拆分为连续数组（含逐点正余弦）的开销
+  ScanArrays arrays;
+  uint64_t start = threadCpuNs();
+
+  for (int r = 0; r < reps; r++) {
+    for (size_t i = 0; i < scans.size(); i++) {
+      arrays.assign(scans[i].points);
+    }
+  }
+
+  printf("%-18s %17.1f\n", "ScanArrays::assign",
+         points ? double(threadCpuNs() - start) / points / reps : 0.0);
+  return 0;
+}
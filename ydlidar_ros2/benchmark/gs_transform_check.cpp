@@ -0,0 +1,229 @@
+/*
+ *  YDLIDAR SYSTEM
+ *  YDLIDAR SDK benchmarks
+ *
+ *  Copyright 2017 - 2020 EAI TEAM
+ *  http://www.eaibot.com
+ *
+ */
+
+/*
+ * GS雷达像素换算表精度检查：随机生成标定参数，对每个像素和每个距离
+ * 比较换算表（单精度）与原双精度算法的角度和距离，并统计耗时。
+ *
+ *   gs_transform_check [calibrations:=50] [max_angle_error:=3e-5]
+ *                      [max_dist_error:=1]
+ *
+ * 误差超出限值时返回非0。
+ */
+
+#include "bench_common.h"
+#include "GSLidarDriver.h"
+
+using namespace bench;
+
+/// 公开换算表接口
+class LutDriver : public ydlidar::GSLidarDriver {
+ public:
+  using GSLidarDriver::PixelLut;
+  using GSLidarDriver::buildPixelLut;
+  using GSLidarDriver::angTransform;
+  using GSLidarDriver::angTransform2;
+};
+
+/// 一个模组的标定参数
+struct Calibration {
+  double k0, b0, k1, b1, bias;
+};
+
+/// 换算表之前的双精度算法（GS2/GS5）
+static void refAngTransform(const Calibration &c, double pitchAngle,
+                            int nodeCount, uint16_t dist, int n,
+                            double *dstTheta, uint16_t *dstDist) {
+  double pixelU = n, Dist, theta, tempTheta, tempDist, tempX, tempY;
+  const double pitch = pitchAngle + c.bias;
+
+  if (n < nodeCount / 2) {
+    pixelU = nodeCount / 2 - pixelU;
+    tempTheta = c.b0 > 1 ? c.k0 * pixelU - c.b0 :
+                atan(c.k0 * pixelU - c.b0) * 180 / M_PI;
+    tempDist = (dist - Angle_Px) / cos((pitch - tempTheta) * M_PI / 180);
+    tempTheta = tempTheta * M_PI / 180;
+    tempX = cos(pitch * M_PI / 180) * tempDist * cos(tempTheta) +
+            sin(pitch * M_PI / 180) * (tempDist * sin(tempTheta));
+    tempY = -sin(pitch * M_PI / 180) * tempDist * cos(tempTheta) +
+            cos(pitch * M_PI / 180) * (tempDist * sin(tempTheta));
+    tempX = tempX + Angle_Px;
+    tempY = tempY - Angle_Py;
+  } else {
+    pixelU = nodeCount - pixelU;
+    tempTheta = c.b1 > 1 ? c.k1 * pixelU - c.b1 :
+                atan(c.k1 * pixelU - c.b1) * 180 / M_PI;
+    tempDist = (dist - Angle_Px) / cos((pitch + tempTheta) * M_PI / 180);
+    tempTheta = tempTheta * M_PI / 180;
+    tempX = cos(-pitch * M_PI / 180) * tempDist * cos(tempTheta) +
+            sin(-pitch * M_PI / 180) * (tempDist * sin(tempTheta));
+    tempY = -sin(-pitch * M_PI / 180) * tempDist * cos(tempTheta) +
+            cos(-pitch * M_PI / 180) * (tempDist * sin(tempTheta));
+    tempX = tempX + Angle_Px;
+    tempY = tempY + Angle_Py;
+  }
+
+  Dist = sqrt(tempX * tempX + tempY * tempY);
+  theta = atan(tempY / tempX) * 180 / M_PI;
+
+  if (theta < 0) {
+    theta += 360;
+  }
+
+  *dstTheta = theta;
+  *dstDist = Dist;
+}
+
+/// 换算表之前的双精度算法（GS1/GS6）
+static void refAngTransform2(const Calibration &c, int nodeCount,
+                             uint16_t dist, int n, double *dstTheta,
+                             uint16_t *dstDist) {
+  double pixelU = nodeCount - n;
+  double theta = atan(c.k0 * pixelU - c.b0) * 180 / M_PI;
+  double Dist = dist / cos(theta * M_PI / 180);
+
+  if (theta < 0) {
+    theta += 360;
+  }
+
+  *dstTheta = theta;
+  *dstDist = Dist;
+}
+
+static double uniform(double lo, double hi) {
+  return lo + (hi - lo) * (rand() / (RAND_MAX + 1.0));
+}
+
+/// 与GSLidarDriver::waitPackage相同的1/64°角度编码
+static uint16_t encodeAngle(double a) {
+  if (a * 64 > 23040) {
+    return uint16_t(a * 64 - 23040);
+  }
+
+  return uint16_t(a * 64);
+}
+
+/// 一种型号的误差统计
+struct Errors {
+  double angle = 0.0;   ///< 最大角度误差(°)
+  int dist = 0;         ///< 最大距离误差(mm)
+  size_t flips = 0;     ///< 1/64°编码不同的点数
+  size_t points = 0;
+  double ref_ns = 0.0;
+  double lut_ns = 0.0;
+};
+
+static Errors checkModel(int model, int calibrations, int nodeCount) {
+  const bool mono = model == ydlidar::DriverInterface::YDLIDAR_GS1 ||
+                    model == ydlidar::DriverInterface::YDLIDAR_GS6;
+  const double pitchAngle = model == ydlidar::DriverInterface::YDLIDAR_GS5 ?
+                            Angle_PAngle2 : Angle_PAngle;
+  const int maxDist = model == ydlidar::DriverInterface::YDLIDAR_GS2 ? 0x1FF :
+                      model == ydlidar::DriverInterface::YDLIDAR_GS1 ? 0x3FF : 0x7FF;
+  Errors e;
+  std::vector<double> ref_theta(maxDist + 1);
+  std::vector<uint16_t> ref_dist(maxDist + 1);
+  std::vector<double> lut_theta(maxDist + 1);
+  std::vector<uint16_t> lut_dist(maxDist + 1);
+  uint64_t ref_cpu = 0;
+  uint64_t lut_cpu = 0;
+
+  for (int k = 0; k < calibrations; k++) {
+    Calibration c;
+    //一半标定为反正切形式（b<=1），一半为线性形式（b>1，单位°）
+    bool linear = !mono && (k & 1);
+    c.k0 = linear ? uniform(0.2, 0.5) : uniform(0.005, 0.02);
+    c.b0 = linear ? uniform(1.5, 20.0) : uniform(-0.5, 0.5);
+    c.k1 = linear ? uniform(0.2, 0.5) : uniform(0.005, 0.02);
+    c.b1 = linear ? uniform(1.5, 20.0) : uniform(-0.5, 0.5);
+    c.bias = uniform(-1.0, 1.0);
+
+    LutDriver::PixelLut lut;
+    LutDriver::buildPixelLut(lut, model, nodeCount, c.k0, c.b0, c.k1, c.b1,
+                             pitchAngle + c.bias);
+
+    for (int i = 0; i < nodeCount; i++) {
+      //GS6的像素按包内倒序
+      const int n = model == ydlidar::DriverInterface::YDLIDAR_GS6 ? nodeCount - i : i;
+      uint64_t t0 = threadCpuNs();
+
+      for (int d = 1; d <= maxDist; d++) {
+        if (mono) {
+          refAngTransform2(c, nodeCount, d, n, &ref_theta[d], &ref_dist[d]);
+        } else {
+          refAngTransform(c, pitchAngle, nodeCount, d, n, &ref_theta[d],
+                          &ref_dist[d]);
+        }
+      }
+
+      uint64_t t1 = threadCpuNs();
+
+      for (int d = 1; d <= maxDist; d++) {
+        if (mono) {
+          LutDriver::angTransform2(lut, d, n, &lut_theta[d], &lut_dist[d]);
+        } else {
+          LutDriver::angTransform(lut, d, n, &lut_theta[d], &lut_dist[d]);
+        }
+      }
+
+      uint64_t t2 = threadCpuNs();
+      ref_cpu += t1 - t0;
+      lut_cpu += t2 - t1;
+
+      for (int d = 1; d <= maxDist; d++) {
+        double da = fabs(ref_theta[d] - lut_theta[d]);
+        da = std::min(da, 360.0 - da);
+        e.angle = std::max(e.angle, da);
+        e.dist = std::max(e.dist, abs(int(ref_dist[d]) - int(lut_dist[d])));
+        e.flips += encodeAngle(ref_theta[d]) != encodeAngle(lut_theta[d]);
+        e.points++;
+      }
+    }
+  }
+
+  e.ref_ns = double(ref_cpu) / e.points;
+  e.lut_ns = double(lut_cpu) / e.points;
+  return e;
+}
+
+int main(int argc, char **argv) {
+  Options opt(argc, argv);
+  const int calibrations = opt.i("calibrations", 50);
+  const double maxAngle = opt.f("max_angle_error", 3e-5f);
+  const int maxDist = opt.i("max_dist_error", 1);
+  const int nodeCount = opt.i("node_count", GS_PACKMAXNODES);
+  srand(1);
+
+  const struct {
+    int model;
+    const char *name;
+  } models[] = {
+    {ydlidar::DriverInterface::YDLIDAR_GS2, "GS2"},
+    {ydlidar::DriverInterface::YDLIDAR_GS5, "GS5"},
+    {ydlidar::DriverInterface::YDLIDAR_GS1, "GS1"},
+    {ydlidar::DriverInterface::YDLIDAR_GS6, "GS6"},
+  };
+
+  printf("GS pixel table vs double path, %d calibrations, %d pixels\n",
+         calibrations, nodeCount);
+  printf("%-6s %12s %9s %12s %9s %9s %9s\n", "model", "points", "max dA(°)",
+         "max dD(mm)", "1/64 flip", "ref ns", "lut ns");
+  bool ok = true;
+
+  for (size_t i = 0; i < _countof(models); i++) {
+    Errors e = checkModel(models[i].model, calibrations, nodeCount);
+    printf("%-6s %12zu %9.2e %12d %9zu %9.1f %9.1f\n", models[i].name,
+           e.points, e.angle, e.dist, e.flips, e.ref_ns, e.lut_ns);
+    ok = ok && e.angle <= maxAngle && e.dist <= maxDist;
+  }
+
+  printf("%s (limits %.1e°, %d mm)\n", ok ? "PASS" : "FAIL", maxAngle,
+         maxDist);
+  return ok ? 0 : 1;
+}
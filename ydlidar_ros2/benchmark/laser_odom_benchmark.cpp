@@ -0,0 +1,122 @@
+/*
+ *  YDLIDAR SYSTEM
+ *  YDLIDAR SDK benchmarks
+ *
+ *  Copyright 2017 - 2020 EAI TEAM
+ *  http://www.eaibot.com
+ *
+ */
+
+/*
+ * 激光里程计（src/laser_odometry.cpp）在录制数据上的耗时和漂移。
+ * 抓包文件经回放通道和 CYdLidar 得到各圈数据，再逐圈调用
+ * LaserOdometry::update，不使用轮式里程计预测，与驱动中
+ * laser_odom_wheel_topic为空时相同。
+ *
+ *   laser_odom_benchmark <capture> [name:=value ...]
+ *   laser_odom_benchmark /tmp/odom.cap synthesize:=200 rotate:=3.6 circle:=0.3
+ *
+ * 合成数据中雷达匀速沿圆周前进，相邻两圈的真实位移和转角固定，
+ * 因此不必知道回放从第几圈开始，即可按圈计算误差。
+ */
+
+#include "bench_common.h"
+#include "src/laser_odometry.h"
+
+using namespace bench;
+using ydlidar_ros2::LaserOdometry;
+using ydlidar_ros2::LaserOdometryConfig;
+using ydlidar_ros2::Pose2D;
+
+int main(int argc, char **argv) {
+  Options opt(argc, argv);
+  std::string capture;
+
+  if (!prepareCapture(argc, argv, opt, capture)) {
+    return 1;
+  }
+
+  std::vector<LaserScan> scans;
+
+  if (!collectScans(capture, opt, scans)) {
+    return 1;
+  }
+
+  LaserOdometryConfig config;
+  config.resolution = opt.f("laser_odom_resolution", config.resolution);
+  config.max_range = opt.f("laser_odom_max_range", config.max_range);
+  config.min_score = opt.f("laser_odom_min_score", config.min_score);
+  const int passes = std::max(1, opt.i("passes", 5));
+
+  Stats update_cpu;
+  std::vector<Pose2D> poses(scans.size());
+  size_t unmatched = 0;
+  size_t points = 0;
+
+  for (size_t i = 0; i < scans.size(); i++) {
+    points += scans[i].points.size();
+  }
+
+  //每遍重新开始，位姿取最后一遍的结果
+  for (int pass = 0; pass < passes; pass++) {
+    LaserOdometry odometry(config);
+    unmatched = 0;
+
+    for (size_t i = 0; i < scans.size(); i++) {
+      uint64_t c0 = threadCpuNs();
+      bool matched = odometry.update(scans[i], Pose2D(), poses[i]);
+      update_cpu.add((threadCpuNs() - c0) / 1e3);
+
+      if (!matched) {
+        unmatched++;
+      }
+    }
+  }
+
+  printf("Replay %s\n", capture.c_str());
+  printf("  %zu scans, %.0f points per scan, %d passes\n", scans.size(),
+         scans.empty() ? 0.0 : double(points) / scans.size(), passes);
+  printf("LaserOdometry::update\n");
+  update_cpu.print("cpu per scan", "us");
+  printf("  unmatched scans %zu\n", unmatched);
+
+  //雷达坐标系可能经过镜像，只比较位移长度和转角绝对值
+  double yaw = 0.0;
+
+  for (size_t i = 1; i < poses.size(); i++) {
+    Pose2D step = composePose(invertPose(poses[i - 1]), poses[i]);
+    yaw += step.yaw;
+  }
+
+  Pose2D end = composePose(invertPose(poses.front()), poses.back());
+  printf("  first to last scan: %.3f m, %.2f deg turned\n",
+         hypot(end.x, end.y), fabs(yaw) * 180.0 / M_PI);
+
+  if (!opt.has("synthesize")) {
+    return 0;
+  }
+
+  const double rotate = opt.f("rotate", 0.f) * M_PI / 180.0;
+  const double circle = opt.f("circle", 0.f);
+  const double true_step = 2.0 * circle * fabs(sin(rotate / 2.0));
+  Stats step_dist;
+  Stats step_angle;
+
+  for (size_t i = 1; i < poses.size(); i++) {
+    Pose2D step = composePose(invertPose(poses[i - 1]), poses[i]);
+    step_dist.add(fabs(hypot(step.x, step.y) - true_step) * 1e3);
+    step_angle.add(fabs(fabs(step.yaw) - rotate) * 180.0 / M_PI);
+  }
+
+  const size_t k = poses.size() - 1;
+  const double true_yaw = k * rotate;
+  const double true_dist = 2.0 * circle * fabs(sin(true_yaw / 2.0));
+  printf("Against the synthetic trajectory\n");
+  step_dist.print("distance error per scan", "mm");
+  step_angle.print("angle error per scan", "deg");
+  printf("  drift over %zu scans: %.1f mm, %.2f deg (true %.3f m, %.2f deg)\n",
+         k, fabs(hypot(end.x, end.y) - true_dist) * 1e3,
+         fabs(fabs(yaw) - true_yaw) * 180.0 / M_PI, true_dist,
+         true_yaw * 180.0 / M_PI);
+  return 0;
+}
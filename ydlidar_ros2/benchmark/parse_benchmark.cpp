@@ -0,0 +1,107 @@
+/*
+ *  YDLIDAR SYSTEM
+ *  YDLIDAR SDK benchmarks
+ *
+ *  Copyright 2017 - 2020 EAI TEAM
+ *  http://www.eaibot.com
+ *
+ */
+
+/*
+ * 三角雷达数据包解析吞吐：抓包文件一次性回放，在调用线程上直接执行
+ * YDlidarDriver::waitScanData，不经过驱动的扫描线程。
+ *
+ *   parse_benchmark <capture> [name:=value ...]
+ *   parse_benchmark /tmp/syn.cap synthesize:=100
+ */
+
+#include "bench_common.h"
+#include "YDlidarDriver.h"
+
+using namespace bench;
+
+/// 公开waitScanData，在调用线程上解析
+class ParseDriver : public ydlidar::YDlidarDriver {
+ public:
+  ParseDriver() : YDlidarDriver(YDLIDAR_TYPE_REPLAY) {}
+  using YDlidarDriver::waitScanData;
+};
+
+static long fileSize(const std::string &file) {
+  FILE *fp = fopen(file.c_str(), "rb");
+
+  if (!fp) {
+    return 0;
+  }
+
+  fseek(fp, 0, SEEK_END);
+  long size = ftell(fp);
+  fclose(fp);
+  return size;
+}
+
+int main(int argc, char **argv) {
+  Options opt(argc, argv);
+
+  std::string capture;
+
+  if (!prepareCapture(argc, argv, opt, capture)) {
+    return 1;
+  }
+
+  ParseDriver driver;
+  driver.setReplayRealtime(false);
+  driver.setSingleChannel(opt.b("isSingleChannel", true));
+  driver.setIntensities(opt.b("intensity", true));
+  driver.setIntensityBit(opt.i("intensity_bit", 8));
+  driver.setLidarType(opt.i("lidar_type", TYPE_TRIANGLE));
+
+  if (!IS_OK(driver.connect(capture.c_str(), opt.i("baudrate", 115200)))) {
+    fprintf(stderr, "Fail to open %s\n", capture.c_str());
+    return 1;
+  }
+
+  //与驱动扫描线程相同，每次最多取128个点，遇到零位包提前返回
+  node_info nodes[128];
+  Stats rev_cpu;
+  size_t revolutions = 0;
+  size_t points = 0;
+  const uint64_t start = threadCpuNs();
+  uint64_t rev_start = start;
+  uint64_t total = 0;
+
+  while (true) {
+    size_t count = _countof(nodes);
+
+    //数据回放完后超时返回，最后一次调用含等待超时的开销，不计入
+    if (!IS_OK(driver.waitScanData(nodes, count, 100))) {
+      points += count;
+      break;
+    }
+
+    uint64_t now = threadCpuNs();
+    total = now - start;
+    points += count;
+
+    if (count && (nodes[count - 1].sync & LIDAR_RESP_SYNCBIT)) {
+      rev_cpu.add((now - rev_start) / 1e3);
+      rev_start = now;
+      revolutions++;
+    }
+  }
+
+  driver.disconnect();
+  const long bytes = fileSize(capture);
+
+  printf("Parse %s, %ld bytes\n", capture.c_str(), bytes);
+  printf("  %zu revolutions, %zu points, %.1f ms cpu\n", revolutions, points,
+         total / 1e6);
+  rev_cpu.print("waitScanData per revolution", "us");
+
+  if (points && total) {
+    printf("  %.1f ns per point, %.1f MB/s\n", double(total) / points,
+           bytes / (total / 1e9) / 1e6);
+  }
+
+  return revolutions ? 0 : 1;
+}
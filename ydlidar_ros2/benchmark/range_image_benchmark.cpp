@@ -0,0 +1,120 @@
+/*
+ *  YDLIDAR SYSTEM
+ *  YDLIDAR SDK benchmarks
+ *
+ *  Copyright 2017 - 2020 EAI TEAM
+ *  http://www.eaibot.com
+ *
+ */
+
+/*
+ * 距离图编解码往返检查：每一圈编码后再解码，与按LaserScan分格、
+ * 按分辨率量化的期望值逐格比较，并统计压缩率和编解码耗时。
+ *
+ *   range_image_benchmark <capture> [resolution:=0.001] [name:=value ...]
+ *   range_image_benchmark /tmp/syn.cap synthesize:=30
+ *
+ * 有不一致的格时返回非0。
+ */
+
+#include "bench_common.h"
+#include "src/range_image.h"
+
+using namespace bench;
+
+/// 与ydlidar_component.cpp中fillScanMsg相同的分格，超出量化范围的距离为0
+static void expectedRanges(const LaserScan &scan, float resolution,
+                           std::vector<float> &ranges) {
+  int size = (scan.config.max_angle - scan.config.min_angle) /
+             scan.config.angle_increment + 1;
+  ranges.assign(std::max(size, 0), 0.0f);
+
+  for (size_t i = 0; i < scan.points.size(); i++) {
+    const LaserPoint &p = scan.points[i];
+    int index = std::ceil((p.angle - scan.config.min_angle) /
+                          scan.config.angle_increment);
+
+    if (index >= 0 && index < size && p.range >= scan.config.min_range &&
+        p.range <= scan.config.max_range && p.range < 65535 * resolution) {
+      ranges[index] = p.range;
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  Options opt(argc, argv);
+  std::string capture;
+
+  if (!prepareCapture(argc, argv, opt, capture)) {
+    return 1;
+  }
+
+  std::vector<LaserScan> scans;
+
+  if (!collectScans(capture, opt, scans)) {
+    return 1;
+  }
+
+  const float resolution = opt.f("resolution", 0.001f);
+  std::vector<uint8_t> encoded;
+  std::vector<float> expected;
+  std::vector<float> decoded;
+  ydlidar_ros2::RangeImageHeader header;
+  Stats encode_ns;
+  Stats decode_ns;
+  size_t bins = 0;
+  size_t bytes = 0;
+  size_t mismatches = 0;
+  double max_error = 0.0;
+
+  for (size_t i = 0; i < scans.size(); i++) {
+    const LaserScan &scan = scans[i];
+    uint64_t t0 = threadCpuNs();
+    ydlidar_ros2::encodeRangeImage(scan, resolution, encoded);
+    uint64_t t1 = threadCpuNs();
+
+    if (!ydlidar_ros2::decodeRangeImage(encoded.data(), encoded.size(), header,
+                                        decoded)) {
+      fprintf(stderr, "Scan %zu: fail to decode\n", i);
+      mismatches++;
+      continue;
+    }
+
+    uint64_t t2 = threadCpuNs();
+    expectedRanges(scan, resolution, expected);
+
+    if (decoded.size() != expected.size()) {
+      fprintf(stderr, "Scan %zu: %zu ranges decoded, %zu expected\n", i,
+              decoded.size(), expected.size());
+      mismatches++;
+      continue;
+    }
+
+    for (size_t j = 0; j < expected.size(); j++) {
+      double e = fabs(double(decoded[j]) - expected[j]);
+
+      //量化误差不超过半个分辨率
+      if ((expected[j] == 0.0f) != (decoded[j] == 0.0f) ||
+          e > resolution * 0.5 + 1e-6) {
+        mismatches++;
+      } else {
+        max_error = std::max(max_error, e);
+      }
+    }
+
+    bins += expected.size();
+    bytes += encoded.size();
+    encode_ns.add(double(t1 - t0) / expected.size());
+    decode_ns.add(double(t2 - t1) / expected.size());
+  }
+
+  printf("Range image %zu scans, %zu ranges, resolution %.4f m, lz4 %s\n",
+         scans.size(), bins, resolution,
+         ydlidar_ros2::rangeImageHasLz4() ? "on" : "off");
+  encode_ns.print("encode per range", "ns");
+  decode_ns.print("decode per range", "ns");
+  printf("  %.2f bytes per range (float ranges: 4), max error %.2e m, "
+         "%zu mismatches\n", bins ? double(bytes) / bins : 0.0, max_error,
+         mismatches);
+  return mismatches ? 1 : 0;
+}
@@ -0,0 +1,102 @@
+/*
+ *  YDLIDAR SYSTEM
+ *  YDLIDAR SDK benchmarks
+ *
+ *  Copyright 2017 - 2020 EAI TEAM
+ *  http://www.eaibot.com
+ *
+ */
+
+/*
+ * 回放抓包文件（capture_file参数录制），经过 CYdLidar 完整链路：
+ * 驱动线程解析数据包，调用线程执行 doProcessSimple 转换。
+ *
+ *   replay_benchmark <capture> [name:=value ...]
+ *   replay_benchmark /tmp/syn.cap synthesize:=100     先合成100圈数据再回放
+ *
+ * 雷达参数名与params/ydlidar.yaml一致，默认值也与其相同。
+ * 默认按录制时的节奏回放：turnOn 要等新的一圈数据，一次性回放时
+ * 数据在启动完成前就已读完。统计的是CPU时间，与回放节奏无关，
+ * doProcessSimple 按调用线程的CPU时间统计，等待一圈数据就绪的时间不计入。
+ */
+
+#include "bench_common.h"
+
+using namespace bench;
+
+int main(int argc, char **argv) {
+  Options opt(argc, argv);
+
+  std::string capture;
+
+  if (!prepareCapture(argc, argv, opt, capture)) {
+    return 1;
+  }
+
+  ydlidar::os_init();
+  CYdLidar laser;
+  setupReplay(laser, capture, opt);
+
+  const uint64_t start_cpu = processCpuNs();
+  const uint64_t start = nowNs();
+
+  if (!laser.initialize() || !laser.turnOn()) {
+    fprintf(stderr, "Fail to start replay of %s\n", capture.c_str());
+    return 1;
+  }
+
+  const uint64_t ready = nowNs();
+  uint64_t main_cpu = threadCpuNs();
+  Stats process_cpu;
+  Stats process_wall;
+  Stats point_cpu;
+  size_t scans = 0;
+  size_t points = 0;
+  uint64_t last = ready;
+  LaserScan scan;
+
+  while (ydlidar::os_isOk()) {
+    uint64_t t0 = nowNs();
+    uint64_t c0 = threadCpuNs();
+
+    //数据回放完后等待超时返回false
+    if (!laser.doProcessSimple(scan)) {
+      break;
+    }
+
+    uint64_t c1 = threadCpuNs();
+    last = nowNs();
+    process_cpu.add((c1 - c0) / 1e3);
+    process_wall.add((last - t0) / 1e3);
+
+    if (!scan.points.empty()) {
+      point_cpu.add(double(c1 - c0) / scan.points.size());
+    }
+
+    scans++;
+    points += scan.points.size();
+  }
+
+  main_cpu = threadCpuNs() - main_cpu;
+  const uint64_t total_cpu = processCpuNs() - start_cpu;
+  laser.turnOff();
+  laser.disconnecting();
+
+  printf("Replay %s\n", capture.c_str());
+  printf("  bring-up %.1f ms, %zu scans, %zu points in %.1f ms\n",
+         (ready - start) / 1e6, scans, points, (last - ready) / 1e6);
+  printf("doProcessSimple (caller thread)\n");
+  process_cpu.print("cpu per scan", "us");
+  process_wall.print("wall per scan", "us");
+  point_cpu.print("cpu per point", "ns");
+  //调用线程之外的CPU时间主要是驱动线程的解析
+  printf("Other threads (driver parsing, bring-up included)\n");
+  printf("  cpu %.1f ms", (total_cpu - main_cpu) / 1e6);
+
+  if (points) {
+    printf(", %.1f ns per delivered point", double(total_cpu - main_cpu) / points);
+  }
+
+  printf("\n");
+  return scans ? 0 : 1;
+}
@@ -28,6 +28,7 @@ import os
 def generate_launch_description():
     share_dir = get_package_share_directory('ydlidar')
     parameter_file = LaunchConfiguration('params_file')
+    laser_odom = LaunchConfiguration('laser_odom')
     node_name = 'ydlidar_node'
 
     params_declare = DeclareLaunchArgument('params_file',
@@ -35,15 +36,21 @@ def generate_launch_description():
                                                share_dir, 'params', 'ydlidar.yaml'),
                                            description='FPath to the ROS2 parameters file to use.')
 
+    # 覆盖参数文件中的laser_odom，供bringup按odom_source打开激光里程计
+    laser_odom_declare = DeclareLaunchArgument('laser_odom',
+                                               default_value='false',
+                                               description='Publish laser odometry on laser_odom.')
+
     driver_node = LifecycleNode(package='ydlidar',
                                 executable='ydlidar_node',
                                 name='ydlidar_node',
                                 output='screen',
                                 emulate_tty=True,
-                                parameters=[parameter_file],
+                                parameters=[parameter_file, {'laser_odom': laser_odom}],
                                 namespace='/',
                                 )
     return LaunchDescription([
         params_declare,
+        laser_odom_declare,
         driver_node,
     ])
@@ -0,0 +1,152 @@
+#include "clocksync.h"
+#include <math.h>
+
+namespace ydlidar
+{
+  namespace core
+  {
+    namespace base
+    {
+
+      //观测权重衰减系数，约200个观测的有效窗口
+      static const double FORGET = 0.995;
+      //残差超过该倍数标准差的迟到观测视为异常
+      static const double OUTLIER_SIGMA = 4.0;
+      //异常判定的最小阈值（纳秒）
+      static const double OUTLIER_MIN = 500e3;
+      //残差超过该值（纳秒）认为时钟跳变，重新建模
+      static const double RESET_LIMIT = 1e9;
+      //连续拒绝该次数后重新建模
+      static const int RESET_REJECTS = 32;
+
+      ClockSync::ClockSync()
+        : m_nominal(0.0)
+      {
+        reset();
+      }
+
+      void ClockSync::reset()
+      {
+        m_tick0 = 0;
+        m_time0 = 0;
+        m_sw = m_sx = m_sy = m_sxx = m_sxy = 0.0;
+        m_period = m_nominal;
+        m_offset = 0.0;
+        m_floor = 0.0;
+        m_var = 0.0;
+        m_count = 0;
+        m_rejects = 0;
+      }
+
+      void ClockSync::setNominalPeriod(double period)
+      {
+        m_nominal = period;
+        reset();
+      }
+
+      void ClockSync::start(uint64_t tick, uint64_t time)
+      {
+        reset();
+        m_tick0 = tick;
+        m_time0 = time;
+        m_sw = 1.0;
+        m_count = 1;
+      }
+
+      bool ClockSync::update(uint64_t tick, uint64_t time)
+      {
+        if (!m_count)
+        {
+          start(tick, time);
+          return true;
+        }
+
+        double x = double(int64_t(tick - m_tick0));
+        double y = double(int64_t(time - m_time0));
+        double r = y - (m_offset + m_period * x);
+
+        //计数回退或时间跳变
+        if (x < 0.0 || fabs(r) > RESET_LIMIT)
+        {
+          start(tick, time);
+          return true;
+        }
+
+        double limit = OUTLIER_SIGMA * sqrt(m_var);
+        if (limit < OUTLIER_MIN)
+          limit = OUTLIER_MIN;
+
+        //只拒绝迟到的观测，提前的观测说明延时更小
+        if (r > limit)
+        {
+          if (++m_rejects >= RESET_REJECTS)
+          {
+            start(tick, time);
+            return true;
+          }
+          return false;
+        }
+
+        m_rejects = 0;
+        m_var = FORGET * m_var + (1.0 - FORGET) * r * r;
+
+        //原点移到当前观测
+        double sx = m_sx;
+        double sy = m_sy;
+        m_sx = sx - m_sw * x;
+        m_sy = sy - m_sw * y;
+        m_sxx += -2.0 * x * sx + m_sw * x * x;
+        m_sxy += -x * sy - y * sx + m_sw * x * y;
+        m_tick0 = tick;
+        m_time0 = time;
+        //原直线在新原点处的值
+        double shifted = -r;
+
+        //衰减后加入当前观测（位于原点）
+        m_sw = FORGET * m_sw + 1.0;
+        m_sx *= FORGET;
+        m_sy *= FORGET;
+        m_sxx *= FORGET;
+        m_sxy *= FORGET;
+        m_count++;
+
+        double mx = m_sx / m_sw;
+        double my = m_sy / m_sw;
+        double cxx = m_sxx / m_sw - mx * mx;
+        double cxy = m_sxy / m_sw - mx * my;
+        double period = m_nominal;
+
+        //观测跨度足够时才使用拟合的斜率，且不能偏离标称值太多
+        if (cxx > 100.0 * 100.0)
+        {
+          period = cxy / cxx;
+          if (m_nominal > 0.0 &&
+              (period < 0.5 * m_nominal || period > 2.0 * m_nominal))
+            period = m_nominal;
+        }
+
+        double offset = my - period * mx;
+        //直线变化后下包络随之平移，并缓慢上浮以跟随延时变化
+        m_floor += shifted - offset + 0.01 * sqrt(m_var);
+        //当前观测的残差
+        if (-offset < m_floor)
+          m_floor = -offset;
+        m_period = period;
+        m_offset = offset;
+
+        return true;
+      }
+
+      uint64_t ClockSync::toTime(uint64_t tick) const
+      {
+        if (!m_count)
+          return 0;
+
+        double x = double(int64_t(tick - m_tick0));
+        double t = m_offset + m_floor + m_period * x;
+        return m_time0 + int64_t(llround(t));
+      }
+
+    } // base
+  }   // core
+} // ydlidar
@@ -0,0 +1,74 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ydlidar
+{
+  namespace core
+  {
+    namespace base
+    {
+
+      /**
+       * @brief Linear model between a device tick counter and a time base.
+       * @note Observations are the time a tick was seen at, which is never
+       * earlier than when it happened and often later (transfer, buffering,
+       * scheduling). The model is an exponentially weighted least squares
+       * line through the accepted observations, shifted down to their lower
+       * envelope, so ::toTime() gives the time the tick happened plus the
+       * smallest observed latency. Late observations beyond a few standard
+       * deviations are rejected; a persistent jump resets the model.
+       */
+      class ClockSync
+      {
+      public:
+        ClockSync();
+
+        /// Forget every observation, keep the nominal period.
+        void reset();
+
+        /**
+         * @brief Set the nominal tick period and reset the model.
+         * @param period nanoseconds per tick, used until enough
+         * observations span a fit
+         */
+        void setNominalPeriod(double period);
+
+        /**
+         * @brief Add an observation.
+         * @param tick device tick
+         * @param time time the tick was seen at, in nanoseconds
+         * @return false if rejected as an outlier
+         */
+        bool update(uint64_t tick, uint64_t time);
+
+        /// Estimated time of tick in nanoseconds, 0 before any observation.
+        uint64_t toTime(uint64_t tick) const;
+
+        /// Fitted nanoseconds per tick.
+        double period() const { return m_period; }
+
+        /// Whether at least one observation has been accepted.
+        bool isValid() const { return m_count > 0; }
+
+      private:
+        void start(uint64_t tick, uint64_t time);
+
+        double m_nominal;
+        //坐标原点为最近一次接受的观测，避免大数相减丢失精度
+        uint64_t m_tick0;
+        uint64_t m_time0;
+        //相对原点的加权累加量
+        double m_sw, m_sx, m_sy, m_sxx, m_sxy;
+        //拟合直线：time = time0 + offset + period * (tick - tick0)
+        double m_period;
+        double m_offset;
+        double m_floor; //残差下包络（最小延时）
+        double m_var; //残差方差
+        size_t m_count;
+        int m_rejects; //连续拒绝次数
+      };
+
+    } // base
+  }   // core
+} // ydlidar
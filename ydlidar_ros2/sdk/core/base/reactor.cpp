@@ -0,0 +1,334 @@
+#include "reactor.h"
+#if defined(__linux__)
+#include <errno.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include "timer.h"
+
+namespace ydlidar
+{
+  namespace core
+  {
+    namespace base
+    {
+
+      static const size_t NO_WAITER = size_t(-1);
+
+      //////////////////////////////////////////////////////////////////////
+      // IoStream
+      //////////////////////////////////////////////////////////////////////
+      IoStream::IoStream(int fd, bool isSocket, size_t capacity)
+        : m_fd(fd),
+          m_isSocket(isSocket),
+          m_ring(capacity),
+          m_want(NO_WAITER),
+          m_closed(false),
+          m_stalled(false),
+          m_event(true, false)
+      {
+      }
+
+      size_t IoStream::read(uint8_t *data, size_t size)
+      {
+        size_t n = m_ring.read(data, size);
+
+        //缓存腾出空间后通知反应器继续接收
+        if (n && m_stalled.load(std::memory_order_acquire))
+          IoReactor::instance().wakeup();
+
+        return n;
+      }
+
+      void IoStream::clear()
+      {
+        m_ring.clear();
+
+        if (m_stalled.load(std::memory_order_acquire))
+          IoReactor::instance().wakeup();
+      }
+
+      int IoStream::waitfordata(size_t data_count, uint32_t timeout,
+                                size_t *returned_size)
+      {
+        size_t length = 0;
+
+        if (returned_size == NULL)
+          returned_size = &length;
+
+        //超过缓存容量的请求在缓存满时返回
+        size_t want = data_count;
+        if (want > m_ring.capacity())
+          want = m_ring.capacity();
+
+        uint32_t st = getms();
+
+        while (true)
+        {
+          *returned_size = m_ring.size();
+
+          if (*returned_size >= want)
+            return 0;
+
+          if (isClosed())
+            return -2;
+
+          uint32_t wt = getms() - st;
+
+          if (wt >= timeout)
+            return -1;
+
+          //登记等待字节数后再检查一次，避免错过反应器的通知
+          m_want.store(want, std::memory_order_seq_cst);
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+
+          if (m_ring.size() < want && !isClosed())
+            m_event.wait(timeout - wt);
+
+          m_want.store(NO_WAITER, std::memory_order_relaxed);
+        }
+      }
+
+      //////////////////////////////////////////////////////////////////////
+      // IoReactor
+      //////////////////////////////////////////////////////////////////////
+      IoReactor &IoReactor::instance()
+      {
+        //不随静态对象析构，避免退出时仍有串口在使用
+        static IoReactor *reactor = new IoReactor();
+        return *reactor;
+      }
+
+      IoReactor::IoReactor()
+        : m_epoll(-1),
+          m_wakeup(-1),
+          m_running(false),
+          m_thread(NULL),
+          m_nextId(1)
+      {
+      }
+
+      IoReactor::~IoReactor()
+      {
+        if (m_thread)
+        {
+          m_running = false;
+          wakeup();
+          m_thread->join();
+          delete m_thread;
+          m_thread = NULL;
+        }
+
+        for (std::map<uint64_t, IoStream *>::iterator it = m_streams.begin();
+             it != m_streams.end(); ++it)
+        {
+          delete it->second;
+        }
+        m_streams.clear();
+
+        if (m_wakeup != -1)
+          ::close(m_wakeup);
+        if (m_epoll != -1)
+          ::close(m_epoll);
+      }
+
+      bool IoReactor::start()
+      {
+        if (m_thread)
+          return true;
+
+        m_epoll = epoll_create1(EPOLL_CLOEXEC);
+        m_wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        if (m_epoll == -1 || m_wakeup == -1)
+        {
+          fprintf(stderr, "[YDLIDAR] Fail to create io reactor\n");
+          fflush(stderr);
+          return false;
+        }
+
+        epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.u64 = 0; //0号为唤醒事件
+        epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wakeup, &ev);
+
+        m_running = true;
+        m_thread = new std::thread(&IoReactor::run, this);
+        return true;
+      }
+
+      IoStream *IoReactor::attach(int fd, bool isSocket, size_t capacity)
+      {
+        ScopedLocker l(m_lock);
+
+        if (fd < 0 || !start())
+          return NULL;
+
+        IoStream *stream = new IoStream(fd, isSocket, capacity);
+        uint64_t id = m_nextId++;
+        epoll_event ev;
+        ev.events = EPOLLIN | EPOLLET;
+        ev.data.u64 = id;
+
+        if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &ev) != 0)
+        {
+          delete stream;
+          return NULL;
+        }
+
+        m_streams[id] = stream;
+        return stream;
+      }
+
+      void IoReactor::detach(IoStream *stream)
+      {
+        if (!stream)
+          return;
+
+        ScopedLocker l(m_lock);
+
+        for (std::map<uint64_t, IoStream *>::iterator it = m_streams.begin();
+             it != m_streams.end(); ++it)
+        {
+          if (it->second == stream)
+          {
+            epoll_ctl(m_epoll, EPOLL_CTL_DEL, stream->m_fd, NULL);
+            m_streams.erase(it);
+            break;
+          }
+        }
+
+        delete stream;
+      }
+
+      void IoReactor::wakeup()
+      {
+        if (m_wakeup != -1)
+        {
+          uint64_t one = 1;
+          ssize_t r = ::write(m_wakeup, &one, sizeof(one));
+          (void)r;
+        }
+      }
+
+      void IoReactor::drain(IoStream *stream)
+      {
+        bool closed = false;
+
+        while (true)
+        {
+          size_t size = 0;
+          uint8_t *data = stream->m_ring.writePtr(size);
+
+          if (size == 0)
+          {
+            stream->m_stalled.store(true, std::memory_order_release);
+            break;
+          }
+
+          ssize_t r = stream->m_isSocket ?
+                      recv(stream->m_fd, data, size, MSG_DONTWAIT) :
+                      ::read(stream->m_fd, data, size);
+
+          if (r > 0)
+          {
+            stream->m_ring.commit(size_t(r));
+
+            //没读满说明内核缓存已取空，新数据到达时epoll会再次通知
+            if (size_t(r) < size)
+              break;
+
+            continue;
+          }
+
+          if (r == 0)
+          {
+            //串口(VMIN=0)读到0表示无数据，套接字读到0表示对端关闭
+            closed = stream->m_isSocket;
+            break;
+          }
+
+          if (errno == EINTR)
+            continue;
+
+          if (errno != EAGAIN && errno != EWOULDBLOCK)
+            closed = true;
+
+          break;
+        }
+
+        if (closed)
+          stream->m_closed.store(true, std::memory_order_release);
+
+        //只在数据量达到消费者等待的字节数时唤醒
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (closed ||
+            stream->m_ring.size() >= stream->m_want.load(std::memory_order_relaxed))
+          stream->m_event.set();
+      }
+
+      void IoReactor::run()
+      {
+        epoll_event events[16];
+
+        while (m_running)
+        {
+          int n = epoll_wait(m_epoll, events, 16, -1);
+
+          if (n < 0)
+          {
+            if (errno == EINTR)
+              continue;
+
+            break;
+          }
+
+          ScopedLocker l(m_lock);
+
+          for (int i = 0; i < n; ++i)
+          {
+            uint64_t id = events[i].data.u64;
+
+            if (id == 0)
+            {
+              uint64_t count = 0;
+              ssize_t r = ::read(m_wakeup, &count, sizeof(count));
+              (void)r;
+
+              //恢复缓存满时暂停接收的数据流
+              for (std::map<uint64_t, IoStream *>::iterator it = m_streams.begin();
+                   it != m_streams.end(); ++it)
+              {
+                if (it->second->m_stalled.exchange(false))
+                  drain(it->second);
+              }
+
+              continue;
+            }
+
+            std::map<uint64_t, IoStream *>::iterator it = m_streams.find(id);
+
+            if (it == m_streams.end())
+              continue;
+
+            IoStream *stream = it->second;
+            drain(stream);
+
+            if (events[i].events & (EPOLLHUP | EPOLLERR))
+            {
+              //设备拔出或连接断开
+              epoll_ctl(m_epoll, EPOLL_CTL_DEL, stream->m_fd, NULL);
+              stream->m_closed.store(true, std::memory_order_release);
+              stream->m_event.set();
+            }
+          }
+        }
+      }
+
+    } // base
+  }   // core
+} // ydlidar
+#endif
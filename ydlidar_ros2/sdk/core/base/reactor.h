@@ -0,0 +1,116 @@
+#pragma once
+#if defined(__linux__)
+#include <stdio.h>
+#include <atomic>
+#include <map>
+#include <thread>
+#include "locker.h"
+#include "ringbuffer.h"
+
+namespace ydlidar
+{
+  namespace core
+  {
+    namespace base
+    {
+
+      class IoReactor;
+
+      /**
+       * @brief Receive side of a file descriptor served by ::IoReactor.
+       * @note The reactor thread drains the descriptor into a lock-free
+       * ring as soon as epoll reports it readable; the owner reads from
+       * the ring and only sleeps until the byte count it asked for has
+       * arrived. There is exactly one consumer per stream.
+       */
+      class IoStream
+      {
+      public:
+        /// Buffered byte count.
+        size_t available() const { return m_ring.size(); }
+
+        /// Copy out up to size buffered bytes, never blocks.
+        size_t read(uint8_t *data, size_t size);
+
+        /**
+         * @brief Wait until data_count bytes are buffered.
+         * @retval 0   enough data
+         * @retval -1  timeout
+         * @retval -2  descriptor closed or failed
+         */
+        int waitfordata(size_t data_count, uint32_t timeout,
+                        size_t *returned_size = NULL);
+
+        /// Drop every buffered byte.
+        void clear();
+
+        /// Whether the peer closed or the descriptor failed.
+        bool isClosed() const { return m_closed.load(std::memory_order_acquire); }
+
+      private:
+        friend class IoReactor;
+        IoStream(int fd, bool isSocket, size_t capacity);
+
+        int m_fd;
+        bool m_isSocket;
+        ByteRing m_ring;
+        std::atomic<size_t> m_want; //消费者等待的字节数
+        std::atomic<bool> m_closed;
+        std::atomic<bool> m_stalled; //缓存满，等待消费者读取后继续接收
+        Event m_event;
+      };
+
+      /**
+       * @brief One epoll thread serving the receive side of every serial
+       * port and TCP channel in the process.
+       * @note The thread is started by the first ::attach() and lives
+       * until the process exits.
+       */
+      class IoReactor
+      {
+      public:
+        static IoReactor &instance();
+
+        /**
+         * @brief Start receiving fd in the reactor thread.
+         * @param fd descriptor, tty descriptors must be non-blocking
+         * @param isSocket receive with MSG_DONTWAIT instead of read()
+         * @param capacity receive ring size
+         * @return stream or NULL on failure
+         */
+        IoStream *attach(int fd, bool isSocket = false,
+                         size_t capacity = 64 * 1024);
+
+        /**
+         * @brief Stop receiving and free the stream.
+         * @note Call before closing the descriptor; the stream must no
+         * longer be in use by its consumer.
+         */
+        void detach(IoStream *stream);
+
+        /// Wake the reactor thread to resume a stalled stream.
+        void wakeup();
+
+      private:
+        IoReactor();
+        ~IoReactor();
+        IoReactor(const IoReactor &);
+        IoReactor &operator=(const IoReactor &);
+
+        bool start();
+        void run();
+        void drain(IoStream *stream);
+
+        int m_epoll;
+        int m_wakeup;
+        std::atomic<bool> m_running;
+        std::thread *m_thread;
+        uint64_t m_nextId;
+        std::map<uint64_t, IoStream *> m_streams;
+        Locker m_lock;
+      };
+
+    } // base
+  }   // core
+} // ydlidar
+#endif
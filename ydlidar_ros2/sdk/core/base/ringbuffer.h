@@ -0,0 +1,138 @@
+#pragma once
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace ydlidar
+{
+  namespace core
+  {
+    namespace base
+    {
+
+      /**
+       * @brief Lock-free single producer / single consumer byte ring.
+       * @note Head and tail are free running counters, the capacity is
+       * rounded up to a power of two so wrapping is a mask. Only the
+       * producer may call ::write(), only the consumer ::read() and
+       * ::clear().
+       */
+      class ByteRing
+      {
+      public:
+        explicit ByteRing(size_t capacity = 0)
+          : m_data(NULL), m_mask(0), m_head(0), m_tail(0)
+        {
+          reserve(capacity);
+        }
+
+        ~ByteRing()
+        {
+          delete[] m_data;
+        }
+
+        /// Allocate storage. Not thread safe.
+        void reserve(size_t capacity)
+        {
+          size_t size = 1;
+          while (size < capacity)
+            size <<= 1;
+          if (capacity == 0 || size - 1 == m_mask)
+            return;
+          delete[] m_data;
+          m_data = new uint8_t[size];
+          m_mask = size - 1;
+          m_head.store(0, std::memory_order_relaxed);
+          m_tail.store(0, std::memory_order_relaxed);
+        }
+
+        size_t capacity() const { return m_data ? m_mask + 1 : 0; }
+
+        /// Readable byte count.
+        size_t size() const
+        {
+          return m_tail.load(std::memory_order_acquire) -
+                 m_head.load(std::memory_order_acquire);
+        }
+
+        /// Writable byte count.
+        size_t space() const { return capacity() - size(); }
+
+        /**
+         * @brief Producer side: contiguous writable region.
+         * @note Fill it and hand it over with ::commit().
+         */
+        uint8_t *writePtr(size_t &size)
+        {
+          size_t tail = m_tail.load(std::memory_order_relaxed);
+          size_t free = capacity() - (tail - m_head.load(std::memory_order_acquire));
+          size_t offset = tail & m_mask;
+          size_t contiguous = capacity() - offset;
+          size = free < contiguous ? free : contiguous;
+          return m_data + offset;
+        }
+
+        /// Producer side: publish bytes written through ::writePtr().
+        void commit(size_t size)
+        {
+          m_tail.store(m_tail.load(std::memory_order_relaxed) + size,
+                       std::memory_order_release);
+        }
+
+        /// Producer side: copy in as many bytes as fit.
+        size_t write(const uint8_t *data, size_t size)
+        {
+          size_t done = 0;
+          while (done < size)
+          {
+            size_t n = 0;
+            uint8_t *dst = writePtr(n);
+            if (n == 0)
+              break;
+            if (n > size - done)
+              n = size - done;
+            memcpy(dst, data + done, n);
+            commit(n);
+            done += n;
+          }
+          return done;
+        }
+
+        /// Consumer side: copy out up to size bytes.
+        size_t read(uint8_t *data, size_t size)
+        {
+          size_t head = m_head.load(std::memory_order_relaxed);
+          size_t avail = m_tail.load(std::memory_order_acquire) - head;
+          if (size > avail)
+            size = avail;
+          size_t offset = head & m_mask;
+          size_t first = capacity() - offset;
+          if (first > size)
+            first = size;
+          memcpy(data, m_data + offset, first);
+          memcpy(data + first, m_data, size - first);
+          m_head.store(head + size, std::memory_order_release);
+          return size;
+        }
+
+        /// Consumer side: drop every readable byte.
+        void clear()
+        {
+          m_head.store(m_tail.load(std::memory_order_acquire),
+                       std::memory_order_release);
+        }
+
+      private:
+        ByteRing(const ByteRing &);
+        ByteRing &operator=(const ByteRing &);
+
+        uint8_t *m_data;
+        size_t m_mask;
+        std::atomic<size_t> m_head; //consumer position
+        std::atomic<size_t> m_tail; //producer position
+      };
+
+    } // base
+  }   // core
+} // ydlidar
@@ -0,0 +1,307 @@
+#include "trace.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(_WIN32)
+#include <io.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+namespace ydlidar
+{
+  namespace core
+  {
+    namespace base
+    {
+
+      std::atomic<int> Trace::s_state(0);
+
+      namespace
+      {
+        struct TraceEvent
+        {
+          const char *name;
+          uint64_t ts; //ns
+          char ph;
+        };
+
+        /// Single producer (the owning thread) / single consumer (the
+        /// flusher) event ring.
+        struct TraceRing
+        {
+          TraceEvent events[TRACE_RING_SIZE];
+          std::atomic<size_t> head;
+          std::atomic<size_t> tail;
+          std::atomic<size_t> dropped;
+          std::atomic<bool> retired; //线程已退出，取空后释放
+          uint32_t tid;
+
+          TraceRing() : head(0), tail(0), dropped(0), retired(false), tid(0) {}
+        };
+
+        static_assert((TRACE_RING_SIZE & (TRACE_RING_SIZE - 1)) == 0,
+                      "TRACE_RING_SIZE must be a power of two");
+
+        uint64_t traceNow()
+        {
+          //steady_clock在Linux上即CLOCK_MONOTONIC，与UI进程的时间戳一致
+          return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        uint32_t traceTid()
+        {
+#if defined(__linux__)
+          return static_cast<uint32_t>(syscall(SYS_gettid));
+#else
+          static std::atomic<uint32_t> next(1);
+          return next.fetch_add(1);
+#endif
+        }
+
+        class Tracer
+        {
+        public:
+          static Tracer &instance()
+          {
+            static Tracer tracer;
+            return tracer;
+          }
+
+          bool open(const char *path)
+          {
+#if defined(_WIN32)
+            m_fd = _open(path, _O_WRONLY | _O_CREAT | _O_EXCL | _O_APPEND, 0644);
+            if (m_fd >= 0)
+              _write(m_fd, "[\n", 2);
+            else
+              m_fd = _open(path, _O_WRONLY | _O_APPEND);
+#else
+            //首个打开文件的写入者写数组开头，之后都只追加，结尾的]可省略
+            m_fd = ::open(path, O_WRONLY | O_CREAT | O_EXCL | O_APPEND | O_CLOEXEC, 0644);
+            if (m_fd >= 0)
+            {
+              if (::write(m_fd, "[\n", 2) < 0)
+                perror("trace");
+            }
+            else if (errno == EEXIST)
+              m_fd = ::open(path, O_WRONLY | O_APPEND | O_CLOEXEC);
+#endif
+            if (m_fd < 0)
+            {
+              fprintf(stderr, "[YDLIDAR] Failed to open trace file %s\n", path);
+              return false;
+            }
+
+#if defined(_WIN32)
+            m_pid = _getpid();
+#else
+            m_pid = getpid();
+#endif
+            m_thread = std::thread(&Tracer::run, this);
+            return true;
+          }
+
+          void record(const char *name, char ph)
+          {
+            TraceRing *ring = localRing();
+            size_t tail = ring->tail.load(std::memory_order_relaxed);
+
+            if (tail - ring->head.load(std::memory_order_acquire) >= TRACE_RING_SIZE)
+            {
+              ring->dropped.fetch_add(1, std::memory_order_relaxed);
+              return;
+            }
+
+            TraceEvent &e = ring->events[tail & (TRACE_RING_SIZE - 1)];
+            e.name = name;
+            e.ts = traceNow();
+            e.ph = ph;
+            ring->tail.store(tail + 1, std::memory_order_release);
+          }
+
+          void flush()
+          {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_out.clear();
+
+            for (size_t i = 0; i < m_rings.size();)
+            {
+              TraceRing *ring = m_rings[i];
+              drain(ring);
+
+              if (ring->retired.load(std::memory_order_acquire) &&
+                  ring->head.load() == ring->tail.load())
+              {
+                delete ring;
+                m_rings[i] = m_rings.back();
+                m_rings.pop_back();
+                continue;
+              }
+
+              i++;
+            }
+
+            if (m_out.empty() || m_fd < 0)
+              return;
+
+            //整块一次写入，与其他写入者的追加不会交错
+#if defined(_WIN32)
+            _write(m_fd, m_out.data(), static_cast<unsigned>(m_out.size()));
+#else
+            if (::write(m_fd, m_out.data(), m_out.size()) < 0)
+              perror("trace");
+#endif
+          }
+
+          ~Tracer()
+          {
+            if (!m_thread.joinable())
+              return;
+
+            {
+              std::lock_guard<std::mutex> lock(m_stopLock);
+              m_stop = true;
+            }
+            m_stopCond.notify_all();
+            m_thread.join();
+            flush();
+#if defined(_WIN32)
+            _close(m_fd);
+#else
+            ::close(m_fd);
+#endif
+          }
+
+        private:
+          struct LocalRing
+          {
+            TraceRing *ring;
+            LocalRing() : ring(NULL) {}
+            ~LocalRing()
+            {
+              if (ring)
+                ring->retired.store(true, std::memory_order_release);
+            }
+          };
+
+          Tracer() : m_fd(-1), m_pid(0), m_stop(false) {}
+
+          TraceRing *localRing()
+          {
+            static thread_local LocalRing local;
+
+            if (!local.ring)
+            {
+              TraceRing *ring = new TraceRing;
+              ring->tid = traceTid();
+              std::lock_guard<std::mutex> lock(m_lock);
+              m_rings.push_back(ring);
+              local.ring = ring;
+            }
+
+            return local.ring;
+          }
+
+          void drain(TraceRing *ring)
+          {
+            size_t head = ring->head.load(std::memory_order_relaxed);
+            size_t tail = ring->tail.load(std::memory_order_acquire);
+            char line[256];
+
+            for (; head != tail; ++head)
+            {
+              const TraceEvent &e = ring->events[head & (TRACE_RING_SIZE - 1)];
+              int n = snprintf(line, sizeof(line),
+                               "{\"name\":\"%s\",\"ph\":\"%c\",%s\"ts\":%llu.%03u,"
+                               "\"pid\":%d,\"tid\":%u},\n",
+                               e.name, e.ph, e.ph == 'i' ? "\"s\":\"t\"," : "",
+                               (unsigned long long)(e.ts / 1000),
+                               (unsigned)(e.ts % 1000), m_pid, ring->tid);
+              m_out.append(line, n > 0 && n < (int)sizeof(line) ? n : 0);
+            }
+
+            ring->head.store(head, std::memory_order_release);
+
+            size_t dropped = ring->dropped.exchange(0, std::memory_order_relaxed);
+            if (dropped)
+              fprintf(stderr, "[YDLIDAR] Trace dropped %zu events on thread %u\n",
+                      dropped, ring->tid);
+          }
+
+          void run()
+          {
+            std::unique_lock<std::mutex> lock(m_stopLock);
+
+            while (!m_stop)
+            {
+              m_stopCond.wait_for(lock, std::chrono::seconds(1));
+              lock.unlock();
+              flush();
+              lock.lock();
+            }
+          }
+
+          int m_fd;
+          int m_pid;
+          std::mutex m_lock; //保护m_rings和输出缓存
+          std::vector<TraceRing *> m_rings;
+          std::string m_out;
+          std::thread m_thread;
+          std::mutex m_stopLock;
+          std::condition_variable m_stopCond;
+          bool m_stop;
+        };
+      } // namespace
+
+      bool Trace::init()
+      {
+        static std::once_flag once;
+        std::call_once(once, []()
+        {
+          const char *path = getenv(TRACE_FILE_ENV);
+          bool on = path && *path && Tracer::instance().open(path);
+          s_state.store(on ? 1 : -1, std::memory_order_release);
+        });
+        return s_state.load(std::memory_order_acquire) > 0;
+      }
+
+      void Trace::begin(const char *name)
+      {
+        if (enabled())
+          Tracer::instance().record(name, 'B');
+      }
+
+      void Trace::end(const char *name)
+      {
+        if (enabled())
+          Tracer::instance().record(name, 'E');
+      }
+
+      void Trace::instant(const char *name)
+      {
+        if (enabled())
+          Tracer::instance().record(name, 'i');
+      }
+
+      void Trace::flush()
+      {
+        if (enabled())
+          Tracer::instance().flush();
+      }
+
+    } // namespace base
+  } // namespace core
+} // namespace ydlidar
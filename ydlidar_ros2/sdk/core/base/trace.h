@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/// Environment variable naming the trace output file, tracing is off
+/// when it is unset.
+#define TRACE_FILE_ENV "PIPELINE_TRACE_FILE"
+/// Events buffered per thread between two flushes.
+#define TRACE_RING_SIZE 8192
+
+namespace ydlidar
+{
+  namespace core
+  {
+    namespace base
+    {
+
+      /**
+       * @brief Span tracing written as Chrome/Perfetto trace JSON.
+       * @note Each thread records into its own lock-free ring, a
+       * background thread appends the events to the file once per second.
+       * Timestamps are CLOCK_MONOTONIC and the file is only ever appended
+       * to, so other tracers writing the same file (the LVGL UI uses the
+       * same format) end up on one timeline. Events that do not fit in a
+       * ring before the next flush are dropped.
+       *
+       * Names are stored by pointer and must be string literals.
+       */
+      class Trace
+      {
+      public:
+        /// Whether tracing is on, the first call reads the environment.
+        static bool enabled()
+        {
+          int state = s_state.load(std::memory_order_relaxed);
+          return state > 0 || (state == 0 && init());
+        }
+
+        static void begin(const char *name);
+        static void end(const char *name);
+        /// Zero length event, e.g. a revolution completed.
+        static void instant(const char *name);
+
+        /// Write buffered events now.
+        static void flush();
+
+      private:
+        static bool init();
+        static std::atomic<int> s_state; //0未初始化 1开启 -1关闭
+      };
+
+      /// Records a span for the enclosing scope.
+      class TraceScope
+      {
+      public:
+        explicit TraceScope(const char *name)
+          : m_name(Trace::enabled() ? name : NULL)
+        {
+          if (m_name)
+            Trace::begin(m_name);
+        }
+
+        ~TraceScope()
+        {
+          if (m_name)
+            Trace::end(m_name);
+        }
+
+      private:
+        TraceScope(const TraceScope &);
+        TraceScope &operator=(const TraceScope &);
+
+        const char *m_name;
+      };
+
+    } // namespace base
+  } // namespace core
+} // namespace ydlidar
+
+#define YDLIDAR_TRACE_CAT2(a, b) a##b
+#define YDLIDAR_TRACE_CAT(a, b) YDLIDAR_TRACE_CAT2(a, b)
+/// Trace the enclosing scope under a string literal name.
+#define YDLIDAR_TRACE_SCOPE(name) \
+  ydlidar::core::base::TraceScope YDLIDAR_TRACE_CAT(ydlidar_trace_, __LINE__)(name)
@@ -0,0 +1,104 @@
+#pragma once
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ydlidar
+{
+  namespace core
+  {
+    namespace base
+    {
+
+      /**
+       * @brief Lock-free single producer / single consumer triple buffer.
+       * @note The producer fills ::back() in place and hands it over with
+       * ::publish(); the consumer takes the newest published slot with
+       * ::acquire(). Slots are exchanged by index, no data is copied and
+       * neither side ever blocks the other. A slot returned by ::acquire()
+       * stays valid until the next ::acquire() call.
+       * T is the slot type, it must provide reserve(size_t) and clear().
+       */
+      template <typename T>
+      class TripleBuffer
+      {
+      public:
+        explicit TripleBuffer(size_t capacity = 0)
+          : m_state(1), m_back(0), m_front(2)
+        {
+          reserve(capacity);
+        }
+
+        /**
+         * @brief Allocate slot storage.
+         * @note Not thread safe, call before the producer thread starts.
+         */
+        void reserve(size_t capacity)
+        {
+          for (int i = 0; i < SLOT_COUNT; ++i)
+            m_slots[i].reserve(capacity);
+          clear();
+        }
+
+        /// Producer side: slot currently being filled.
+        T &back() { return m_slots[m_back]; }
+
+        /// Producer side: hand the filled slot to the consumer.
+        void publish()
+        {
+          uint8_t old = m_state.exchange(
+            uint8_t(m_back | FRESH_BIT), std::memory_order_acq_rel);
+          m_back = old & INDEX_MASK;
+        }
+
+        /// Whether a slot has been published since the last ::acquire().
+        bool hasUpdate() const
+        {
+          return (m_state.load(std::memory_order_acquire) & FRESH_BIT) != 0;
+        }
+
+        /**
+         * @brief Consumer side: take the newest published slot.
+         * @return false if nothing was published since the last call
+         */
+        bool acquire(const T *&data)
+        {
+          if (!hasUpdate())
+            return false;
+          uint8_t old = m_state.exchange(m_front, std::memory_order_acq_rel);
+          m_front = old & INDEX_MASK;
+          data = &m_slots[m_front];
+          return true;
+        }
+
+        /// Drop any pending slot. Not thread safe.
+        void clear()
+        {
+          m_back = 0;
+          m_state.store(1, std::memory_order_release);
+          m_front = 2;
+          for (int i = 0; i < SLOT_COUNT; ++i)
+            m_slots[i].clear();
+        }
+
+      private:
+        TripleBuffer(const TripleBuffer &);
+        TripleBuffer &operator=(const TripleBuffer &);
+
+        enum
+        {
+          SLOT_COUNT = 3,
+          INDEX_MASK = 0x03,
+          FRESH_BIT = 0x04,
+        };
+
+        /// index of the middle slot | FRESH_BIT if it holds unread data
+        std::atomic<uint8_t> m_state;
+        uint8_t m_back; //producer slot index
+        uint8_t m_front; //consumer slot index
+        T m_slots[SLOT_COUNT];
+      };
+
+    } // base
+  }   // core
+} // ydlidar
@@ -0,0 +1,448 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020 EAIBOT. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <core/common/ChannelCapture.h>
+#include <core/base/timer.h>
+#include <string.h>
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+using namespace base;
+
+static uint64_t monotonicUs() {
+#if defined(_WIN32)
+  return uint64_t(getms()) * 1000;
+#else
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return uint64_t(t.tv_sec) * 1000000 + t.tv_nsec / 1000;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ChannelRecorder
+//////////////////////////////////////////////////////////////////////////////
+ChannelRecorder::ChannelRecorder(ChannelDevice *device,
+                                 const std::string &file)
+  : m_device(device),
+    m_fileName(file),
+    m_file(NULL),
+    m_baudrate(0),
+    m_lastUs(0) {
+}
+
+ChannelRecorder::~ChannelRecorder() {
+  closePort();
+  delete m_device;
+  m_device = NULL;
+
+  ScopedLocker l(m_lock);
+
+  if (m_file) {
+    fclose(m_file);
+    m_file = NULL;
+  }
+}
+
+bool ChannelRecorder::bindport(const char *port, uint32_t baudrate) {
+  m_baudrate = baudrate;
+  return m_device->bindport(port, baudrate);
+}
+
+bool ChannelRecorder::open() {
+  if (!m_device->open()) {
+    return false;
+  }
+
+  ScopedLocker l(m_lock);
+
+  if (!m_file) {
+    //只追加：驱动重连时会重建通道，不能清掉之前录制的数据
+    m_file = fopen(m_fileName.c_str(), "a+b");
+
+    if (!m_file) {
+      fprintf(stderr, "[YDLIDAR] Fail to create capture file [%s]\n",
+              m_fileName.c_str());
+      fflush(stderr);
+      return true;
+    }
+
+    CaptureHeader header;
+    fseek(m_file, 0, SEEK_END);
+
+    if (ftell(m_file) == 0) {
+      memset(&header, 0, sizeof(header));
+      memcpy(header.magic, CAPTURE_MAGIC, sizeof(header.magic));
+      header.version = CAPTURE_VERSION;
+      header.baudrate = m_baudrate;
+      fwrite(&header, sizeof(header), 1, m_file);
+    } else {
+      //已有文件必须是同一格式，否则不录制，以免写坏
+      rewind(m_file);
+
+      if (fread(&header, sizeof(header), 1, m_file) != 1 ||
+          memcmp(header.magic, CAPTURE_MAGIC, sizeof(header.magic)) != 0 ||
+          header.version != CAPTURE_VERSION) {
+        fprintf(stderr, "[YDLIDAR] [%s] is not a capture file, not recording\n",
+                m_fileName.c_str());
+        fflush(stderr);
+        fclose(m_file);
+        m_file = NULL;
+        return true;
+      }
+
+      fseek(m_file, 0, SEEK_END);
+    }
+
+    fflush(m_file);
+  }
+
+  //重连期间的空档不计入时间间隔
+  m_lastUs = monotonicUs();
+  return true;
+}
+
+bool ChannelRecorder::isOpen() {
+  return m_device->isOpen();
+}
+
+void ChannelRecorder::closePort() {
+  if (m_device) {
+    m_device->closePort();
+  }
+
+  //文件保持打开，重新打开设备后继续追加
+  ScopedLocker l(m_lock);
+
+  if (m_file) {
+    fflush(m_file);
+  }
+}
+
+size_t ChannelRecorder::available() {
+  return m_device->available();
+}
+
+void ChannelRecorder::flush() {
+  m_device->flush();
+}
+
+int ChannelRecorder::waitfordata(size_t data_count, uint32_t timeout,
+                                 size_t *returned_size) {
+  return m_device->waitfordata(data_count, timeout, returned_size);
+}
+
+std::string ChannelRecorder::readSize(size_t size) {
+  std::string data = m_device->readSize(size);
+  record(reinterpret_cast<const uint8_t *>(data.data()), data.size());
+  return data;
+}
+
+size_t ChannelRecorder::writeData(const uint8_t *data, size_t size) {
+  return m_device->writeData(data, size);
+}
+
+size_t ChannelRecorder::readData(uint8_t *data, size_t size) {
+  size_t r = m_device->readData(data, size);
+
+  if (r != size_t(-1)) {
+    record(data, r);
+  }
+
+  return r;
+}
+
+bool ChannelRecorder::setDTR(bool level) {
+  return m_device->setDTR(level);
+}
+
+int ChannelRecorder::getByteTime() {
+  return m_device->getByteTime();
+}
+
+const char *ChannelRecorder::DescribeError() {
+  return m_device->DescribeError();
+}
+
+void ChannelRecorder::record(const uint8_t *data, size_t size) {
+  ScopedLocker l(m_lock);
+
+  if (!m_file) {
+    return;
+  }
+
+  while (size > 0) {
+    uint64_t now = monotonicUs();
+    uint32_t delta = uint32_t(now - m_lastUs);
+    uint16_t len = size > 0xFFFF ? 0xFFFF : uint16_t(size);
+    m_lastUs = now;
+
+    fwrite(&delta, sizeof(delta), 1, m_file);
+    fwrite(&len, sizeof(len), 1, m_file);
+    fwrite(data, 1, len, m_file);
+    data += len;
+    size -= len;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ChannelReplay
+//////////////////////////////////////////////////////////////////////////////
+ChannelReplay::ChannelReplay(bool realtime)
+  : m_realtime(realtime),
+    m_isOpen(false),
+    m_baudrate(0),
+    m_chunk(0),
+    m_readPos(0),
+    m_releasePos(0),
+    m_startUs(0),
+    m_error("No error") {
+}
+
+ChannelReplay::~ChannelReplay() {
+  closePort();
+}
+
+bool ChannelReplay::bindport(const char *port, uint32_t baudrate) {
+  m_fileName = port;
+  m_baudrate = baudrate;
+  return true;
+}
+
+bool ChannelReplay::open() {
+  ScopedLocker l(m_lock);
+
+  if (m_isOpen) {
+    return true;
+  }
+
+  FILE *fp = fopen(m_fileName.c_str(), "rb");
+
+  if (!fp) {
+    m_error = "Capture file is not found";
+    return false;
+  }
+
+  CaptureHeader header;
+
+  if (fread(&header, sizeof(header), 1, fp) != 1 ||
+      memcmp(header.magic, CAPTURE_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != CAPTURE_VERSION) {
+    fclose(fp);
+    m_error = "Invalid capture file";
+    return false;
+  }
+
+  if (header.baudrate) {
+    m_baudrate = header.baudrate;
+  }
+
+  m_data.clear();
+  m_chunkEnd.clear();
+  m_chunkUs.clear();
+  uint64_t us = 0;
+  uint32_t delta = 0;
+  uint16_t len = 0;
+
+  while (fread(&delta, sizeof(delta), 1, fp) == 1 &&
+         fread(&len, sizeof(len), 1, fp) == 1) {
+    size_t pos = m_data.size();
+    m_data.resize(pos + len);
+
+    if (len && fread(&m_data[pos], 1, len, fp) != len) {
+      m_data.resize(pos); //截断的记录
+      break;
+    }
+
+    us += delta;
+    m_chunkEnd.push_back(m_data.size());
+    m_chunkUs.push_back(us);
+  }
+
+  fclose(fp);
+
+  //从第一个数据块开始计时
+  if (!m_chunkUs.empty()) {
+    uint64_t first = m_chunkUs.front();
+
+    for (size_t i = 0; i < m_chunkUs.size(); ++i) {
+      m_chunkUs[i] -= first;
+    }
+  }
+
+  m_chunk = 0;
+  m_readPos = 0;
+  m_releasePos = 0;
+  m_startUs = monotonicUs();
+  m_isOpen = true;
+  m_error = "No error";
+  return true;
+}
+
+bool ChannelReplay::isOpen() {
+  return m_isOpen;
+}
+
+void ChannelReplay::closePort() {
+  ScopedLocker l(m_lock);
+  m_isOpen = false;
+}
+
+size_t ChannelReplay::update() {
+  uint64_t elapsed = m_realtime ? monotonicUs() - m_startUs : uint64_t(-1);
+
+  while (m_chunk < m_chunkEnd.size() && m_chunkUs[m_chunk] <= elapsed) {
+    m_releasePos = m_chunkEnd[m_chunk];
+    m_chunk++;
+  }
+
+  return m_releasePos - m_readPos;
+}
+
+size_t ChannelReplay::available() {
+  ScopedLocker l(m_lock);
+  return update();
+}
+
+void ChannelReplay::flush() {
+  //录制时已按真实时序保存，回放时保留所有数据供解析器重新同步
+}
+
+bool ChannelReplay::isEnd() {
+  ScopedLocker l(m_lock);
+  update();
+  return m_readPos >= m_data.size();
+}
+
+int ChannelReplay::waitfordata(size_t data_count, uint32_t timeout,
+                               size_t *returned_size) {
+  size_t length = 0;
+
+  if (returned_size == NULL) {
+    returned_size = &length;
+  }
+
+  *returned_size = 0;
+  uint32_t st = getms();
+
+  while (m_isOpen) {
+    uint64_t wait_us = 0;
+    {
+      ScopedLocker l(m_lock);
+      *returned_size = update();
+
+      if (*returned_size >= data_count) {
+        return 0;
+      }
+
+      if (m_chunk >= m_chunkEnd.size()) {
+        //已回放完所有数据
+        wait_us = uint64_t(-1);
+      } else {
+        wait_us = m_chunkUs[m_chunk] - (monotonicUs() - m_startUs);
+      }
+    }
+
+    uint32_t wt = getms() - st;
+
+    if (wt >= timeout) {
+      return -1;
+    }
+
+    uint64_t remain_us = uint64_t(timeout - wt) * 1000;
+
+    if (wait_us > remain_us) {
+      wait_us = remain_us;
+    }
+
+    if (wait_us < 100) {
+      wait_us = 100;
+    }
+
+#if defined(_WIN32)
+    delay(uint32_t(wait_us / 1000) + 1);
+#else
+    usleep(useconds_t(wait_us));
+#endif
+  }
+
+  return -2;
+}
+
+std::string ChannelReplay::readSize(size_t size) {
+  std::string data;
+  ScopedLocker l(m_lock);
+  size_t avail = update();
+
+  if (size > avail) {
+    size = avail;
+  }
+
+  if (size) {
+    data.assign(reinterpret_cast<const char *>(&m_data[m_readPos]), size);
+    m_readPos += size;
+  }
+
+  return data;
+}
+
+size_t ChannelReplay::writeData(const uint8_t *data, size_t size) {
+  UNUSED(data);
+  return m_isOpen ? size : 0;
+}
+
+size_t ChannelReplay::readData(uint8_t *data, size_t size) {
+  ScopedLocker l(m_lock);
+  size_t avail = update();
+
+  if (size > avail) {
+    size = avail;
+  }
+
+  if (size) {
+    memcpy(data, &m_data[m_readPos], size);
+    m_readPos += size;
+  }
+
+  return size;
+}
+
+int ChannelReplay::getByteTime() {
+  if (!m_baudrate) {
+    return 0;
+  }
+
+  //10 bits per byte in nanoseconds
+  return int(1e9 * 10 / m_baudrate);
+}
+
+const char *ChannelReplay::DescribeError() {
+  return m_error;
+}
+
+}//common
+}//core
+}//ydlidar
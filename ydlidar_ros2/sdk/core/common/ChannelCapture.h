@@ -0,0 +1,124 @@
+#pragma once
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <core/base/locker.h>
+#include "ChannelDevice.h"
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+/**
+ * @brief Raw byte stream capture file.
+ *
+ * The file starts with a ::CaptureHeader followed by one record per
+ * received chunk:
+ *  - uint32_t  microseconds since the previous chunk (monotonic clock)
+ *  - uint16_t  chunk size
+ *  - uint8_t   chunk data[size]
+ *
+ * All fields are little-endian. Chunks larger than 64 KiB are split.
+ * Recording appends to an existing capture file, so reconnects and
+ * restarts continue the same stream.
+ */
+struct CaptureHeader {
+  char magic[4];      ///< "YDCP"
+  uint16_t version;   ///< CAPTURE_VERSION
+  uint16_t reserved;
+  uint32_t baudrate;  ///< baudrate or network port of the captured device
+  uint32_t reserved2;
+} __attribute__((packed));
+
+#define CAPTURE_MAGIC "YDCP"
+#define CAPTURE_VERSION 1
+
+/**
+ * @brief Channel decorator that records every received chunk of the
+ * wrapped device to a capture file.
+ * @note The recorder takes ownership of the wrapped device.
+ */
+class ChannelRecorder : public ChannelDevice {
+ public:
+  ChannelRecorder(ChannelDevice *device, const std::string &file);
+  virtual ~ChannelRecorder();
+
+  virtual bool bindport(const char *port, uint32_t baudrate);
+  virtual bool open();
+  virtual bool isOpen();
+  virtual void closePort();
+  virtual size_t available();
+  virtual void flush();
+  virtual int waitfordata(size_t data_count, uint32_t timeout = -1,
+                          size_t *returned_size = NULL);
+  virtual std::string readSize(size_t size = 1);
+  virtual size_t writeData(const uint8_t *data, size_t size);
+  virtual size_t readData(uint8_t *data, size_t size);
+  virtual bool setDTR(bool level = true);
+  virtual int getByteTime();
+  virtual const char *DescribeError();
+
+ private:
+  void record(const uint8_t *data, size_t size);
+
+  ChannelDevice *m_device;
+  std::string m_fileName;
+  FILE *m_file;
+  uint32_t m_baudrate;
+  uint64_t m_lastUs;
+  base::Locker m_lock;
+};
+
+/**
+ * @brief Channel that feeds a capture file back to a driver.
+ * @note Bytes written by the driver are discarded, received bytes are
+ * released either at the recorded pace or all at once.
+ */
+class ChannelReplay : public ChannelDevice {
+ public:
+  explicit ChannelReplay(bool realtime = true);
+  virtual ~ChannelReplay();
+
+  /**
+   * @brief bind capture file
+   * @param port capture file path
+   */
+  virtual bool bindport(const char *port, uint32_t baudrate);
+  virtual bool open();
+  virtual bool isOpen();
+  virtual void closePort();
+  virtual size_t available();
+  virtual void flush();
+  virtual int waitfordata(size_t data_count, uint32_t timeout = -1,
+                          size_t *returned_size = NULL);
+  virtual std::string readSize(size_t size = 1);
+  virtual size_t writeData(const uint8_t *data, size_t size);
+  virtual size_t readData(uint8_t *data, size_t size);
+  virtual int getByteTime();
+  virtual const char *DescribeError();
+
+  /// Whether every recorded byte has been read.
+  bool isEnd();
+
+ private:
+  /// Release the chunks that are due and return the readable byte count.
+  size_t update();
+
+  std::string m_fileName;
+  bool m_realtime;
+  bool m_isOpen;
+  uint32_t m_baudrate;
+  std::vector<uint8_t> m_data;      ///< recorded bytes
+  std::vector<size_t> m_chunkEnd;   ///< end offset of each chunk
+  std::vector<uint64_t> m_chunkUs;  ///< release time of each chunk
+  size_t m_chunk;                   ///< next chunk to release
+  size_t m_readPos;                 ///< read offset
+  size_t m_releasePos;              ///< released offset
+  uint64_t m_startUs;
+  const char *m_error;
+  base::Locker m_lock;
+};
+
+}//common
+}//core
+}//ydlidar
@@ -4,8 +4,10 @@
 #include <core/base/v8stdint.h>
 #include <core/base/thread.h>
 #include <core/base/locker.h>
+#include <core/base/triplebuffer.h>
 #include <core/base/datatype.h>
 #include "ydlidar_protocol.h"
+#include "ScanNodes.h"
 #include "ydlidar_def.h"
 #include "ydlidar_config.h"
 
@@ -60,6 +62,10 @@ namespace ydlidar
         PropertyBuilderByName(bool, OtaEncode, protected);
         //是否启用自动强度判断
         PropertyBuilderByName(bool, AutoIntensity, protected);
+        //原始数据录制文件（为空时不录制）
+        PropertyBuilderByName(std::string, CaptureFile, protected);
+        //是否按录制时序回放
+        PropertyBuilderByName(bool, ReplayRealtime, protected);
 
         /**
          * @par Constructor
@@ -69,8 +75,6 @@ namespace ydlidar
                             m_baudrate(8000),
                             m_intensities(false),
                             m_intensityBit(10),
-                            scan_node_buf(NULL),
-                            scan_node_count(0),
                             nodeIndex(0),
                             retryCount(0),
                             isAutoReconnect(true),
@@ -96,6 +100,7 @@ namespace ydlidar
           m_Bottom = true;
           m_HasDeviceInfo = EPT_None;
           m_AutoIntensity = true;
+          m_ReplayRealtime = true;
         }
 
         virtual ~DriverInterface() {}
@@ -224,6 +229,14 @@ namespace ydlidar
         {
           m_intensityBit = bit;
         }
+        bool getIntensities() const
+        {
+          return m_intensities;
+        }
+        int getIntensityBit() const
+        {
+          return m_intensityBit;
+        }
 
         /**
          * @brief whether to support hot plug \n
@@ -326,7 +339,56 @@ namespace ydlidar
          * @note Before starting, you must start the start the scan successfully with the ::startScan function
          */
         virtual result_t grabScanData(node_info *nodebuffer, size_t &count,
-                                      uint32_t timeout = DEFAULT_TIMEOUT) = 0;
+                                      uint32_t timeout = DEFAULT_TIMEOUT)
+        {
+          const ScanNodes *scan = NULL;
+          size_t size = 0;
+          result_t ans = acquireScanData(scan, timeout);
+          if (IS_OK(ans))
+          {
+            size = std::min(count, scan->size());
+            for (size_t i = 0; i < size; ++i)
+              scan->get(i, nodebuffer[i]);
+          }
+          count = size;
+          return ans;
+        }
+
+        /**
+         * @brief Get a circle of laser data without copying it \n
+         * @param[out] scan    points to the newest circle of laser data,
+         * valid until the next ::acquireScanData or ::grabScanData call
+         * @param[in] timeout    timeout
+         * @return return status
+         * @retval RESULT_OK       success
+         * @retval RESULT_TIMEOUT  no data within timeout
+         * @retval RESULT_FAILE    failed
+         */
+        virtual result_t acquireScanData(const ScanNodes *&scan,
+                                         uint32_t timeout = DEFAULT_TIMEOUT)
+        {
+          uint32_t st = getms();
+          uint32_t wt = 0;
+          //最新一圈数据已就绪时直接交换，无需等待
+          while (!scan_node_buf.acquire(scan))
+          {
+            if ((wt = getms() - st) >= timeout)
+              return RESULT_TIMEOUT;
+            switch (_dataEvent.wait(timeout - wt))
+            {
+            case Event::EVENT_TIMEOUT:
+              return RESULT_TIMEOUT;
+            case Event::EVENT_OK:
+              //停止扫描时唤醒
+              if (!m_isScanning && !scan_node_buf.hasUpdate())
+                return RESULT_FAIL;
+              break;
+            default:
+              return RESULT_FAIL;
+            }
+          }
+          return RESULT_OK;
+        }
 
         /**
          * @brief Get lidar scan frequency \n
@@ -617,10 +679,8 @@ namespace ydlidar
         /// LiDAR intensity bit
         int m_intensityBit = 0;
 
-        /// LiDAR Point pointer
-        node_info *scan_node_buf = nullptr;
-        /// LiDAR scan count
-        size_t scan_node_count = 0; //LiDAR Scan Count
+        /// LiDAR scan handoff between parsing thread and consumer
+        TripleBuffer<ScanNodes> scan_node_buf;
         /// package sample index
         uint16_t nodeIndex = 0;
         ///
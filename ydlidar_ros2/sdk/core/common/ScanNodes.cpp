@@ -0,0 +1,129 @@
+#include "ScanNodes.h"
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+//数组起始地址按缓存行对齐，便于向量化加载
+static const size_t SCAN_NODES_ALIGN = 64;
+
+static size_t alignUp(size_t n) {
+  return (n + SCAN_NODES_ALIGN - 1) & ~(SCAN_NODES_ALIGN - 1);
+}
+
+ScanNodes::ScanNodes()
+  : m_block(NULL),
+    m_angle(NULL),
+    m_dist(NULL),
+    m_qual(NULL),
+    m_sync(NULL),
+    m_is(NULL),
+    m_capacity(0),
+    m_size(0) {
+}
+
+ScanNodes::~ScanNodes() {
+  release();
+}
+
+void ScanNodes::release() {
+  delete[] m_block;
+  m_block = NULL;
+  m_angle = m_dist = m_qual = NULL;
+  m_sync = m_is = NULL;
+  m_capacity = 0;
+  m_size = 0;
+}
+
+void ScanNodes::reserve(size_t capacity) {
+  clear();
+
+  if (capacity <= m_capacity) {
+    return;
+  }
+
+  release();
+  const size_t words = alignUp(capacity * sizeof(uint16_t));
+  const size_t bytes = alignUp(capacity);
+  m_block = new uint8_t[3 * words + 2 * bytes + SCAN_NODES_ALIGN];
+  uint8_t *p = reinterpret_cast<uint8_t *>(
+                 alignUp(reinterpret_cast<size_t>(m_block)));
+  m_angle = reinterpret_cast<uint16_t *>(p);
+  p += words;
+  m_dist = reinterpret_cast<uint16_t *>(p);
+  p += words;
+  m_qual = reinterpret_cast<uint16_t *>(p);
+  p += words;
+  m_sync = p;
+  p += bytes;
+  m_is = p;
+  m_capacity = capacity;
+  //通常每包一至两段，按每8个点一段预留
+  m_packets.reserve(capacity / 8 + 1);
+}
+
+bool ScanNodes::push(const node_info &node) {
+  if (m_size >= m_capacity) {
+    return false;
+  }
+
+  //包内公共字段变化时开始新的一段
+  if (m_packets.empty() ||
+      m_packets.back().stamp != node.stamp ||
+      m_packets.back().delayTime != node.delayTime ||
+      m_packets.back().scanFreq != node.scanFreq ||
+      m_packets.back().debugInfo != node.debugInfo ||
+      m_packets.back().index != node.index ||
+      m_packets.back().error != node.error) {
+    Packet packet;
+    packet.first = static_cast<uint32_t>(m_size);
+    packet.delayTime = node.delayTime;
+    packet.stamp = node.stamp;
+    packet.scanFreq = node.scanFreq;
+    packet.debugInfo = node.debugInfo;
+    packet.index = node.index;
+    packet.error = node.error;
+    m_packets.push_back(packet);
+  }
+
+  m_angle[m_size] = node.angle;
+  m_dist[m_size] = node.dist;
+  m_qual[m_size] = node.qual;
+  m_sync[m_size] = node.sync;
+  m_is[m_size] = node.is;
+  m_size++;
+  return true;
+}
+
+void ScanNodes::get(size_t i, node_info &node) const {
+  //二分查找样本所在的段
+  size_t lo = 0;
+  size_t hi = m_packets.size();
+
+  while (hi - lo > 1) {
+    size_t mid = (lo + hi) / 2;
+
+    if (m_packets[mid].first <= i) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+
+  const Packet &packet = m_packets[lo];
+  node.sync = m_sync[i];
+  node.is = m_is[i];
+  node.qual = m_qual[i];
+  node.angle = m_angle[i];
+  node.dist = m_dist[i];
+  node.stamp = packet.stamp;
+  node.delayTime = packet.delayTime;
+  node.scanFreq = packet.scanFreq;
+  node.debugInfo = packet.debugInfo;
+  node.index = packet.index;
+  node.error = packet.error;
+}
+
+}  // namespace common
+}  // namespace core
+}  // namespace ydlidar
@@ -0,0 +1,113 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "ydlidar_protocol.h"
+
+namespace ydlidar {
+namespace core {
+namespace common {
+
+/**
+ * @brief One revolution of samples as a structure of arrays.
+ *
+ * The per-sample fields of ::node_info (angle, dist, qual, sync, is) are
+ * kept in separate aligned arrays, 8 bytes per sample. The remaining
+ * fields (stamp, delayTime, scanFreq, debugInfo, index, error) are the
+ * same for every sample of a packet, so they are run-length encoded in a
+ * side table: a new ::Packet entry starts whenever one of them changes.
+ *
+ * Storage is allocated once by ::reserve and reused by ::clear.
+ */
+class ScanNodes {
+ public:
+  /// Fields shared by a run of consecutive samples.
+  struct Packet {
+    uint32_t first;     ///< index of the first sample of the run
+    uint32_t delayTime; ///< delay time
+    uint64_t stamp;     ///< 时间戳
+    uint8_t scanFreq;   ///< 扫描频率
+    uint8_t debugInfo;  ///< debug information
+    uint8_t index;      ///< 包序号
+    uint8_t error;      ///< error package state
+  };
+
+  ScanNodes();
+  ~ScanNodes();
+
+  /**
+   * @brief Allocate room for capacity samples, drops the current samples.
+   * @note Never shrinks, existing storage is kept if it is large enough.
+   */
+  void reserve(size_t capacity);
+
+  size_t capacity() const {
+    return m_capacity;
+  }
+  size_t size() const {
+    return m_size;
+  }
+  bool empty() const {
+    return !m_size;
+  }
+
+  /// Drop every sample, keep the storage.
+  void clear() {
+    m_size = 0;
+    m_packets.clear();
+  }
+
+  /**
+   * @brief Append a sample.
+   * @return false if the container is full, the sample is dropped
+   */
+  bool push(const node_info &node);
+
+  /// Rebuild sample i as a packed ::node_info.
+  void get(size_t i, node_info &node) const;
+
+  const uint16_t *angle() const {
+    return m_angle;
+  }
+  const uint16_t *dist() const {
+    return m_dist;
+  }
+  const uint16_t *qual() const {
+    return m_qual;
+  }
+  const uint8_t *sync() const {
+    return m_sync;
+  }
+  const uint8_t *is() const {
+    return m_is;
+  }
+
+  /// Side table in sample order, the first entry always starts at 0.
+  const std::vector<Packet> &packets() const {
+    return m_packets;
+  }
+  /// Producer side: patch the fields of a run after the fact.
+  Packet &packet(size_t i) {
+    return m_packets[i];
+  }
+
+ private:
+  ScanNodes(const ScanNodes &);
+  ScanNodes &operator=(const ScanNodes &);
+
+  void release();
+
+  uint8_t *m_block; //单次分配的存储，各数组按缓存行对齐
+  uint16_t *m_angle;
+  uint16_t *m_dist;
+  uint16_t *m_qual;
+  uint8_t *m_sync;
+  uint8_t *m_is;
+  size_t m_capacity;
+  size_t m_size;
+  std::vector<Packet> m_packets;
+};
+
+}  // namespace common
+}  // namespace core
+}  // namespace ydlidar
@@ -38,6 +38,8 @@ typedef enum {
   YDLIDAR_TYPE_SERIAL = 0x0,/**< serial type.*/
   YDLIDAR_TYPE_TCP = 0x1,/**< socket tcp type.*/
   YDLIDAR_TYPC_UDP = 0x2,/**< socket udp type.*/
+  YDLIDAR_TYPE_REPLAY = 0x3,/**< capture file replay type.*/
+  YDLIDAR_TYPE_TCP_SERVER = 0x4,/**< listen for a tcp bridge to connect.*/
 } DeviceTypeID;
 
 /** Lidar Type ID */
@@ -61,6 +63,8 @@ typedef enum {
   /* char* properties */
   LidarPropSerialPort = 0,/**< Lidar serial port or network ipaddress */
   LidarPropIgnoreArray,/**< Lidar ignore angle array */
+  LidarPropCaptureFile,/**< raw byte stream capture file */
+  LidarPropProfileFile,/**< cached device profile file */
   /* int properties */
   LidarPropSerialBaudrate = 10,/**< lidar serial baudrate or network port */
   LidarPropLidarType,/**< lidar type code */
@@ -83,6 +87,7 @@ typedef enum {
   LidarPropIntenstiy,/**< lidar intensity flag */
   LidarPropSupportMotorDtrCtrl,/**< lidar support motor Dtr ctrl flag */
   LidarPropSupportHeartBeat,/**< lidar support heartbeat flag */
+  LidarPropReplayRealtime,/**< replay capture file at recorded pace flag */
 } LidarProperty;
 
 /// lidar instance
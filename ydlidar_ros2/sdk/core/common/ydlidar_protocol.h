@@ -426,6 +426,9 @@ struct gs_device_info2 {
 #pragma pack()
 #endif
 
+/// Largest UDP data frame
+#define UDP_FRAME_SIZE 2048
+
 /**
  * @brief UDP Data format
  */
@@ -442,7 +445,8 @@ typedef struct _dataFrame {
   uint32_t startAngle;
   uint32_t dataNum;
   uint32_t frameCrc;
-  uint8_t frameBuf[2048];
+  const uint8_t *frameBuf; ///< received datagram, parsed in place
+  uint32_t frameSize;      ///< bytes in frameBuf
 } dataFrame;
 
 /**
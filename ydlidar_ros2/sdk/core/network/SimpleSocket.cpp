@@ -54,7 +54,12 @@ CSimpleSocket::CSimpleSocket(CSocketType nType) :
   m_pBuffer(NULL), m_nBufferSize(0), m_nSocketDomain(AF_INET),
   m_nSocketType(SocketTypeInvalid), m_nBytesReceived(-1),
   m_nBytesSent(-1), m_nFlags(0),
-  m_bIsBlocking(true), m_open(false) {
+  m_bIsBlocking(true), m_open(false),
+  m_nDatagramsReceived(0), m_nDatagramsDropped(0),
+  m_nDatagramsTruncated(0) {
+#if defined(__linux__)
+  m_stream = NULL;
+#endif
   SetConnectTimeout(DEFAULT_CONNECTION_TIMEOUT_SEC,
                     DEFAULT_CONNECTION_TIMEOUT_USEC);
   memset(&m_stRecvTimeout, 0, sizeof(struct timeval));
@@ -112,7 +117,12 @@ CSimpleSocket::CSimpleSocket(CSocketType nType) :
   }
 }
 
-CSimpleSocket::CSimpleSocket(CSimpleSocket &socket) {
+CSimpleSocket::CSimpleSocket(CSimpleSocket &socket) :
+  m_nDatagramsReceived(0), m_nDatagramsDropped(0),
+  m_nDatagramsTruncated(0) {
+#if defined(__linux__)
+  m_stream = NULL;
+#endif
   m_pBuffer = new uint8_t[socket.m_nBufferSize];
   m_nBufferSize = socket.m_nBufferSize;
   memcpy(m_pBuffer, socket.m_pBuffer, socket.m_nBufferSize);
@@ -208,6 +218,13 @@ void CSimpleSocket::flush() {
 
 size_t CSimpleSocket::available() {
   size_t returned_size = 0;
+#if defined(__linux__)
+
+  if (m_stream) {
+    return m_stream->available();
+  }
+
+#endif
   int max_fd;
   FD_ZERO(&m_readFds);
   FD_SET(m_socket, &m_readFds);
@@ -232,6 +249,13 @@ std::string CSimpleSocket::readSize(size_t size) {
 
 int CSimpleSocket::waitfordata(size_t data_count, uint32_t timeout,
                                size_t *returned_size) {
+#if defined(__linux__)
+
+  if (stream()) {
+    return m_stream->waitfordata(data_count, timeout, returned_size);
+  }
+
+#endif
   return WaitForData(data_count, timeout, returned_size);
 }
 
@@ -246,6 +270,19 @@ size_t CSimpleSocket::writeData(const uint8_t *data, size_t size) {
 }
 
 size_t CSimpleSocket::readData(uint8_t *data, size_t size) {
+#if defined(__linux__)
+
+  if (stream()) {
+    //与原接收方式一致，无数据时最多等待一个接收超时
+    if (!m_stream->available()) {
+      m_stream->waitfordata(1, m_stRecvTimeout.tv_sec * 1000 +
+                            m_stRecvTimeout.tv_usec / 1000);
+    }
+
+    return m_stream->read(data, size);
+  }
+
+#endif
   int32_t rz = Receive(size, data);
 
   if (rz < 0) {
@@ -255,6 +292,18 @@ size_t CSimpleSocket::readData(uint8_t *data, size_t size) {
   return rz;
 }
 
+#if defined(__linux__)
+base::IoStream *CSimpleSocket::stream() {
+  if (!m_stream && IsSocketValid() &&
+      (m_nSocketType == CSimpleSocket::SocketTypeTcp ||
+       m_nSocketType == CSimpleSocket::SocketTypeTcp6)) {
+    m_stream = base::IoReactor::instance().attach(m_socket, true);
+  }
+
+  return m_stream;
+}
+#endif
+
 
 
 
@@ -445,6 +494,48 @@ uint32_t CSimpleSocket::SetWindowSize(uint32_t nOptionName,
 }
 
 
+//------------------------------------------------------------------------------
+//
+// SetReceiveTimestamps()
+//
+//------------------------------------------------------------------------------
+bool CSimpleSocket::SetReceiveTimestamps(bool bEnable) {
+  bool bRetVal = false;
+#if defined(__linux__) && defined(SO_TIMESTAMPNS)
+  int32_t nOn = bEnable ? 1 : 0;
+
+  if (SETSOCKOPT(m_socket, SOL_SOCKET, SO_TIMESTAMPNS, &nOn,
+                 sizeof(int32_t)) == 0) {
+    bRetVal = true;
+  }
+
+  TranslateSocketError();
+#endif
+  return bRetVal;
+}
+
+
+//------------------------------------------------------------------------------
+//
+// SetDropCounting()
+//
+//------------------------------------------------------------------------------
+bool CSimpleSocket::SetDropCounting(bool bEnable) {
+  bool bRetVal = false;
+#if defined(__linux__) && defined(SO_RXQ_OVFL)
+  int32_t nOn = bEnable ? 1 : 0;
+
+  if (SETSOCKOPT(m_socket, SOL_SOCKET, SO_RXQ_OVFL, &nOn,
+                 sizeof(int32_t)) == 0) {
+    bRetVal = true;
+  }
+
+  TranslateSocketError();
+#endif
+  return bRetVal;
+}
+
+
 //------------------------------------------------------------------------------
 //
 // DisableNagleAlgorithm()
@@ -597,6 +688,15 @@ int32_t CSimpleSocket::Send(const uint8_t *pBuf, size_t bytesToSend) {
 bool CSimpleSocket::Close(void) {
   bool bRetVal = false;
 
+#if defined(__linux__)
+
+  if (m_stream) {
+    base::IoReactor::instance().detach(m_stream);
+    m_stream = NULL;
+  }
+
+#endif
+
   //--------------------------------------------------------------------------
   // delete internal buffer
   //--------------------------------------------------------------------------
@@ -1002,6 +1102,123 @@ int32_t CSimpleSocket::Receive(int32_t nMaxBytes, uint8_t *pBuffer) {
 }
 
 
+//------------------------------------------------------------------------------
+//
+// ReceiveBatch() -
+//
+//------------------------------------------------------------------------------
+int32_t CSimpleSocket::ReceiveBatch(Datagram *pDatagrams, int32_t nCount) {
+  if (IsSocketValid() == false) {
+    SetSocketError(CSimpleSocket::SocketInvalidSocket);
+    return CSimpleSocket::SocketError;
+  }
+
+  if (pDatagrams == NULL || nCount <= 0) {
+    SetSocketError(CSimpleSocket::SocketInvalidPointer);
+    return CSimpleSocket::SocketError;
+  }
+
+#if defined(__linux__)
+
+  if (nCount > SOCKET_MAX_BATCH) {
+    nCount = SOCKET_MAX_BATCH;
+  }
+
+  //--------------------------------------------------------------------------
+  // Each message gets room for a receive timestamp and the drop counter.
+  //--------------------------------------------------------------------------
+  union Control {
+    char buf[CMSG_SPACE(sizeof(struct timespec)) + CMSG_SPACE(sizeof(uint32_t))];
+    struct cmsghdr align;
+  };
+  struct mmsghdr msgs[SOCKET_MAX_BATCH];
+  struct iovec iovs[SOCKET_MAX_BATCH];
+  Control controls[SOCKET_MAX_BATCH];
+  memset(msgs, 0, sizeof(struct mmsghdr) * nCount);
+
+  for (int32_t i = 0; i < nCount; i++) {
+    iovs[i].iov_base = pDatagrams[i].data;
+    iovs[i].iov_len = pDatagrams[i].size;
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+    msgs[i].msg_hdr.msg_control = controls[i].buf;
+    msgs[i].msg_hdr.msg_controllen = sizeof(controls[i].buf);
+  }
+
+  //--------------------------------------------------------------------------
+  // MSG_WAITFORONE: wait (up to the receive timeout) for the first datagram,
+  // take the rest only if already queued.
+  //--------------------------------------------------------------------------
+  int32_t nReceived;
+
+  do {
+    nReceived = recvmmsg(m_socket, msgs, nCount, MSG_WAITFORONE, NULL);
+
+    if (nReceived < 0) {
+      TranslateSocketError();
+    }
+  } while (nReceived < 0 &&
+           GetSocketError() == CSimpleSocket::SocketInterrupted);
+
+  if (nReceived < 0) {
+    return CSimpleSocket::SocketError;
+  }
+
+  SetSocketError(CSimpleSocket::SocketSuccess);
+
+  for (int32_t i = 0; i < nReceived; i++) {
+    Datagram &datagram = pDatagrams[i];
+    datagram.size = msgs[i].msg_len;
+    datagram.stamp = 0;
+
+    if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+      m_nDatagramsTruncated++;
+    }
+
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmsg != NULL;
+         cmsg = CMSG_NXTHDR(&msgs[i].msg_hdr, cmsg)) {
+      if (cmsg->cmsg_level != SOL_SOCKET) {
+        continue;
+      }
+
+#if defined(SCM_TIMESTAMPNS)
+
+      if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+        struct timespec ts;
+        memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+        datagram.stamp = static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL +
+                         ts.tv_nsec;
+      }
+
+#endif
+#if defined(SO_RXQ_OVFL)
+
+      if (cmsg->cmsg_type == SO_RXQ_OVFL) {
+        memcpy(&m_nDatagramsDropped, CMSG_DATA(cmsg), sizeof(uint32_t));
+      }
+
+#endif
+    }
+  }
+
+  m_nDatagramsReceived += nReceived;
+  m_nBytesReceived = nReceived > 0 ? pDatagrams[nReceived - 1].size : 0;
+  return nReceived;
+#else
+  int32_t nBytes = Receive(pDatagrams[0].size, pDatagrams[0].data);
+
+  if (nBytes < 0) {
+    return CSimpleSocket::SocketError;
+  }
+
+  pDatagrams[0].size = nBytes;
+  pDatagrams[0].stamp = 0;
+  m_nDatagramsReceived++;
+  return 1;
+#endif
+}
+
+
 //------------------------------------------------------------------------------
 //
 // SetNonblocking()
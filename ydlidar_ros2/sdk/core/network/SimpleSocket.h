@@ -91,6 +91,7 @@
 #endif
 #include "StatTimer.h"
 #include <core/common/ChannelDevice.h>
+#include <core/base/reactor.h>
 
 //-----------------------------------------------------------------------------
 // General class macro definitions and typedefs
@@ -100,12 +101,21 @@
 #endif
 
 #define SOCKET_SENDFILE_BLOCKSIZE 8192
+/// Most datagrams taken by one CSimpleSocket::ReceiveBatch call.
+#define SOCKET_MAX_BATCH 64
 
 namespace ydlidar {
 namespace core {
 using namespace common;
 namespace network {
 
+/// One datagram slot of CSimpleSocket::ReceiveBatch.
+struct Datagram {
+  uint8_t  *data;   ///< [in] memory to receive into
+  int32_t   size;   ///< [in] size of data, [out] bytes received
+  uint64_t  stamp;  ///< [out] kernel receive time in ns, 0 if not enabled
+};
+
 
 /// Provides a platform independent class to for socket development.
 /// This class is designed to abstract socket communication development in a
@@ -243,6 +253,49 @@ class CSimpleSocket : public ChannelDevice {
   /// @return of -1 means that an error has occurred.
   virtual int32_t Receive(int32_t nMaxBytes = 1, uint8_t *pBuffer = 0);
 
+  /// Receives up to nCount datagrams with a single system call (recvmmsg)
+  /// straight into the caller's slots. Blocks like CSimpleSocket::Receive
+  /// for the first datagram only, then takes what is already queued.
+  /// <br>\b NOTE: Only Linux batches, elsewhere one datagram is received.
+  /// @param pDatagrams slots to fill, in arrival order.
+  /// @param nCount number of slots, at most SOCKET_MAX_BATCH are used.
+  /// @return number of datagrams received, -1 on error or timeout.
+  int32_t ReceiveBatch(Datagram *pDatagrams, int32_t nCount);
+
+  /// Let the kernel stamp each received datagram (SO_TIMESTAMPNS), reported
+  /// by CSimpleSocket::ReceiveBatch in CLOCK_REALTIME nanoseconds.
+  /// @return false if not supported.
+  bool SetReceiveTimestamps(bool bEnable);
+
+  /// Let the kernel report datagrams dropped because the receive buffer was
+  /// full (SO_RXQ_OVFL), see CSimpleSocket::GetDatagramsDropped.
+  /// @return false if not supported.
+  bool SetDropCounting(bool bEnable);
+
+  /// Datagrams received by CSimpleSocket::ReceiveBatch.
+  uint64_t GetDatagramsReceived(void) const {
+    return m_nDatagramsReceived;
+  };
+
+  /// Datagrams the kernel dropped on this socket so far, as reported with the
+  /// last datagram received by CSimpleSocket::ReceiveBatch.
+  uint32_t GetDatagramsDropped(void) const {
+    return m_nDatagramsDropped;
+  };
+
+  /// Datagrams larger than their slot, the excess was discarded.
+  uint32_t GetDatagramsTruncated(void) const {
+    return m_nDatagramsTruncated;
+  };
+
+  /// Clear the datagram counters, call when the socket is opened again as
+  /// the kernel drop counter restarts from zero.
+  void ResetDatagramCounters(void) {
+    m_nDatagramsReceived = 0;
+    m_nDatagramsDropped = 0;
+    m_nDatagramsTruncated = 0;
+  };
+
   /// Attempts to send a block of data on an established connection.
   /// @param pBuf block of data to be sent.
   /// @param bytesToSend size of data block to be sent.
@@ -680,6 +733,15 @@ class CSimpleSocket : public ChannelDevice {
   std::string          m_addr;
   uint32_t             m_port;
   bool                 m_open;
+  uint64_t             m_nDatagramsReceived;  /// datagrams received in batches
+  uint32_t             m_nDatagramsDropped;   /// kernel drop counter
+  uint32_t             m_nDatagramsTruncated; /// datagrams larger than the slot
+#if defined(__linux__)
+  /// \brief receive side served by the io reactor, attached by the first
+  /// ChannelDevice read of a TCP socket.
+  base::IoStream *stream();
+  base::IoStream       *m_stream;
+#endif
 };
 
 }//namespace socket
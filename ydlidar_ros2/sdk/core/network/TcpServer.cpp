@@ -0,0 +1,187 @@
+#include "TcpServer.h"
+#include <core/base/timer.h>
+
+using namespace ydlidar;
+using namespace ydlidar::core;
+using namespace ydlidar::core::network;
+
+
+CTcpServer::CTcpServer()
+  : m_port(0),
+    m_server(CSimpleSocket::SocketTypeTcp),
+    m_client(NULL),
+    m_listening(false) {
+}
+
+CTcpServer::~CTcpServer() {
+  dropClient();
+  m_server.Close();
+}
+
+bool CTcpServer::bindport(const char *addr, uint32_t port) {
+  std::string address = addr ? addr : "";
+
+  //监听地址变化后重新监听
+  if (m_listening && (address != m_addr || port != m_port)) {
+    dropClient();
+    m_server.Close();
+    m_listening = false;
+  }
+
+  m_addr = address;
+  m_port = static_cast<uint16_t>(port);
+  return true;
+}
+
+bool CTcpServer::listen() {
+  if (m_listening) {
+    return true;
+  }
+
+  if (!m_server.Initialize()) {
+    m_server.Close();
+    return false;
+  }
+
+  //接收缓存需在监听前设置，建立连接时才能协商较大的接收窗口
+  m_server.SetReceiveWindowSize(TCP_SERVER_WINDOW_SIZE);
+
+  //只服务一个桥接设备
+  if (!m_server.Listen(m_addr.c_str(), m_port, 1)) {
+    m_server.Close();
+    return false;
+  }
+
+  m_server.SetNonblocking();
+  m_listening = true;
+  return true;
+}
+
+bool CTcpServer::accept(uint32_t timeout) {
+  uint32_t st = getms();
+  uint32_t wt = 0;
+
+  while (true) {
+    CActiveSocket *client = m_server.Accept();
+
+    if (client) {
+      dropClient();
+      //命令需立即发出，数据按大块接收
+      client->DisableNagleAlgoritm();
+      client->SetReceiveWindowSize(TCP_SERVER_WINDOW_SIZE);
+      client->SetReceiveTimeout(DEFAULT_REV_TIMEOUT_SEC, DEFAULT_REV_TIMEOUT_USEC);
+      client->SetSendTimeout(DEFAULT_REV_TIMEOUT_SEC, DEFAULT_REV_TIMEOUT_USEC);
+      m_client = client;
+      return true;
+    }
+
+    if (m_server.GetSocketError() != CSimpleSocket::SocketEwouldblock) {
+      return false;
+    }
+
+    if ((wt = getms() - st) >= timeout) {
+      return false;
+    }
+
+    //等待新连接
+    uint32_t remain = timeout - wt;
+    m_server.Select(remain / 1000, (remain % 1000) * 1000);
+  }
+}
+
+void CTcpServer::dropClient() {
+  if (m_client) {
+    delete m_client;
+    m_client = NULL;
+  }
+}
+
+bool CTcpServer::open() {
+  if (!listen()) {
+    return false;
+  }
+
+  if (m_client) {
+    return true;
+  }
+
+  return accept(TCP_SERVER_ACCEPT_TIMEOUT);
+}
+
+bool CTcpServer::isOpen() {
+  return m_client != NULL;
+}
+
+void CTcpServer::closePort() {
+  dropClient();
+}
+
+void CTcpServer::flush() {
+  if (m_client) {
+    m_client->flush();
+  }
+}
+
+size_t CTcpServer::available() {
+  return m_client ? m_client->available() : 0;
+}
+
+std::string CTcpServer::readSize(size_t size) {
+  return m_client ? m_client->readSize(size) : std::string();
+}
+
+int CTcpServer::waitfordata(size_t data_count, uint32_t timeout,
+                            size_t *returned_size) {
+  size_t length = 0;
+
+  if (returned_size == NULL) {
+    returned_size = &length;
+  }
+
+  *returned_size = 0;
+  uint32_t st = getms();
+  uint32_t wt = 0;
+
+  while ((wt = getms() - st) <= timeout) {
+    //没有客户端时等待桥接设备重新连接
+    if (!m_client) {
+      if (!accept(timeout - wt)) {
+        return -1;
+      }
+
+      continue;
+    }
+
+    int ret = m_client->waitfordata(data_count, timeout - wt, returned_size);
+
+    if (ret == -1) {
+      //超时说明旧连接可能已失效，有新连接时切换过去
+      if (accept(0)) {
+        continue;
+      }
+
+      return ret;
+    }
+
+    if (ret != -2) {
+      return ret;
+    }
+
+    //对端断开
+    dropClient();
+  }
+
+  return -1;
+}
+
+size_t CTcpServer::writeData(const uint8_t *data, size_t size) {
+  return m_client ? m_client->writeData(data, size) : 0;
+}
+
+size_t CTcpServer::readData(uint8_t *data, size_t size) {
+  return m_client ? m_client->readData(data, size) : 0;
+}
+
+const char *CTcpServer::DescribeError() {
+  return m_client ? m_client->DescribeError() : m_server.DescribeError();
+}
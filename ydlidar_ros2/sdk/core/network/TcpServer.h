@@ -0,0 +1,74 @@
+#ifndef __TCPSERVER_H__
+#define __TCPSERVER_H__
+#include <string>
+#include "PassiveSocket.h"
+
+namespace ydlidar {
+namespace core {
+namespace network {
+
+/// Receive buffer of the accepted connection, holds several revolutions.
+#define TCP_SERVER_WINDOW_SIZE (256 * 1024)
+/// Time ::CTcpServer::open() waits for the bridge to connect, in milliseconds.
+#define TCP_SERVER_ACCEPT_TIMEOUT 10000
+
+/// Channel that listens on a TCP port and talks to the client that
+/// connects to it, e.g. a Wi-Fi serial bridge forwarding the LiDAR UART.
+/// The port path is the local address to listen on (empty or "0.0.0.0"
+/// for any) and the baudrate is the TCP port.
+///
+/// The listening socket stays open for the lifetime of the channel.
+/// A client that disconnects is dropped and the next one is accepted
+/// while waiting for data. A pending connection also replaces the
+/// current client, so a bridge that rebooted without closing its old
+/// connection takes over as soon as the old one goes quiet.
+class CTcpServer : public ChannelDevice {
+ public:
+  CTcpServer();
+  virtual ~CTcpServer();
+
+  virtual bool bindport(const char *addr, uint32_t port);
+
+  /// Listen if not listening yet and wait for a client.
+  /// @return true once a client is connected
+  virtual bool open();
+
+  /// Whether a client is connected.
+  virtual bool isOpen();
+
+  /// Drop the client, keep listening.
+  virtual void closePort();
+
+  virtual void flush();
+  virtual size_t available();
+  virtual std::string readSize(size_t size = 1);
+  virtual int waitfordata(size_t data_count, uint32_t timeout = -1,
+                          size_t *returned_size = NULL);
+  virtual size_t writeData(const uint8_t *data, size_t size);
+  virtual size_t readData(uint8_t *data, size_t size);
+  virtual const char *DescribeError();
+
+ private:
+  CTcpServer(const CTcpServer &);
+  CTcpServer &operator=(const CTcpServer &);
+
+  bool listen();
+
+  /// Accept a connection within timeout milliseconds, it replaces the
+  /// current client.
+  bool accept(uint32_t timeout);
+
+  void dropClient();
+
+  std::string m_addr;
+  uint16_t m_port;
+  CPassiveSocket m_server;
+  CActiveSocket *m_client;
+  bool m_listening;
+};
+
+}//namespace network
+}//namespace core
+}//namespace ydlidar
+
+#endif // __TCPSERVER_H__
@@ -641,7 +641,11 @@ Serial::SerialImpl::SerialImpl(const string &port, unsigned long baudrate,
                                bytesize_t bytesize,
                                parity_t parity, stopbits_t stopbits,
                                flowcontrol_t flowcontrol)
-  : port_(port), fd_(-1), pid(-1), is_open_(false), xonxoff_(false),
+  : port_(port), fd_(-1),
+#if defined(__linux__)
+    stream_(NULL),
+#endif
+    pid(-1), is_open_(false), xonxoff_(false),
     rtscts_(false), timeout_(Timeout()), baudrate_(baudrate), byte_time_ns_(0),
     parity_(parity), bytesize_(bytesize), stopbits_(stopbits),
     flowcontrol_(flowcontrol) {
@@ -737,6 +741,11 @@ bool Serial::SerialImpl::open() {
     byte_time_ns_ += ((1.5 - stopbits_one_point_five) * bit_time_ns);
   }
 
+#if defined(__linux__)
+  // Receive in the io reactor thread instead of polling with pselect.
+  stream_ = base::IoReactor::instance().attach(fd_);
+#endif
+
   is_open_ = true;
   return true;
 }
@@ -823,6 +832,15 @@ void Serial::SerialImpl::close() {
     is_open_ = false;
   }
 
+#if defined(__linux__)
+
+  if (stream_) {
+    base::IoReactor::instance().detach(stream_);
+    stream_ = NULL;
+  }
+
+#endif
+
   if (fd_ != -1) {
     ::close(fd_);
   }
@@ -848,6 +866,14 @@ size_t Serial::SerialImpl::available() {
     return 0;
   }
 
+#if defined(__linux__)
+
+  if (stream_) {
+    return stream_->available();
+  }
+
+#endif
+
   int count = 0;
 
   if (-1 == ioctl(fd_, TIOCINQ, &count)) {
@@ -904,6 +930,14 @@ int Serial::SerialImpl::waitfordata(size_t data_count, uint32_t timeout,
 
   *returned_size = 0;
 
+#if defined(__linux__)
+
+  if (stream_) {
+    return stream_->waitfordata(data_count, timeout, returned_size);
+  }
+
+#endif
+
   if (isOpen()) {
     if (ioctl(fd_, FIONREAD, returned_size) == -1) {
       return -2;
@@ -991,6 +1025,29 @@ size_t Serial::SerialImpl::read(uint8_t *buf, size_t size) {
   total_timeout_ms += timeout_.read_timeout_multiplier * static_cast<long>(size);
   MillisecondTimer total_timeout(total_timeout_ms);
 
+#if defined(__linux__)
+
+  if (stream_) {
+    bytes_read = stream_->read(buf, size);
+
+    while (bytes_read < size) {
+      int64_t timeout_remaining_ms = total_timeout.remaining();
+
+      if (timeout_remaining_ms <= 0 ||
+          stream_->waitfordata(size - bytes_read,
+                               static_cast<uint32_t>(timeout_remaining_ms)) != 0) {
+        bytes_read += stream_->read(buf + bytes_read, size - bytes_read);
+        break;
+      }
+
+      bytes_read += stream_->read(buf + bytes_read, size - bytes_read);
+    }
+
+    return bytes_read;
+  }
+
+#endif
+
   // Pre-fill buffer with available bytes
   {
     ssize_t bytes_read_now = ::read(fd_, buf, size);
@@ -1440,6 +1497,14 @@ void Serial::SerialImpl::flushInput() {
   }
 
   tcflush(fd_, TCIFLUSH);
+
+#if defined(__linux__)
+
+  if (stream_) {
+    stream_->clear();
+  }
+
+#endif
 }
 
 void Serial::SerialImpl::flushOutput() {
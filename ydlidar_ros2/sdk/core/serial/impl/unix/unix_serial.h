@@ -7,6 +7,7 @@
 #include <assert.h>
 #include <termios.h>
 #include <core/serial/serial.h>
+#include <core/base/reactor.h>
 
 namespace ydlidar {
 namespace core {
@@ -132,6 +133,9 @@ class Serial::SerialImpl {
  private:
   string port_;               // Path to the file descriptor
   int fd_;                    // The current file descriptor
+#if defined(__linux__)
+  base::IoStream *stream_;    // Receive side served by the io reactor
+#endif
   pid_t pid;
 
   bool is_open_;
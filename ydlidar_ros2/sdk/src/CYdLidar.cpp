@@ -32,6 +32,7 @@
 #include "core/common/DriverInterface.h"
 #include "core/common/ydlidar_help.h"
 #include "core/common/ydlidar_protocol.h"
+#include "core/base/trace.h"
 #include "YDlidarDriver.h"
 #include "ETLidarDriver.h"
 #include "GSLidarDriver.h"
@@ -64,6 +65,8 @@ CYdLidar::CYdLidar() : lidarPtr(nullptr)
   m_MinRange = 0.01f;
   m_SampleRate = 5;
   m_ScanFrequency = 10;
+  m_UserSampleRate = m_SampleRate;
+  m_UserScanFrequency = m_ScanFrequency;
   m_FixedSize = 720;
   frequencyOffset = 0.4f;
   m_AbnormalCheckCount = 2;
@@ -76,18 +79,23 @@ CYdLidar::CYdLidar() : lidarPtr(nullptr)
   lidar_model = DriverInterface::YDLIDAR_G2B;
   m_Intensity = false;
   m_IntensityBit = 10;
-  last_node_time = getTime();
   global_nodes = new node_info[DriverInterface::MAX_SCAN_NODES];
-  last_frequency = 0;
-  m_FristNodeTime = getTime();
-  m_AllNode = 0;
+  m_PointIndex = 0;
   m_DeviceType = YDLIDAR_TYPE_SERIAL;
   m_SupportMotorDtrCtrl = true;
   m_SupportHearBeat = false;
+  m_CaptureFile = "";
+  m_ProfileFile = "";
+  m_ProfileLoaded = false;
+  m_InitTime = 0;
+  m_TimeToFirstScan = 0;
+  m_FirstScanPending = false;
+  m_ReplayRealtime = true;
   m_isAngleOffsetCorrected = false;
   m_field_of_view = 360.f;
   memset(&m_LidarVersion, 0, sizeof(LidarVersion));
   zero_offset_angle_scale = 4.f;
+  updateConvertParam();
 }
 
 /*-------------------------------------------------------------
@@ -174,6 +182,14 @@ bool CYdLidar::setlidaropt(int optname, const void *optval, int optlen)
     }
     break;
 
+  case LidarPropCaptureFile:
+    m_CaptureFile = (const char *)optval;
+    break;
+
+  case LidarPropProfileFile:
+    m_ProfileFile = (const char *)optval;
+    break;
+
   case LidarPropFixedResolution:
     m_FixedResolution = *(bool *)(optval);
     break;
@@ -209,6 +225,10 @@ bool CYdLidar::setlidaropt(int optname, const void *optval, int optlen)
     m_SupportHearBeat = *(bool *)(optval);
     break;
 
+  case LidarPropReplayRealtime:
+    m_ReplayRealtime = *(bool *)(optval);
+    break;
+
   case LidarPropMaxRange:
     m_MaxRange = *(float *)(optval);
     break;
@@ -227,6 +247,7 @@ bool CYdLidar::setlidaropt(int optname, const void *optval, int optlen)
 
   case LidarPropScanFrequency:
     m_ScanFrequency = *(float *)(optval);
+    m_UserScanFrequency = m_ScanFrequency;
     break;
 
   case LidarPropSerialBaudrate:
@@ -245,6 +266,7 @@ bool CYdLidar::setlidaropt(int optname, const void *optval, int optlen)
   {
     int sr = *(int*)(optval);
     m_SampleRate = sr;
+    m_UserSampleRate = m_SampleRate;
     break;
   }
 
@@ -324,6 +346,14 @@ bool CYdLidar::getlidaropt(int optname, void *optval, int optlen)
     memcpy(optval, m_IgnoreString.c_str(), optlen);
     break;
 
+  case LidarPropCaptureFile:
+    memcpy(optval, m_CaptureFile.c_str(), optlen);
+    break;
+
+  case LidarPropProfileFile:
+    memcpy(optval, m_ProfileFile.c_str(), optlen);
+    break;
+
   case LidarPropFixedResolution:
     memcpy(optval, &m_FixedResolution, optlen);
     break;
@@ -359,6 +389,10 @@ bool CYdLidar::getlidaropt(int optname, void *optval, int optlen)
     memcpy(optval, &m_SupportHearBeat, optlen);
     break;
 
+  case LidarPropReplayRealtime:
+    memcpy(optval, &m_ReplayRealtime, optlen);
+    break;
+
   case LidarPropMaxRange:
     memcpy(optval, &m_MaxRange, optlen);
     break;
@@ -416,6 +450,10 @@ bool CYdLidar::getlidaropt(int optname, void *optval, int optlen)
 bool CYdLidar::initialize()
 {
   uint32_t t = getms();
+  //统计从初始化到第一圈数据的耗时
+  m_InitTime = t;
+  m_TimeToFirstScan = 0;
+  m_FirstScanPending = true;
   if (!checkConnect())
   {
     error("Error initializing YDLIDAR check Comms.");
@@ -462,24 +500,65 @@ bool CYdLidar::turnOn()
   if (lidarPtr->isscanning())
     return true;
 
-  uint32_t t = getms();
-  //启动扫描
-  result_t ret = lidarPtr->startScan();
-  if (!IS_OK(ret))
+  uint32_t t = 0;
+  bool ok = false;
+  //缓存与雷达实际状态不符时，不再读取缓存，按冷启动重试一次
+  bool skipProfile = false;
+  for (;;)
   {
-    ret = lidarPtr->startScan();
+    t = getms();
+    //有匹配的设备缓存时跳过强度自动识别
+    if (!skipProfile && loadProfile())
+    {
+      lidarPtr->setAutoIntensity(false);
+      lidarPtr->setIntensities(m_Profile.intensity);
+      lidarPtr->setIntensityBit(m_Profile.intensityBit);
+    }
+    //启动扫描
+    result_t ret = lidarPtr->startScan();
     if (!IS_OK(ret))
     {
-      lidarPtr->stop();
-      error("Failed to start scan mode %d", ret);
-      return false;
+      ret = lidarPtr->startScan();
+      if (!IS_OK(ret))
+      {
+        lidarPtr->stop();
+        error("Failed to start scan mode %d", ret);
+        return false;
+      }
     }
-  }
-  info("Successed to start scan mode, Elapsed time %u ms", getms() - t);
+    info("Successed to start scan mode, Elapsed time %u ms", getms() - t);
+
+    t = getms();
+    //计算采样率，有缓存时收到与缓存一致的一圈数据即可
+    ok = m_ProfileLoaded ? checkLidarProfile() : checkLidarAbnormal();
+    if (ok || !m_ProfileLoaded)
+      break;
 
-  t = getms();
-  //计算采样率
-  if (!checkLidarAbnormal())
+    //删除缓存后按冷启动重新检查；缓存文件不可写时删不掉，
+    //跳过缓存继续启动，不能再次读到同一份过期缓存
+    warn("Cached profile of the lidar [%s] is out of date, probing again",
+      m_ProfileKey.c_str());
+    if (!ydlidar::eraseDeviceProfile(m_ProfileFile, m_ProfileKey))
+      warn("Failed to erase the cached profile in [%s]",
+        m_ProfileFile.c_str());
+    m_ProfileLoaded = false;
+    skipProfile = true;
+    lidarPtr->stop();
+    lidarPtr->setIntensities(m_Intensity);
+    lidarPtr->setIntensityBit(m_IntensityBit);
+    lidarPtr->setAutoIntensity(m_AutoIntensity);
+    if (!m_SingleChannel)
+    {
+      //恢复用户设置的采样率和转速后重新查询
+      m_SampleRate = m_UserSampleRate;
+      m_ScanFrequency = m_UserScanFrequency;
+      defalutSampleRate = getDefaultSampleRate(lidar_model);
+      checkRates();
+    }
+    if (hasZeroAngle(lidar_model))
+      checkCalibrationAngle(m_SerialNumber);
+  }
+  if (!ok)
   {
     lidarPtr->stop();
     error("Failed to turn on the Lidar, because the lidar is [%s].",
@@ -488,6 +567,9 @@ bool CYdLidar::turnOn()
   }
   info("Successed to check the lidar, Elapsed time %u ms", getms() - t);
 
+  if (!m_ProfileLoaded)
+    saveProfile();
+
   m_field_of_view = 360.f;
   //网络TOF雷达需要设置视场角
   if (isNetTOFLidar(m_LidarType))
@@ -504,14 +586,15 @@ bool CYdLidar::turnOn()
     }
   }
 
-  last_frequency = 0;
-  m_FristNodeTime = getTime();
-  m_AllNode = 0;
   m_PointTime = lidarPtr->getPointTime();
+  //采样点时间模型从标称采样间隔开始拟合
+  m_PointIndex = 0;
+  m_ClockSync.setNominalPeriod(m_PointTime);
   lidarPtr->setAutoReconnect(m_AutoReconnect);
   info("Now lidar is scanning...");
 
-  lastStamp = 0;
+  //雷达型号、版本及零位角已确定，计算点云转换参数
+  updateConvertParam();
   //重置错误
   lidarPtr->setDriverError(NoError);
   return true;
@@ -523,31 +606,40 @@ bool CYdLidar::isScanning() const
 }
 
 bool CYdLidar::doProcessSimple(LaserScan &outscan)
+{
+  return processScan(outscan, 1000, false);
+}
+
+bool CYdLidar::waitScan(LaserScan &outscan, uint32_t timeout)
+{
+  return processScan(outscan, timeout, true);
+}
+
+bool CYdLidar::processScan(LaserScan &outscan, uint32_t timeout,
+                           bool quietTimeout)
 {
   //判断是否已启动扫描
   if (!checkHardware())
   {
     delay(200 / m_ScanFrequency);
-    m_AllNode = 0;
-    m_FristNodeTime = getTime();
+    //重新扫描后重新建立时间模型
+    m_PointIndex = 0;
+    m_ClockSync.reset();
     return false;
   }
 
-  size_t count = ydlidar::YDlidarDriver::MAX_SCAN_NODES;
-
   // wait Scan data:
-  uint64_t tim_scan_start = getTime();
-  uint64_t startTs = tim_scan_start;
-  //从缓存中获取已采集的一圈扫描数据
-  result_t op_result = lidarPtr->grabScanData(global_nodes, count, 1000);
-  uint64_t tim_scan_end = getTime();
-  uint64_t endTs = tim_scan_end;
-  uint64_t sys_scan_time = tim_scan_end - tim_scan_start; //获取一圈数据所花费的时间
+  //从缓存中获取已采集的一圈扫描数据（直接引用驱动缓存，无拷贝）
+  const ScanNodes *scan_nodes = NULL;
+  //阻塞在驱动的数据事件上，一圈数据就绪立即返回
+  result_t op_result = lidarPtr->acquireScanData(scan_nodes, timeout);
+  size_t count = IS_OK(op_result) ? scan_nodes->size() : 0;
   outscan.points.clear();
 
   // Fill in scan data:
   if (IS_OK(op_result) && count)
   {
+    YDLIDAR_TRACE_SCOPE("doProcessSimple");
     int offsetSize = 0;
 
     if (isNetTOFLidar(m_LidarType))
@@ -560,48 +652,41 @@ bool CYdLidar::doProcessSimple(LaserScan &outscan)
       }
     }
 
-    //根据采样频率计算的采样间隔时间计算出来总的扫描时间
-    uint64_t scan_time = m_PointTime * (count - 1 + offsetSize);
-    int timeDiff = static_cast<int>(sys_scan_time - scan_time);
-
-    bool HighPayLoad = false;
+    const std::vector<ScanNodes::Packet> &packets = scan_nodes->packets();
 
-    if (global_nodes[0].stamp > 0 &&
-        global_nodes[0].stamp < tim_scan_start)
+    //上层取数据不及时会丢圈，按时间差补齐采样点序号
+    if (m_ClockSync.isValid())
     {
-      tim_scan_end = global_nodes[0].stamp;
-      HighPayLoad = true;
-    }
-
-    tim_scan_end -= m_PointTime;
-    tim_scan_end -= global_nodes[0].delayTime;
-    tim_scan_start = tim_scan_end - scan_time;
+      const uint64_t last = packets.back().stamp;
+      const uint64_t expect = m_ClockSync.toTime(m_PointIndex + count - 1);
+      const double period = m_ClockSync.period();
 
-    if (!HighPayLoad && tim_scan_start < startTs)
-    {
-      tim_scan_start = startTs;
-      tim_scan_end = tim_scan_start + scan_time;
+      if (period > 0 && last > expect &&
+          double(last - expect) > period * count / 2)
+      {
+        m_PointIndex += static_cast<uint64_t>(double(last - expect) / period);
+      }
     }
 
-    if ((last_node_time + m_PointTime) >= tim_scan_start &&
-        (last_node_time + m_PointTime) < endTs - scan_time)
-    {
-      tim_scan_start = last_node_time + m_PointTime;
-      tim_scan_end = tim_scan_start + scan_time;
-    }
+    //以采样点序号作为设备时钟，点的时间戳（数据包接收时间或设备时间戳）作为观测，
+    //拟合二者的线性关系得到每个点的采集时间
+    const uint64_t first_index = m_PointIndex;
+    m_PointIndex += count + offsetSize; //TOF网络雷达盲区内的点不发送但仍占用采样时间
 
-    if (m_AllNode == 0 && abs(timeDiff) < 10 * 1e6)
-    {
-      m_FristNodeTime = tim_scan_start;
-      m_AllNode += (count + offsetSize);
-    }
-    else if (m_AllNode != 0)
+    for (size_t i = 0; i < packets.size(); i++)
     {
-      m_AllNode += (count + offsetSize);
+      //同一批解析的点时间戳相同，只取其中最后一点
+      if (i + 1 == packets.size())
+      {
+        m_ClockSync.update(first_index + count - 1, packets[i].stamp);
+      }
+      else if (packets[i + 1].stamp - packets[i].stamp > m_PointTime)
+      {
+        m_ClockSync.update(first_index + packets[i + 1].first - 1,
+                           packets[i].stamp);
+      }
     }
 
-    last_node_time = tim_scan_end;
-
     if (m_MaxAngle < m_MinAngle)
     {
       float temp = m_MinAngle;
@@ -615,31 +700,17 @@ bool CYdLidar::doProcessSimple(LaserScan &outscan)
     memset(&debug, 0, sizeof(debug));
     outscan.config.min_angle = math::from_degrees(m_MinAngle);
     outscan.config.max_angle = math::from_degrees(m_MaxAngle);
-    //将首末点采集时间差作为采集时长
-    // outscan.config.scan_time = static_cast<float>((global_nodes[count - 1].stamp - 
-    //   global_nodes[0].stamp)) / 1e9;
-    // outscan.config.scan_time = sys_scan_time / 1e9;
-    if (lastStamp > 0 && global_nodes[0].stamp > 0)
-      outscan.config.scan_time = double(global_nodes[0].stamp - lastStamp) / 1e9;
-    else
-      outscan.config.scan_time = 0;
-    lastStamp = global_nodes[0].stamp;
-    //计算时间增量
-    if (!ISZERO(outscan.config.scan_time))
-      outscan.config.time_increment = outscan.config.scan_time / (count - 1);
-    else
-      outscan.config.time_increment = .0f;
+    //采集时长和点间隔取自时间模型，第i个点的采集时间为stamp + i * time_increment
+    const double point_time = m_ClockSync.period();
+    outscan.config.scan_time = static_cast<float>(point_time * (count + offsetSize) / 1e9);
+    outscan.config.time_increment = static_cast<float>(point_time / 1e9);
     outscan.config.min_range = m_MinRange;
     outscan.config.max_range = m_MaxRange;
     //模组编号
-    outscan.moduleNum = global_nodes[0].index;
+    outscan.moduleNum = packets[0].index;
     //环境标记
-    outscan.envFlag = global_nodes[0].is + (uint16_t(global_nodes[1].is) << 8);
-    //将一圈中第一个点采集时间作为该圈数据采集时间
-    if (global_nodes[0].stamp > 0)
-      outscan.stamp = global_nodes[0].stamp;
-    else
-      outscan.stamp = 0;
+    const uint8_t *is = scan_nodes->is();
+    outscan.envFlag = is[0] + (count > 1 ? uint16_t(is[1]) << 8 : 0);
 
     float scanfrequency = 0.0;
 
@@ -651,130 +722,81 @@ bool CYdLidar::doProcessSimple(LaserScan &outscan)
     outscan.config.angle_increment = math::from_degrees(m_field_of_view) /
       (all_node_count - 1);
 
-    float range = 0.0;
-    float intensity = 0.0;
-    float angle = 0.0;
     debug.maxIndex = 0;
 
-    // printf("AngleOffset %f\n", m_AngleOffset);
+    //转换参数已在雷达型号确定时计算好，循环中不再判断雷达型号
+    const ConvertParam &cp = m_Convert;
+    const float min_angle = outscan.config.min_angle;
+    const float max_angle = outscan.config.max_angle;
+    const float two_pi = static_cast<float>(2.0 * M_PI);
+    const float pi = static_cast<float>(M_PI);
+    //复用点云缓存容量，避免每圈重新分配内存
+    outscan.points.resize(count);
+    LaserPoint *points = &outscan.points[0];
+    size_t point_count = 0;
+    size_t first_kept = 0; //第一个保留的点在一圈中的序号
+    //按列连续读取，不再逐点加载紧凑结构体
+    const uint16_t *node_angle = scan_nodes->angle();
+    const uint16_t *node_dist = scan_nodes->dist();
+    const uint16_t *node_qual = scan_nodes->qual();
 
     //遍历一圈点
-    for (int i = 0; i < count; i++)
+    for (size_t i = 0; i < count; i++)
     {
-      const node_info& node = global_nodes[i];
-
-      // printf("%lu a:%.01f d:%u\n", 
-      //   i, float(node.angle) / 128.0f, node.dist);
-
-      if (isNetTOFLidar(m_LidarType))
-      {
-        angle = static_cast<float>(global_nodes[i].angle / 100.0f) +
-                m_AngleOffset;
-      }
-      else
-      {
-        angle = static_cast<float>((global_nodes[i].angle >>
-                                    LIDAR_RESP_ANGLE_SHIFT) /
-                                   64.0f) +
-                m_AngleOffset;
-      }
-
-      if (isOctaveLidar(lidar_model) ||
-          isOldVersionTOFLidar(lidar_model, Major, Minjor))
-      {
-        range = static_cast<float>(global_nodes[i].dist / 2000.f);
-      }
-      else if (isR3Lidar(lidar_model))
-      {
-        range = static_cast<float>(global_nodes[i].dist / 40000.f);
-      }
-      else
-      {
-        if (isTOFLidar(m_LidarType) || 
-          isNetTOFLidar(m_LidarType) ||
-          isGSLidar(m_LidarType) ||
-          isSDMLidar(m_LidarType) ||
-          isDTSLidar(m_LidarType))
-        {
-          range = static_cast<float>(global_nodes[i].dist / 1000.f);
-        }
-        else
-        {
-          range = static_cast<float>(global_nodes[i].dist / 4000.f);
-        }
-      }
-
-      intensity = static_cast<float>(global_nodes[i].qual);
-
-      angle = math::from_degrees(angle);
-
-      if (global_nodes[i].scanFreq != 0)
-      {
-        scanfrequency = global_nodes[i].scanFreq / 10.0;
-
-        if (isTOFLidar(m_LidarType)) //TOF雷达转速偏移3Hz
-        {
-          if (!isOldVersionTOFLidar(lidar_model, Major, Minjor))
-          {
-            scanfrequency = global_nodes[i].scanFreq / 10.0 + 3.0;
-          }
-        }
-        else if (isTEALidar(lidar_model) ||
-          isGSLidar(m_LidarType) ||
-          isTIALidar(m_LidarType)) //TEA雷达转速范围10~30，无缩放
-        {
-          scanfrequency = global_nodes[i].scanFreq;
-        }
-      }
-
-      // Rotate 180 degrees or not
-      if (m_Reversion || isNetTOFLidar(m_LidarType))
-      {
-        angle = angle + M_PI;
-      }
-
-      // Is it counter clockwise
-      if (m_Inverted)
-      {
-        angle = 2 * M_PI - angle;
-      }
-
-      angle = math::normalize_angle(angle);
-
-      // ignore angle
-      if (isRangeIgnore(angle))
-      {
-        range = 0.0;
-      }
+      //角度归一化到(-PI, PI]
+      float angle = (node_angle[i] >> cp.angleShift) * cp.angleScale +
+        cp.angleBase;
+      angle -= two_pi * ceilf((angle - pi) / two_pi);
+      float range = node_dist[i] * cp.distScale;
 
       //过滤点
-      if (!isRangeValid(range) ||
-        (m_SunNoise && node.is == SUNNOISEINTENSITY) ||
-        (m_GlassNoise && node.is == GLASSNOISEINTENSITY))
+      if (range < m_MinRange || range > m_MaxRange ||
+        (m_SunNoise && is[i] == SUNNOISEINTENSITY) ||
+        (m_GlassNoise && is[i] == GLASSNOISEINTENSITY))
       {
-        range = .0;
+        range = .0f;
       }
 
-      // printf("i %d d %.03f a %.02f flag %u\n",
-      //   i, range, angle*180.0/M_PI, node.sync);
-
-      if (angle >= outscan.config.min_angle &&
-          angle <= outscan.config.max_angle)
+      //先写入再根据角度范围决定是否保留，避免分支
+      LaserPoint &point = points[point_count];
+      point.angle = angle;
+      point.range = range;
+      point.intensity = static_cast<float>(node_qual[i]);
+      if (!point_count)
+        first_kept = i;
+      point_count += (angle >= min_angle && angle <= max_angle);
+    } //end for (size_t i = 0; i < count; i++)
+
+    outscan.points.resize(point_count);
+    //将第一个保留点的采集时间作为该圈数据采集时间
+    outscan.stamp = m_ClockSync.toTime(first_index + first_kept);
+
+    // ignore angle
+    if (!m_IgnoreArray.empty())
+    {
+      for (size_t i = 0; i < point_count; i++)
       {
-        LaserPoint point;
-        point.angle = angle;
-        point.range = range;
-        point.intensity = intensity;
-
-        outscan.points.push_back(point);
+        if (isRangeIgnore(points[i].angle))
+          points[i].range = .0f;
       }
+    }
 
-      parsePackageNode(global_nodes[i], debug);
-      if (global_nodes[i].error)
+    //转速、调试信息和错误标记按包保存，逐包解析即可
+    for (size_t i = 0; i < packets.size(); i++)
+    {
+      const ScanNodes::Packet &packet = packets[i];
+      if (packet.scanFreq != 0)
+        scanfrequency = packet.scanFreq * cp.freqScale + cp.freqOffset;
+
+      node_info node = {};
+      node.index = packet.index;
+      node.debugInfo = packet.debugInfo;
+      parsePackageNode(node, debug);
+      if (packet.error)
       {
         debug.maxIndex = 255;
       }
-    } //end for (int i = 0; i < count; i++)
+    }
 
     outscan.size = outscan.points.size(); //保留原点云数
 
@@ -785,14 +807,25 @@ bool CYdLidar::doProcessSimple(LaserScan &outscan)
 
     //解析V2协议雷达扫描数据中ct信息中的设备信息
     // getDeviceInfoByPackage(debug);
-    //重新计算采样率
-    resample(scanfrequency, count, tim_scan_end, tim_scan_start);
 
     outscan.scanFreq = scanfrequency;
     outscan.sampleRate = m_SampleRate;
 
+    if (m_FirstScanPending)
+    {
+      m_FirstScanPending = false;
+      m_TimeToFirstScan = getms() - m_InitTime;
+      info("Time to first scan %u ms", m_TimeToFirstScan);
+    }
+
     return true;
   }
+  else if (quietTimeout && op_result == RESULT_TIMEOUT &&
+           lidarPtr->isscanning())
+  {
+    //一圈数据尚未采集完成，不重置采样率统计
+    return false;
+  }
   else
   {
     // if (lidarPtr->getDriverError() != NoError)
@@ -803,8 +836,7 @@ bool CYdLidar::doProcessSimple(LaserScan &outscan)
       fflush(stderr);
     }
 
-    m_AllNode = 0;
-    m_FristNodeTime = tim_scan_start;
+    m_ClockSync.reset();
   }
 
   return false;
@@ -852,6 +884,81 @@ bool CYdLidar::isAngleOffsetCorrected() const
   return m_isAngleOffsetCorrected;
 }
 
+/*-------------------------------------------------------------
+                    updateConvertParam
+-------------------------------------------------------------*/
+void CYdLidar::updateConvertParam()
+{
+  ConvertParam &cp = m_Convert;
+  float angleScale = 0.0f;
+
+  //角度
+  if (isNetTOFLidar(m_LidarType))
+  {
+    cp.angleShift = 0;
+    angleScale = 1.0f / 100.0f;
+  }
+  else
+  {
+    cp.angleShift = LIDAR_RESP_ANGLE_SHIFT;
+    angleScale = 1.0f / 64.0f;
+  }
+  cp.angleScale = static_cast<float>(math::from_degrees(angleScale));
+  double angleBase = math::from_degrees(m_AngleOffset);
+  // Rotate 180 degrees or not
+  if (m_Reversion || isNetTOFLidar(m_LidarType))
+  {
+    angleBase += M_PI;
+  }
+  // Is it counter clockwise
+  if (m_Inverted)
+  {
+    cp.angleScale = -cp.angleScale;
+    angleBase = 2 * M_PI - angleBase;
+  }
+  cp.angleBase = static_cast<float>(angleBase);
+
+  //距离
+  if (isOctaveLidar(lidar_model) ||
+      isOldVersionTOFLidar(lidar_model, Major, Minjor))
+  {
+    cp.distScale = 1.0f / 2000.f;
+  }
+  else if (isR3Lidar(lidar_model))
+  {
+    cp.distScale = 1.0f / 40000.f;
+  }
+  else if (isTOFLidar(m_LidarType) ||
+           isNetTOFLidar(m_LidarType) ||
+           isGSLidar(m_LidarType) ||
+           isSDMLidar(m_LidarType) ||
+           isDTSLidar(m_LidarType))
+  {
+    cp.distScale = 1.0f / 1000.f;
+  }
+  else
+  {
+    cp.distScale = 1.0f / 4000.f;
+  }
+
+  //转速
+  cp.freqScale = 0.1f;
+  cp.freqOffset = 0.0f;
+  if (isTOFLidar(m_LidarType)) //TOF雷达转速偏移3Hz
+  {
+    if (!isOldVersionTOFLidar(lidar_model, Major, Minjor))
+    {
+      cp.freqOffset = 3.0f;
+    }
+  }
+  else if (isTEALidar(lidar_model) ||
+    isGSLidar(m_LidarType) ||
+    isTIALidar(m_LidarType)) //TEA雷达转速范围10~30，无缩放
+  {
+    cp.freqScale = 1.0f;
+  }
+}
+
 /*-------------------------------------------------------------
                     DescribeError
 -------------------------------------------------------------*/
@@ -1029,50 +1136,6 @@ bool CYdLidar::getDeviceInfoByPackage(const LaserDebug &debug)
   return false;
 }
 
-/*-------------------------------------------------------------
-                    resample
--------------------------------------------------------------*/
-void CYdLidar::resample(
-  int frequency, int count, 
-  uint64_t tim_scan_end,
-  uint64_t tim_scan_start)
-{
-  //重新校准采样率
-  // if( (lidar_model  == DriverInterface::YDLIDAR_TG15)
-  //     || (lidar_model  == DriverInterface::YDLIDAR_TG30)
-  //     || (lidar_model  == DriverInterface::YDLIDAR_TG50) )
-  //   {
-  //       m_SampleRate = m_SampleRatebyD1;
-  //   }
-
-  if (frequency > 3 && frequency <= 15.7 &&
-      (frequency - last_frequency) < 0.05)
-  {
-    int sample = static_cast<int>((frequency * count + 500) / 1000);
-
-    if (sample != m_SampleRate)
-    {
-    }
-  }
-
-  last_frequency = frequency;
-  int realSampleRate = 0;
-
-  if (m_AllNode != 0)
-  {
-    realSampleRate = 1e9 * m_AllNode / (tim_scan_end - m_FristNodeTime);
-    int RateDiff = std::abs(static_cast<int>(realSampleRate - m_SampleRate * 1000));
-
-    if (RateDiff > 1000 ||
-        (static_cast<int64_t>(tim_scan_end - m_FristNodeTime) > 10 * 1e9 &&
-         RateDiff > 30))
-    {
-      m_AllNode = 0;
-      m_FristNodeTime = tim_scan_start;
-    }
-  }
-}
-
 //检查异常
 bool CYdLidar::checkLidarAbnormal()
 {
@@ -1089,11 +1152,6 @@ bool CYdLidar::checkLidarAbnormal()
   {
     // printf("checkLidarAbnormal %d\n", checkCount);
 
-    // Ensure that the voltage is insufficient or the motor resistance is high, 
-    //causing an abnormality.
-    if (checkCount)
-      delay(500);
-
     float scan_time = 0.0;
     uint64_t start_time = 0;
     uint64_t end_time = 0;
@@ -1114,20 +1172,7 @@ bool CYdLidar::checkLidarAbnormal()
       
       if (IS_OK(ret))
       {
-        // 获取CT信息
-        if (!(lidarPtr->getHasDeviceInfo() & EPT_Module))
-        {
-          // printf("Get module device info\n");
-          LaserDebug debug = {0};
-          for (int i = 0; i < count; ++i)
-          {
-            parsePackageNode(global_nodes[i], debug);
-            if (global_nodes[i].error)
-              debug.maxIndex = 255;
-          }
-          // 解析V2协议雷达扫描数据中ct信息中的设备信息
-          getDeviceInfoByPackage(debug);
-        }
+        checkModuleInfo(count);
 
         if (isNetTOFLidar(m_LidarType))
         {
@@ -1177,6 +1222,137 @@ bool CYdLidar::checkLidarAbnormal()
   return IS_OK(ret);
 }
 
+/*-------------------------------------------------------------
+                    checkLidarProfile
+-------------------------------------------------------------*/
+bool CYdLidar::checkLidarProfile()
+{
+  result_t ret = RESULT_FAIL;
+
+  //电机刚启动时转速可能尚未稳定，最多检查三圈
+  for (int i = 0; i < 3; ++i)
+  {
+    size_t count = ydlidar::YDlidarDriver::MAX_SCAN_NODES;
+    ret = lidarPtr->grabScanData(global_nodes, count);
+    if (!IS_OK(ret))
+      break;
+
+    checkModuleInfo(count);
+
+    if (isNetTOFLidar(m_LidarType))
+      return true;
+
+    if (std::abs(static_cast<int>(count) - m_Profile.fixedSize) <=
+        m_Profile.fixedSize / 10)
+    {
+      m_SampleRate = m_Profile.sampleRate;
+      m_PointTime = 1e9 / (m_SampleRate * 1000);
+      lidarPtr->setPointTime(m_PointTime);
+      m_FixedSize = m_Profile.fixedSize;
+      info("Lidar matches the cached profile, Sample Rate: %.02fK, Fixed Size: %d",
+        m_SampleRate, m_FixedSize);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/*-------------------------------------------------------------
+                    checkModuleInfo
+-------------------------------------------------------------*/
+void CYdLidar::checkModuleInfo(size_t count)
+{
+  // 获取CT信息
+  if (lidarPtr->getHasDeviceInfo() & EPT_Module)
+    return;
+
+  // printf("Get module device info\n");
+  LaserDebug debug = {0};
+  for (size_t i = 0; i < count; ++i)
+  {
+    parsePackageNode(global_nodes[i], debug);
+    if (global_nodes[i].error)
+      debug.maxIndex = 255;
+  }
+  // 解析V2协议雷达扫描数据中ct信息中的设备信息
+  getDeviceInfoByPackage(debug);
+}
+
+/*-------------------------------------------------------------
+                    profileKey
+-------------------------------------------------------------*/
+std::string CYdLidar::profileKey() const
+{
+  //单通雷达的序列号要扫描后才能获取，按端口区分
+  if (m_SingleChannel || m_SerialNumber.empty())
+    return "port:" + m_SerialPort;
+  return m_SerialNumber;
+}
+
+/*-------------------------------------------------------------
+                    loadProfile
+-------------------------------------------------------------*/
+bool CYdLidar::loadProfile()
+{
+  m_ProfileLoaded = false;
+  ydlidar::DeviceProfile p;
+  if (!ydlidar::loadDeviceProfile(m_ProfileFile, m_ProfileKey, p))
+    return false;
+
+  //单通雷达的型号和版本要扫描后才能获取，不参与比较
+  if (p.lidarType != m_LidarType ||
+      p.singleChannel != m_SingleChannel ||
+      (!m_SingleChannel && p.model != lidar_model) ||
+      (!m_SingleChannel && p.firmware != ((Major << 8) | Minjor)) ||
+      fabs(p.userSampleRate - m_UserSampleRate) > 0.01 ||
+      fabs(p.userScanFrequency - m_UserScanFrequency) > 0.01 ||
+      p.userIntensity != m_Intensity ||
+      p.fixedSize <= 0 ||
+      p.sampleRate <= 0)
+  {
+    info("Cached profile of the lidar [%s] does not match, ignored",
+      m_ProfileKey.c_str());
+    return false;
+  }
+
+  m_Profile = p;
+  m_ProfileLoaded = true;
+  return true;
+}
+
+/*-------------------------------------------------------------
+                    saveProfile
+-------------------------------------------------------------*/
+void CYdLidar::saveProfile()
+{
+  if (m_ProfileFile.empty())
+    return;
+
+  ydlidar::DeviceProfile p;
+  p.lidarType = m_LidarType;
+  p.model = lidar_model;
+  p.firmware = (Major << 8) | Minjor;
+  p.singleChannel = m_SingleChannel;
+  p.userSampleRate = m_UserSampleRate;
+  p.userScanFrequency = m_UserScanFrequency;
+  p.userIntensity = m_Intensity;
+  p.sampleRate = m_SampleRate;
+  p.scanFrequency = m_ScanFrequency;
+  p.fixedSize = m_FixedSize;
+  p.angleOffset = m_AngleOffset;
+  p.angleCorrected = m_isAngleOffsetCorrected;
+  p.intensity = lidarPtr->getIntensities();
+  p.intensityBit = lidarPtr->getIntensityBit();
+
+  if (ydlidar::saveDeviceProfile(m_ProfileFile, m_ProfileKey, p))
+    info("Saved the profile of the lidar [%s] to [%s]",
+      m_ProfileKey.c_str(), m_ProfileFile.c_str());
+  else
+    warn("Failed to save the profile of the lidar [%s] to [%s]",
+      m_ProfileKey.c_str(), m_ProfileFile.c_str());
+}
+
 /*-------------------------------------------------------------
                     removeExceptionSample
 -------------------------------------------------------------*/
@@ -1437,27 +1613,23 @@ bool CYdLidar::getDeviceInfo()
       di.model, di.firmware_version >> 8, di.firmware_version & 0x00ff);
   }
 
-  // uint32_t t = getms();
-  if (hasSampleRate(di.model))
+  m_ProfileKey = profileKey();
+  const bool cached = loadProfile();
+  if (cached)
   {
-    checkSampleRate();
+    //缓存的采样率和转速由启动后第一圈的点数校验，不符时重新查询
+    m_SampleRate = m_Profile.sampleRate;
+    defalutSampleRate.clear();
+    defalutSampleRate.push_back(m_SampleRate);
+    m_PointTime = 1e9 / (m_SampleRate * 1000);
+    lidarPtr->setPointTime(m_PointTime);
+    m_ScanFrequency = m_Profile.scanFrequency;
+    info("Cached sample rate: %.02fK, scan frequency: %.02fHz",
+      m_SampleRate, m_ScanFrequency);
   }
   else
   {
-    if (defalutSampleRate.size())
-    {
-      m_PointTime = 1e9 / (defalutSampleRate.front() * 1000);
-      lidarPtr->setPointTime(m_PointTime);
-    }
-  }
-
-  // printf("LIDAR get device info finished, Elapsed time %u ms\n", getms() - t);
-  //检查转速
-  if (hasScanFrequencyCtrl(di.model) || 
-    ((isTOFLidar(m_LidarType)) && !m_SingleChannel) || 
-      isNetTOFLidar(m_LidarType))
-  {
-    checkScanFrequency();
+    checkRates();
   }
 
   if (isSupportHeartBeat(di.model))
@@ -1472,7 +1644,19 @@ bool CYdLidar::getDeviceInfo()
 
   if (hasZeroAngle(di.model))
   {
-    ret &= checkCalibrationAngle(serial_number);
+    //零位角为出厂标定值，缓存有效时直接使用
+    if (cached)
+    {
+      m_AngleOffset = m_Profile.angleOffset;
+      m_isAngleOffsetCorrected = m_Profile.angleCorrected;
+      info("Cached %s offset angle[%f] of the lidar[%s]",
+        m_isAngleOffsetCorrected ? "corrected" : "uncorrrected", m_AngleOffset,
+        serial_number.c_str());
+    }
+    else
+    {
+      ret &= checkCalibrationAngle(serial_number);
+    }
   }
 
   return ret;
@@ -1516,6 +1700,33 @@ void CYdLidar::handleSingleChannelDevice()
   return;
 }
 
+/*-------------------------------------------------------------
+                    checkRates
+-------------------------------------------------------------*/
+void CYdLidar::checkRates()
+{
+  if (hasSampleRate(lidar_model))
+  {
+    checkSampleRate();
+  }
+  else
+  {
+    if (defalutSampleRate.size())
+    {
+      m_PointTime = 1e9 / (defalutSampleRate.front() * 1000);
+      lidarPtr->setPointTime(m_PointTime);
+    }
+  }
+
+  //检查转速
+  if (hasScanFrequencyCtrl(lidar_model) || 
+    ((isTOFLidar(m_LidarType)) && !m_SingleChannel) || 
+      isNetTOFLidar(m_LidarType))
+  {
+    checkScanFrequency();
+  }
+}
+
 /*-------------------------------------------------------------
                     checkSampleRate
 -------------------------------------------------------------*/
@@ -1741,9 +1952,9 @@ bool CYdLidar::checkConnect()
     else if (isGSLidar(m_LidarType)) //GS
       lidarPtr = new ydlidar::GSLidarDriver(m_DeviceType);
     else if (isSDMLidar(m_LidarType)) //SDM
-      lidarPtr = new ydlidar::SDMLidarDriver();
+      lidarPtr = new ydlidar::SDMLidarDriver(m_DeviceType);
     else if (isDTSLidar(m_LidarType)) //SDM
-      lidarPtr = new ydlidar::DTSLidarDriver();
+      lidarPtr = new ydlidar::DTSLidarDriver(m_DeviceType);
     else if (isTIALidar(m_LidarType))
       lidarPtr = new ydlidar::TiaLidarDriver();
     else //通用雷达
@@ -1777,6 +1988,8 @@ bool CYdLidar::checkConnect()
   lidarPtr->setIntensities(m_Intensity);
   lidarPtr->setIntensityBit(m_IntensityBit);
   lidarPtr->setAutoIntensity(m_AutoIntensity);
+  lidarPtr->setCaptureFile(m_CaptureFile);
+  lidarPtr->setReplayRealtime(m_ReplayRealtime);
 
   uint32_t t = getms();
 
@@ -1827,8 +2040,11 @@ bool CYdLidar::checkConnect()
 bool CYdLidar::checkStatus()
 {
   uint32_t t = getms();
+  m_ProfileKey.clear();
   getDeviceHealth();
   getDeviceInfo();
+  if (m_ProfileKey.empty())
+    m_ProfileKey = profileKey();
   info("Check status, Elapsed time %u ms", getms() - t);
 
   return true;
@@ -46,6 +46,8 @@
 #include <core/base/utils.h>
 #include <core/common/ydlidar_def.h>
 #include <core/common/DriverInterface.h>
+#include <core/base/clocksync.h>
+#include "DeviceProfile.h"
 #include <string>
 #include <map>
 
@@ -118,6 +120,15 @@ class YDLIDAR_API CYdLidar {
    * @return true if successfully started, otherwise false.
    */
   bool doProcessSimple(LaserScan &outscan);
+  /**
+   * @brief Wait for the next revolution and convert it.
+   * @param[out] outscan             LiDAR Scan Data
+   * @param[in] timeout              maximum wait in milliseconds
+   * @return true as soon as a revolution is complete, false on timeout or error.
+   * @note Unlike ::doProcessSimple a timeout is not an error, so a short timeout
+   * can be used to interleave other work between revolutions.
+   */
+  bool waitScan(LaserScan &outscan, uint32_t timeout);
   /**
    * @brief Stop the device scanning thread and disable motor.
    * @return true if successfully Stoped, otherwise false.
@@ -128,6 +139,14 @@ class YDLIDAR_API CYdLidar {
    */
   void disconnecting();
 
+  /**
+   * @brief Time from ::initialize to the first converted revolution.
+   * @return milliseconds, 0 until the first revolution has been converted
+   */
+  uint32_t getTimeToFirstScan() const {
+    return m_TimeToFirstScan;
+  }
+
   /**
    * @brief Get the last error information of a (socket or serial)
    * @return a human-readable description of the given error information
@@ -218,6 +237,12 @@ class YDLIDAR_API CYdLidar {
    */
   bool checkHardware();
 
+  /**
+   * @brief Wait for and convert one revolution
+   * @param quietTimeout whether a timeout is expected rather than an error
+   */
+  bool processScan(LaserScan &outscan, uint32_t timeout, bool quietTimeout);
+
   /**
    * @brief Get LiDAR Health state
    * @return true if the device is in good health, If it's not
@@ -247,12 +272,46 @@ class YDLIDAR_API CYdLidar {
    */
   void checkSampleRate();
 
+  /*!
+   * @brief query and adjust the sample rate and scan frequency the LiDAR
+   * model supports
+   */
+  void checkRates();
+
   /**
    * @brief check LiDAR Data state
    * @return true if LiDAR Data is Normal, otherwise false.
    */
   bool checkLidarAbnormal();
 
+  /**
+   * @brief Accept the LiDAR on its first revolutions using the cached profile.
+   * @return false if no revolution matches the profile
+   */
+  bool checkLidarProfile();
+
+  /**
+   * @brief Load the cached profile matching the current LiDAR and request.
+   * @return true if ::m_Profile is usable
+   */
+  bool loadProfile();
+
+  /**
+   * @brief Store the settings probed during bring-up.
+   */
+  void saveProfile();
+
+  /**
+   * @brief Profile key, serial number or port for LiDARs without one.
+   */
+  std::string profileKey() const;
+
+  /**
+   * @brief Parse module device info from the CT of a revolution.
+   * @param count number of nodes in ::global_nodes
+   */
+  void checkModuleInfo(size_t count);
+
   /**
    * @brief Calculate LiDAR Sampling rate
    * @param count       LiDAR Points
@@ -294,15 +353,6 @@ class YDLIDAR_API CYdLidar {
     */
   bool getDeviceInfoByPackage(const LaserDebug &debug);
 
-  /**
-   * @brief Calculate real-time sampling frequency
-   * @param frequency       LiDAR current Scan Frequency
-   * @param count           LiDAR Points
-   * @param tim_scan_end    Last Scan Point Time Stamp
-   * @param tim_scan_start  First Scan Point Time Stamp
-   */
-  void resample(int frequency, int count, uint64_t tim_scan_end,
-                uint64_t tim_scan_start);
   /**
    * @brief Get zero correction angle
    * @return zero correction angle
@@ -315,7 +365,24 @@ class YDLIDAR_API CYdLidar {
    */
   bool isAngleOffsetCorrected() const;
 
+  /**
+   * @brief Prepare the point conversion parameters of the current LiDAR
+   * @note Call once the LiDAR model, firmware version and zero offset angle
+   * are known, so that ::doProcessSimple need not check them per point.
+   */
+  void updateConvertParam();
+
  private:
+  /// Point conversion parameters, chosen once per LiDAR model
+  struct ConvertParam {
+    int angleShift;   ///< raw angle right shift
+    float angleScale; ///< raw angle to radian scale (negative if inverted)
+    float angleBase;  ///< radian offset (zero offset angle and reversion)
+    float distScale;  ///< raw distance to meter scale
+    float freqScale;  ///< raw scan frequency scale
+    float freqOffset; ///< scan frequency offset
+  };
+
   int     m_FixedSize;              ///< Fixed LiDAR Points
   float   m_AngleOffset;            ///< Zero angle offset value
   bool    m_isAngleOffsetCorrected; ///< Has the Angle offset been corrected
@@ -325,11 +392,9 @@ class YDLIDAR_API CYdLidar {
   uint8_t Minjor;                   ///< Firmware Minjor Version
   ydlidar::core::common::DriverInterface *lidarPtr; ///< LiDAR Driver Interface pointer
   uint64_t m_PointTime;             ///< Time interval between two sampling point
-  uint64_t last_node_time;          ///< Latest LiDAR Start Node Time
   node_info *global_nodes;          ///< global nodes buffer
-  double last_frequency;            ///< Latest Scan Frequency
-  uint64_t m_FristNodeTime;         ///< Calculate real-time sample rate start time
-  uint64_t m_AllNode;               ///< Sum of sampling points
+  uint64_t m_PointIndex;            ///< Index of the next sampling point since scanning started
+  ydlidar::core::base::ClockSync m_ClockSync; ///< Sampling point index to time model
   std::map<int, int> SampleRateMap; ///< Sample Rate Map
   std::string m_SerialNumber;       ///< LiDAR serial number
   // int defalutSampleRate;            ///< LiDAR Default Sampling Rate
@@ -337,11 +402,20 @@ class YDLIDAR_API CYdLidar {
   float m_field_of_view;            ///< LiDAR Field of View Angle.
   LidarVersion m_LidarVersion;      ///< LiDAR Version information
   float zero_offset_angle_scale;   ///< LiDAR Zero Offset Angle
+  ConvertParam m_Convert;           ///< LiDAR point conversion parameters
+  ydlidar::DeviceProfile m_Profile; ///< Cached settings of this LiDAR
+  std::string m_ProfileKey;         ///< Key of this LiDAR in the profile file
+  bool m_ProfileLoaded;             ///< Whether m_Profile matches this LiDAR
+  uint32_t m_InitTime;              ///< Time initialize started, in milliseconds
+  uint32_t m_TimeToFirstScan;       ///< Time to the first revolution, in milliseconds
+  bool m_FirstScanPending;          ///< Whether no revolution has been converted yet
 
  private:
   std::string m_SerialPort;         ///< LiDAR serial port
   std::string m_IgnoreString;       ///< LiDAR ignore array string
   std::vector<float> m_IgnoreArray; ///< LiDAR ignore array
+  std::string m_CaptureFile;        ///< Raw byte stream capture file
+  std::string m_ProfileFile;        ///< Cached device profile file
 
   bool m_FixedResolution;           ///< LiDAR fixed angle resolution
   bool m_Reversion;                 ///< LiDAR reversion
@@ -353,11 +427,13 @@ class YDLIDAR_API CYdLidar {
   bool m_AutoIntensity; //自动识别强度
   bool m_SupportMotorDtrCtrl;       ///< LiDAR Motor DTR
   bool m_SupportHearBeat;           ///< LiDAR HeartBeat
+  bool m_ReplayRealtime;            ///< Replay capture file at recorded pace
 
   int m_SerialBaudrate;             ///< LiDAR serial baudrate or network port
   int m_LidarType;                  ///< LiDAR type
   int m_DeviceType;                 ///< LiDAR device type
   float m_SampleRate;                 ///< LiDAR sample rate
+  float m_UserSampleRate;           ///< LiDAR sample rate requested by the user
   int m_SampleRatebyD1;             ///< LiDAR sample rate by d1
   int m_AbnormalCheckCount;         ///< LiDAR abnormal count
 
@@ -366,6 +442,7 @@ class YDLIDAR_API CYdLidar {
   float m_MaxRange;                 ///< LiDAR maximum range
   float m_MinRange;                 ///< LiDAR minimum range
   float m_ScanFrequency;            ///< LiDAR scanning frequency
+  float m_UserScanFrequency;        ///< LiDAR scanning frequency requested by the user
   bool m_Bottom = true; //是否底板优先
   bool m_Debug = false; //是否启用调试
 
@@ -373,7 +450,6 @@ class YDLIDAR_API CYdLidar {
   bool m_GlassNoise = false; //玻璃噪点过滤标识
   std::string otaName; //OTA文件路径
   bool otaEncode = true; //OTA是否加密
-  uint64_t lastStamp = 0; //时间戳
 };	// End of class
 #endif // CYDLIDAR_H
 
@@ -0,0 +1,215 @@
+#include "CYdLidarGroup.h"
+#include <math.h>
+#include <algorithm>
+#include <thread>
+
+//各雷达链路相互独立，同时启动时总耗时取决于最慢的一台
+template <typename F>
+static bool forEachConcurrently(size_t n, F f)
+{
+  std::vector<char> ok(n, 0);
+  std::vector<std::thread> threads;
+  threads.reserve(n);
+
+  for (size_t i = 0; i < n; ++i)
+    threads.emplace_back([&ok, &f, i]() { ok[i] = f(i); });
+
+  bool ret = n > 0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    threads[i].join();
+    ret = ok[i] && ret;
+  }
+
+  return ret;
+}
+
+CYdLidarGroup::CYdLidarGroup()
+  : m_maxSkew(0)
+{
+}
+
+CYdLidarGroup::~CYdLidarGroup()
+{
+}
+
+void CYdLidarGroup::addLidar(CYdLidar *lidar, const LidarMount &mount)
+{
+  if (!lidar)
+    return;
+
+  Member m = Member();
+  m.lidar = lidar;
+  m.mount = mount;
+  m.valid = false;
+  m_members.push_back(m);
+}
+
+bool CYdLidarGroup::setlidaropt(int optname, const void *optval, int optlen)
+{
+  bool ret = !m_members.empty();
+
+  for (size_t i = 0; i < m_members.size(); ++i)
+    ret = m_members[i].lidar->setlidaropt(optname, optval, optlen) && ret;
+
+  return ret;
+}
+
+bool CYdLidarGroup::initialize()
+{
+  return forEachConcurrently(m_members.size(), [this](size_t i) {
+    return m_members[i].lidar->initialize();
+  });
+}
+
+bool CYdLidarGroup::turnOn()
+{
+  for (size_t i = 0; i < m_members.size(); ++i)
+    m_members[i].valid = false;
+
+  return forEachConcurrently(m_members.size(), [this](size_t i) {
+    return m_members[i].lidar->turnOn();
+  });
+}
+
+bool CYdLidarGroup::turnOff()
+{
+  for (size_t i = 0; i < m_members.size(); ++i)
+    m_members[i].lidar->turnOff();
+
+  return true;
+}
+
+void CYdLidarGroup::disconnecting()
+{
+  for (size_t i = 0; i < m_members.size(); ++i)
+    m_members[i].lidar->disconnecting();
+}
+
+bool CYdLidarGroup::isScanning() const
+{
+  return !m_members.empty() && m_members[0].lidar->isScanning();
+}
+
+bool CYdLidarGroup::waitScan(LaserScan &outscan, uint32_t timeout)
+{
+  if (m_members.empty())
+    return false;
+
+  //以第一个雷达为基准，阻塞等待其一圈数据
+  Member &ref = m_members[0];
+  if (!ref.lidar->waitScan(ref.next, timeout))
+    return false;
+
+  std::swap(ref.scan, ref.next);
+  ref.valid = true;
+
+  uint64_t skew = m_maxSkew;
+  if (!skew)
+    skew = static_cast<uint64_t>(ref.scan.config.scan_time * 1e9);
+
+  outscan.stamp = ref.scan.stamp;
+  outscan.scanFreq = ref.scan.scanFreq;
+  outscan.sampleRate = ref.scan.sampleRate;
+  outscan.config = ref.scan.config;
+  outscan.moduleNum = ref.scan.moduleNum;
+  outscan.envFlag = ref.scan.envFlag;
+  outscan.points.clear();
+  appendScan(ref, outscan);
+
+  bool merged = false;
+
+  for (size_t i = 1; i < m_members.size(); ++i)
+  {
+    Member &m = m_members[i];
+
+    //其它雷达不等待，取已就绪的最新一圈
+    if (m.lidar->isScanning() && m.lidar->waitScan(m.next, 0))
+    {
+      std::swap(m.scan, m.next);
+      m.valid = true;
+    }
+
+    if (!m.valid)
+      continue;
+
+    uint64_t diff = m.scan.stamp > ref.scan.stamp ?
+      m.scan.stamp - ref.scan.stamp : ref.scan.stamp - m.scan.stamp;
+    if (diff > skew)
+      continue;
+
+    appendScan(m, outscan);
+    merged = true;
+
+    LaserConfig &cfg = outscan.config;
+    cfg.angle_increment = std::min(cfg.angle_increment, m.scan.config.angle_increment);
+    cfg.min_range = std::min(cfg.min_range, m.scan.config.min_range);
+    cfg.max_range = std::max(cfg.max_range, m.scan.config.max_range);
+  }
+
+  //合并后点按所在雷达排列，点间时间间隔不再有意义
+  if (merged || ref.mount.x != 0.0f || ref.mount.y != 0.0f || ref.mount.yaw != 0.0f)
+  {
+    outscan.config.min_angle = -M_PI;
+    outscan.config.max_angle = M_PI;
+  }
+  if (merged)
+    outscan.config.time_increment = 0.0f;
+
+  outscan.size = outscan.points.size();
+  return true;
+}
+
+void CYdLidarGroup::appendScan(const Member &m, LaserScan &outscan)
+{
+  const LidarMount &mount = m.mount;
+  const std::vector<LaserPoint> &points = m.scan.points;
+  size_t n = outscan.points.size();
+  outscan.points.resize(n + points.size());
+  LaserPoint *out = outscan.points.data() + n;
+
+  if (mount.x == 0.0f && mount.y == 0.0f)
+  {
+    if (mount.yaw == 0.0f)
+    {
+      //安装在原点，直接复制
+      std::copy(points.begin(), points.end(), out);
+      return;
+    }
+
+    //只有旋转时角度直接相加
+    const float two_pi = static_cast<float>(2.0 * M_PI);
+    const float pi = static_cast<float>(M_PI);
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      out[i] = points[i];
+      float angle = points[i].angle + mount.yaw;
+      out[i].angle = angle - two_pi * ceilf((angle - pi) / two_pi);
+    }
+    return;
+  }
+
+  const float c = cosf(mount.yaw);
+  const float s = sinf(mount.yaw);
+  size_t count = 0;
+
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    const LaserPoint &p = points[i];
+
+    //无效点平移后没有意义
+    if (p.range <= 0.0f)
+      continue;
+
+    float x = p.range * cosf(p.angle);
+    float y = p.range * sinf(p.angle);
+    float gx = mount.x + c * x - s * y;
+    float gy = mount.y + s * x + c * y;
+    LaserPoint &q = out[count++];
+    q.range = sqrtf(gx * gx + gy * gy);
+    q.angle = atan2f(gy, gx);
+    q.intensity = p.intensity;
+  }
+
+  outscan.points.resize(n + count);
+}
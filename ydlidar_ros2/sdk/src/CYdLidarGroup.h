@@ -0,0 +1,88 @@
+#ifndef CYDLIDARGROUP_H
+#define CYDLIDARGROUP_H
+#include "CYdLidar.h"
+#include <vector>
+
+
+/**
+ * @brief Mounting pose of a LiDAR in the common frame
+ */
+struct LidarMount {
+  float x = .0; //单位米
+  float y = .0; //单位米
+  float yaw = .0; //单位弧度
+};
+
+/**
+ * @brief Several LiDARs merged into one scan in a common frame.
+ * @note The first LiDAR added is the reference: ::waitScan blocks on its
+ * revolutions and merges in the newest revolution of every other LiDAR
+ * whose stamp lies within ::setMaxSkew of it. Receiving already runs on
+ * the shared I/O reactor thread, the group adds no thread of its own and
+ * reuses every buffer from one revolution to the next.
+ */
+class YDLIDAR_API CYdLidarGroup {
+ public:
+  CYdLidarGroup();
+  ~CYdLidarGroup();
+
+  /**
+   * @brief Add a LiDAR to the group, it is not owned by the group.
+   * @param lidar LiDAR, its port must be set already
+   * @param mount mounting pose in the common frame
+   */
+  void addLidar(CYdLidar *lidar, const LidarMount &mount = LidarMount());
+
+  size_t size() const {
+    return m_members.size();
+  }
+
+  CYdLidar *lidar(size_t index) const {
+    return m_members[index].lidar;
+  }
+
+  /**
+   * @brief Maximum stamp difference to the reference revolution.
+   * @param ns nanoseconds, 0 means one reference scan period
+   */
+  void setMaxSkew(uint64_t ns) {
+    m_maxSkew = ns;
+  }
+
+  /// Set the same option on every LiDAR, see ::CYdLidar::setlidaropt
+  bool setlidaropt(int optname, const void *optval, int optlen);
+
+  /// Initialize every LiDAR concurrently, false if any of them fails
+  bool initialize();
+  /// Start every LiDAR concurrently, false if any of them fails
+  bool turnOn();
+  bool turnOff();
+  void disconnecting();
+  /// Whether the reference LiDAR is scanning
+  bool isScanning() const;
+
+  /**
+   * @brief Wait for the next reference revolution and merge the others.
+   * @param[out] outscan merged scan in the common frame
+   * @param[in] timeout  maximum wait in milliseconds
+   * @return true once a merged revolution is ready, false on timeout or error.
+   */
+  bool waitScan(LaserScan &outscan, uint32_t timeout);
+
+ private:
+  struct Member {
+    CYdLidar *lidar;
+    LidarMount mount;
+    LaserScan scan; //最新一圈
+    LaserScan next; //接收缓存，获取成功后与scan交换
+    bool valid;
+  };
+
+  //将一圈点转换到公共坐标系后追加到outscan
+  static void appendScan(const Member &m, LaserScan &outscan);
+
+  std::vector<Member> m_members;
+  uint64_t m_maxSkew;
+};
+
+#endif // CYDLIDARGROUP_H
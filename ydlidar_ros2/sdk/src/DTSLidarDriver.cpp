@@ -2,6 +2,7 @@
 #include <algorithm>
 #include "DTSLidarDriver.h"
 #include "core/serial/common.h"
+#include "core/common/ChannelCapture.h"
 #include "ydlidar_config.h"
 
 
@@ -9,7 +10,7 @@ using namespace impl;
 namespace ydlidar
 {
 
-DTSLidarDriver::DTSLidarDriver()
+DTSLidarDriver::DTSLidarDriver(uint8_t type)
     : _serial(NULL)
 {
     //串口配置参数
@@ -20,11 +21,11 @@ DTSLidarDriver::DTSLidarDriver()
     retryCount = 0;
     m_SingleChannel = false;
     m_LidarType = TYPE_SDM18;
+    m_DeviceType = type;
 
     nodeIndex = 0;
     recvBuff = std::vector<uint8_t>(SDKDTSPCSSIZE, 0);
-    scan_node_count = 0;
-    scan_node_buf = new node_info[SDK_DTS_POINT_COUNT * 5];
+    scan_node_buf.reserve(SDK_DTS_POINT_COUNT * 5);
 }
 
 DTSLidarDriver::~DTSLidarDriver()
@@ -46,16 +47,6 @@ DTSLidarDriver::~DTSLidarDriver()
             _serial = NULL;
         }
     }
-
-    {
-        ScopedLocker l(_lock);
-        if (scan_node_buf)
-        {
-            delete[] scan_node_buf;
-            scan_node_buf = NULL;
-        }
-        scan_node_count = 0;
-    }
 }
 
 result_t DTSLidarDriver::connect(const char *port, uint32_t baudrate)
@@ -66,10 +57,24 @@ result_t DTSLidarDriver::connect(const char *port, uint32_t baudrate)
         ScopedLocker l(_cmd_lock);
         if (!_serial)
         {
-            _serial = new serial::Serial(
-                m_port,
-                m_baudrate,
-                serial::Timeout::simpleTimeout(DEFAULT_TIMEOUT));
+            if (m_DeviceType == YDLIDAR_TYPE_REPLAY)
+            {
+                _serial = new core::common::ChannelReplay(m_ReplayRealtime);
+            }
+            else
+            {
+                _serial = new serial::Serial(
+                    m_port,
+                    m_baudrate,
+                    serial::Timeout::simpleTimeout(DEFAULT_TIMEOUT));
+            }
+            //录制原始数据
+            if (!m_CaptureFile.empty())
+            {
+                _serial = new core::common::ChannelRecorder(
+                    _serial, m_CaptureFile);
+            }
+            _serial->bindport(port, baudrate);
         }
         if (!_serial->open())
         {
@@ -142,44 +147,6 @@ result_t DTSLidarDriver::stop()
     return RESULT_OK;
 }
 
-/*
- * @brief 获取激光数据
- * @param nodebuffer out: 激光点信息
- * @param count      in: 一圈激光点数
- * @param timeout    in: 超时时间
- * @return
- */
-result_t DTSLidarDriver::grabScanData(
-    node_info *nodebuffer, 
-    size_t &count, 
-    uint32_t timeout)
-{
-    result_t ret = RESULT_FAIL;
-    switch (_dataEvent.wait(timeout))
-    {
-    case Event::EVENT_TIMEOUT:
-        count = 0;
-        ret = RESULT_TIMEOUT;
-        break;
-    case Event::EVENT_OK:
-    {
-        ScopedLocker l(_lock);
-        count = min(count, scan_node_count);
-        memcpy(nodebuffer, scan_node_buf, count * SDKNODESIZE);
-        scan_node_count = 0;
-        ret = RESULT_OK;
-        _dataEvent.set(false); //重置状态
-        break;
-    }
-    default:
-        count = 0;
-        ret = RESULT_FAIL;
-        break;
-    }
-
-    return ret;
-}
-
 /*
  * @brief 等待扫描数据
  * @param nodes   out:存储节点信息的数组
@@ -278,9 +245,11 @@ int DTSLidarDriver::cacheScanData()
             timeout_count = 0;
             retryCount = 0;
 
-            ScopedLocker l(_lock);
-            memcpy(scan_node_buf, local_buf, sizeof(node_info) * count);
-            scan_node_count = count;
+            ScanNodes &scan = scan_node_buf.back();
+            scan.clear();
+            for (size_t i = 0; i < count; ++i)
+                scan.push(local_buf[i]);
+            scan_node_buf.publish();
             _dataEvent.set();
         }
     }
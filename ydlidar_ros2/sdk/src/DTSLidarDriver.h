@@ -82,23 +82,13 @@ using namespace core::base;
 class DTSLidarDriver : public DriverInterface
 {
 public:
-    DTSLidarDriver();
+    DTSLidarDriver(uint8_t type = YDLIDAR_TYPE_SERIAL);
     virtual ~DTSLidarDriver();
 
     result_t connect(const char *port, uint32_t baudrate);
     void disconnect();
     result_t stopScan(uint32_t timeout = DEFAULT_TIMEOUT / 2);
     result_t stop();
-    /*
-     * @brief 获取激光数据
-     * @param nodebuffer out: 激光点信息
-     * @param count      in: 一圈激光点数
-     * @param timeout    in: 超时时间
-     * @return
-     */
-    result_t grabScanData(node_info *nodebuffer, size_t &count,
-                          uint32_t timeout = DEFAULT_TIMEOUT);
-
     /*
      * @brief 等待扫描数据
      * @param nodes   out:存储节点信息的数组
@@ -199,7 +189,7 @@ public:
     uint16_t calculateCrc(const vector<uint8_t>& data);
 
 private:
-    serial::Serial *_serial = nullptr; //串口
+    core::common::ChannelDevice *_serial = nullptr; //串口或回放通道
     std::vector<uint8_t> recvBuff; //一包数据缓存
     float k = 0; //校准参数k
     float b = 0; //校准参数b
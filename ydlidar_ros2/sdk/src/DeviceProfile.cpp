@@ -0,0 +1,175 @@
+#include "DeviceProfile.h"
+#include <stdio.h>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace ydlidar {
+
+//同一进程内多台雷达共用一个文件
+static std::mutex g_ProfileLock;
+
+static bool readLines(const std::string &file, std::vector<std::string> &lines)
+{
+  FILE *fp = fopen(file.c_str(), "r");
+  if (!fp)
+    return false;
+
+  char buf[512];
+  while (fgets(buf, sizeof(buf), fp))
+  {
+    std::string line(buf);
+    while (!line.empty() &&
+           (line.back() == '\n' || line.back() == '\r'))
+      line.pop_back();
+    if (!line.empty())
+      lines.push_back(line);
+  }
+  fclose(fp);
+  return true;
+}
+
+static bool writeLines(const std::string &file,
+                       const std::vector<std::string> &lines)
+{
+  //先写临时文件再改名，掉电时不会留下半行；
+  //临时文件名唯一，多个进程同时保存时不会写到同一个文件
+  std::vector<char> name(file.begin(), file.end());
+  const char suffix[] = ".XXXXXX";
+  name.insert(name.end(), suffix, suffix + sizeof(suffix));
+#if defined(_WIN32)
+  FILE *fp = NULL;
+  if (_mktemp_s(&name[0], name.size()) == 0)
+    fp = fopen(&name[0], "wx");
+#else
+  int fd = mkstemp(&name[0]);
+  //mkstemp按0600创建，与改名前的缓存文件权限保持一致
+  if (fd >= 0)
+    fchmod(fd, 0644);
+  FILE *fp = fd < 0 ? NULL : fdopen(fd, "w");
+  if (fd >= 0 && !fp)
+    close(fd);
+#endif
+  if (!fp)
+    return false;
+  std::string tmp(&name[0]);
+
+  bool ret = true;
+  for (size_t i = 0; i < lines.size(); ++i)
+    ret = fprintf(fp, "%s\n", lines[i].c_str()) > 0 && ret;
+  ret = fclose(fp) == 0 && ret;
+
+  if (!ret || rename(tmp.c_str(), file.c_str()) != 0)
+  {
+    remove(tmp.c_str());
+    return false;
+  }
+  return true;
+}
+
+static std::string lineKey(const std::string &line)
+{
+  return line.substr(0, line.find(' '));
+}
+
+bool loadDeviceProfile(const std::string &file, const std::string &key,
+                       DeviceProfile &profile)
+{
+  if (file.empty() || key.empty())
+    return false;
+
+  std::vector<std::string> lines;
+  {
+    std::lock_guard<std::mutex> lock(g_ProfileLock);
+    if (!readLines(file, lines))
+      return false;
+  }
+
+  for (size_t i = 0; i < lines.size(); ++i)
+  {
+    if (lineKey(lines[i]) != key)
+      continue;
+
+    std::istringstream is(lines[i]);
+    std::string k;
+    DeviceProfile p;
+    is >> k >> p.lidarType >> p.model >> p.firmware >> p.singleChannel
+       >> p.userSampleRate >> p.userScanFrequency >> p.userIntensity
+       >> p.sampleRate >> p.scanFrequency >> p.fixedSize
+       >> p.angleOffset >> p.angleCorrected
+       >> p.intensity >> p.intensityBit;
+    if (is.fail())
+      return false;
+
+    profile = p;
+    return true;
+  }
+
+  return false;
+}
+
+bool saveDeviceProfile(const std::string &file, const std::string &key,
+                       const DeviceProfile &profile)
+{
+  if (file.empty() || key.empty())
+    return false;
+
+  char buf[512];
+  snprintf(buf, sizeof(buf),
+           "%s %d %d %d %d %g %g %d %g %g %d %g %d %d %d",
+           key.c_str(), profile.lidarType, profile.model, profile.firmware,
+           profile.singleChannel, profile.userSampleRate,
+           profile.userScanFrequency, profile.userIntensity,
+           profile.sampleRate, profile.scanFrequency, profile.fixedSize,
+           profile.angleOffset, profile.angleCorrected,
+           profile.intensity, profile.intensityBit);
+
+  std::lock_guard<std::mutex> lock(g_ProfileLock);
+  std::vector<std::string> lines;
+  readLines(file, lines);
+
+  bool found = false;
+  for (size_t i = 0; i < lines.size(); ++i)
+  {
+    if (lineKey(lines[i]) == key)
+    {
+      lines[i] = buf;
+      found = true;
+    }
+  }
+  if (!found)
+    lines.push_back(buf);
+
+  return writeLines(file, lines);
+}
+
+bool eraseDeviceProfile(const std::string &file, const std::string &key)
+{
+  if (file.empty() || key.empty())
+    return false;
+
+  std::lock_guard<std::mutex> lock(g_ProfileLock);
+  std::vector<std::string> lines;
+  if (!readLines(file, lines))
+    return false;
+
+  std::vector<std::string> kept;
+  for (size_t i = 0; i < lines.size(); ++i)
+  {
+    if (lineKey(lines[i]) != key)
+      kept.push_back(lines[i]);
+  }
+  if (kept.size() == lines.size())
+    return true;
+
+  return writeLines(file, kept);
+}
+
+}//namespace ydlidar
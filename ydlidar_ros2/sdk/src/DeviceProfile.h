@@ -0,0 +1,54 @@
+#ifndef DEVICEPROFILE_H
+#define DEVICEPROFILE_H
+#include <string>
+
+
+namespace ydlidar {
+
+/**
+ * @brief Settings probed from a LiDAR during bring-up, cached on disk so
+ * the next start of the same unit can skip the slow queries.
+ * @note A profile is only valid for the request it was probed with, the
+ * requested sample rate, scan frequency and intensity are part of it.
+ */
+struct DeviceProfile {
+  int lidarType = 0; //雷达类型
+  int model = 0; //雷达型号码
+  int firmware = 0; //固件版本，主版本在高字节
+  bool singleChannel = false; //单通雷达
+  float userSampleRate = .0f; //用户设置的采样率
+  float userScanFrequency = .0f; //用户设置的转速
+  bool userIntensity = false; //用户设置的强度
+  float sampleRate = .0f; //实际采样率，单位K
+  float scanFrequency = .0f; //实际转速
+  int fixedSize = 0; //一圈点数
+  float angleOffset = .0f; //零位角
+  bool angleCorrected = false; //零位角是否已校正
+  bool intensity = false; //识别到的强度
+  int intensityBit = 0; //识别到的强度位数
+};
+
+/**
+ * @brief Read the profile stored under key.
+ * @param file profile file, one line per LiDAR
+ * @param key serial number, or port for LiDARs without one
+ * @return false if the file or the key does not exist
+ */
+bool loadDeviceProfile(const std::string &file, const std::string &key,
+                       DeviceProfile &profile);
+
+/**
+ * @brief Store profile under key, replacing an older one.
+ * @note Several LiDARs may share a file, it is rewritten atomically.
+ */
+bool saveDeviceProfile(const std::string &file, const std::string &key,
+                       const DeviceProfile &profile);
+
+/**
+ * @brief Drop the profile stored under key.
+ */
+bool eraseDeviceProfile(const std::string &file, const std::string &key);
+
+}//namespace ydlidar
+
+#endif // DEVICEPROFILE_H
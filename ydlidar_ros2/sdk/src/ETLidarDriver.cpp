@@ -59,10 +59,20 @@ ETLidarDriver::ETLidarDriver() :
   socket_data->SetSocketType(CSimpleSocket::SocketTypeUdp);
   socket_cmd->SetConnectTimeout(DEFAULT_CONNECTION_TIMEOUT_SEC,
                                 DEFAULT_CONNECTION_TIMEOUT_USEC);
-  scan_node_buf = new node_info[MAX_SCAN_NODES];
-  scan_node_count = 0;
+  scan_node_buf.reserve(MAX_SCAN_NODES);
   m_lastAngle = 0.f;
   m_currentAngle = 0.f;
+  m_frameStamp = 0;
+  m_framePool = new uint8_t[ETLIDAR_FRAME_POOL * UDP_FRAME_SIZE];
+  m_frames = new Datagram[ETLIDAR_FRAME_POOL];
+  m_frameCount = 0;
+  m_frameNext = 0;
+  m_framesInvalid = 0;
+  m_framesDropped = 0;
+  m_framesTruncated = 0;
+  m_dropReportTime = 0;
+  memset(&frame, 0, sizeof(frame));
+  frame.frameBuf = m_framePool;
   nodeIndex = 0;
   retryCount = 0;
   isAutoReconnect = true;
@@ -103,10 +113,8 @@ ETLidarDriver::~ETLidarDriver() {
     socket_cmd = NULL;
   }
 
-  if (scan_node_buf) {
-    delete[]  scan_node_buf;
-    scan_node_buf = nullptr;
-  }
+  delete[] m_frames;
+  delete[] m_framePool;
 }
 
 void ETLidarDriver::updateScanCfg(const lidarConfig &config) {
@@ -627,6 +635,16 @@ bool ETLidarDriver::dataPortConnect(const char *lidarIP, int localPort) {
 
       socket_data->SetReceiveTimeout(DEFAULT_TIMEOUT / 1000,
                                      (DEFAULT_TIMEOUT % 1000) * 1000);
+      //网络雷达小包多，放大接收缓存，并由内核标记接收时间和丢包数
+      socket_data->SetReceiveWindowSize(ETLIDAR_RCVBUF_SIZE);
+      socket_data->SetReceiveTimestamps(true);
+      socket_data->SetDropCounting(true);
+      //新套接字的内核丢包计数从0开始，已报告的计数随之清零
+      socket_data->ResetDatagramCounters();
+      m_framesDropped = 0;
+      m_framesTruncated = 0;
+      m_frameCount = 0;
+      m_frameNext = 0;
     }
   }
 
@@ -645,34 +663,6 @@ void ETLidarDriver::disableDataGrabbing() {
   _thread.join();
 }
 
-result_t ETLidarDriver::grabScanData(node_info *nodebuffer, size_t &count,
-                                     uint32_t timeout) {
-  switch (_dataEvent.wait(timeout)) {
-    case Event::EVENT_TIMEOUT:
-      count = 0;
-      return RESULT_TIMEOUT;
-
-    case Event::EVENT_OK: {
-      if (scan_node_count == 0) {
-        return RESULT_FAIL;
-      }
-
-      ScopedLocker l(_lock);
-      size_t size_to_copy = std::min(count, scan_node_count);
-      memcpy(nodebuffer, scan_node_buf, size_to_copy * sizeof(node_info));
-      count = size_to_copy;
-      scan_node_count = 0;
-    }
-
-    return RESULT_OK;
-
-    default:
-      count = 0;
-      return RESULT_FAIL;
-  }
-
-}
-
 result_t ETLidarDriver::getScanFrequency(scan_frequency &frequency,
     uint32_t timeout) {
   lidarConfig cfg;
@@ -1008,10 +998,9 @@ void ETLidarDriver::CheckLaserStatus() {
 int ETLidarDriver::cacheScanData() {
   node_info      local_buf[100];
   size_t         count = 100;
-  node_info      local_scan[MAX_SCAN_NODES];
-  size_t         scan_count = 0;
+  ScanNodes     *local_scan = &scan_node_buf.back();
   result_t       ans = RESULT_FAIL;
-  memset(local_scan, 0, sizeof(local_scan));
+  local_scan->clear();
   waitScanData(local_buf, count);
 
   int timeout_count   = 0;
@@ -1043,7 +1032,7 @@ int ETLidarDriver::cacheScanData() {
 
           if (IS_OK(ans)) {
             timeout_count = 0;
-            local_scan[0].sync = NODE_UNSYNC;
+            local_scan->clear();
           } else {
             m_isScanning = false;
             return RESULT_FAIL;
@@ -1051,7 +1040,7 @@ int ETLidarDriver::cacheScanData() {
         }
       } else {
         timeout_count++;
-        local_scan[0].sync = NODE_UNSYNC;
+        local_scan->clear();
 
         if (m_driverErrno == NoError) {
           setDriverError(TimeoutError);
@@ -1074,25 +1063,21 @@ int ETLidarDriver::cacheScanData() {
 
     for (size_t pos = 0; pos < count; ++pos) {
       if (local_buf[pos].sync & LIDAR_RESP_SYNCBIT) {
-        if ((local_scan[0].sync & LIDAR_RESP_SYNCBIT)) {
-          _lock.lock();//timeout lock, wait resource copy
-          local_scan[0].stamp = local_buf[pos].stamp;
-          local_scan[0].delayTime = local_buf[pos].delayTime;
-          local_scan[0].scanFreq = local_buf[pos].scanFreq;
-          memcpy(scan_node_buf, local_scan, scan_count * sizeof(node_info));
-          scan_node_count = scan_count;
+        if (!local_scan->empty() &&
+            (local_scan->sync()[0] & LIDAR_RESP_SYNCBIT)) {
+          //各包保留自身时间戳，由上层拟合每点采集时间
+          ScanNodes::Packet &head = local_scan->packet(0);
+          head.delayTime = local_buf[pos].delayTime;
+          head.scanFreq = local_buf[pos].scanFreq;
+          scan_node_buf.publish();
+          local_scan = &scan_node_buf.back();
           _dataEvent.set();
-          _lock.unlock();
         }
 
-        scan_count = 0;
+        local_scan->clear();
       }
 
-      local_scan[scan_count++] = local_buf[pos];
-
-      if (scan_count == _countof(local_scan)) {
-        scan_count -= 1;
-      }
+      local_scan->push(local_buf[pos]);
     }
   }
 
@@ -1153,9 +1138,13 @@ result_t ETLidarDriver::waitPackage(node_info *node, uint32_t timeout) {
   }
 
   (*node).sync =  NODE_UNSYNC;
+  (*node).is = 0;
+  (*node).stamp = m_frameStamp;
+  (*node).delayTime = 0;
   (*node).scanFreq = 0;
   (*node).debugInfo = 0xff;
   (*node).index = 0xff;
+  (*node).error = 0;
 
   offset = frame.dataIndex + 4 * nodeIndex;
   (*node).dist = static_cast<uint16_t>(DSL(frame.frameBuf[offset + 2],
@@ -1193,8 +1182,6 @@ result_t ETLidarDriver::waitPackage(node_info *node, uint32_t timeout) {
 
   if (nodeIndex >= frame.dataNum) {
     (*node).sync = frame.headFrameFlag ? NODE_SYNC : NODE_UNSYNC;
-    (*node).stamp = getTime();//(uint64_t)(frame.timestamp * 100);
-    (*node).delayTime = 0;
     nodeIndex = 0;
     m_lastAngle = 0.f;
     m_currentAngle = 0.f;
@@ -1203,6 +1190,30 @@ result_t ETLidarDriver::waitPackage(node_info *node, uint32_t timeout) {
   return RESULT_OK;
 }
 
+void ETLidarDriver::reportFrameLoss() {
+  uint32_t dropped = socket_data->GetDatagramsDropped();
+  uint32_t truncated = socket_data->GetDatagramsTruncated();
+
+  if (dropped == m_framesDropped && truncated == m_framesTruncated &&
+      !m_framesInvalid) {
+    return;
+  }
+
+  if (getms() - m_dropReportTime < 1000) {
+    return;
+  }
+
+  fprintf(stderr, "[YDLIDAR] UDP frames lost: %u dropped, %u truncated, "
+          "%u invalid of %llu received\n", dropped - m_framesDropped,
+          truncated - m_framesTruncated, m_framesInvalid,
+          (unsigned long long)socket_data->GetDatagramsReceived());
+  fflush(stderr);
+  m_framesDropped = dropped;
+  m_framesTruncated = truncated;
+  m_framesInvalid = 0;
+  m_dropReportTime = getms();
+}
+
 result_t ETLidarDriver::getScanData() {
   /* wait data from socket. */
   {
@@ -1212,10 +1223,34 @@ result_t ETLidarDriver::getScanData() {
       return RESULT_FAIL;
     }
 
-    if (socket_data->Receive(sizeof(frame.frameBuf),
-                             reinterpret_cast<uint8_t *>(frame.frameBuf)) < 0) {
-      return RESULT_TIMEOUT;
+    //池中的帧解析完后一次系统调用收取所有已到达的帧
+    if (m_frameNext >= m_frameCount) {
+      for (int i = 0; i < ETLIDAR_FRAME_POOL; i++) {
+        m_frames[i].data = m_framePool + i * UDP_FRAME_SIZE;
+        m_frames[i].size = UDP_FRAME_SIZE;
+      }
+
+      m_frameNext = 0;
+      m_frameCount = socket_data->ReceiveBatch(m_frames, ETLIDAR_FRAME_POOL);
+
+      if (m_frameCount <= 0) {
+        m_frameCount = 0;
+        return RESULT_TIMEOUT;
+      }
+
+      reportFrameLoss();
     }
+
+    const Datagram &datagram = m_frames[m_frameNext++];
+    frame.frameBuf = datagram.data;
+    frame.frameSize = datagram.size;
+    //优先使用内核接收时间，不受批量解析延迟影响
+    m_frameStamp = datagram.stamp ? datagram.stamp : getTime();
+  }
+
+  if (frame.frameSize < 16) {
+    m_framesInvalid++;
+    return RESULT_TIMEOUT;
   }
 
   /* check frame head */
@@ -1268,7 +1303,9 @@ result_t ETLidarDriver::getScanData() {
   /* parser frame crc */
   frame.frameCrc = DSL(frame.frameBuf[14], 8) | DSL(frame.frameBuf[15], 0);
 
-  if (frame.dataNum < 1) {
+  if (frame.dataNum < 1 ||
+      frame.dataIndex + 4 * frame.dataNum > frame.frameSize) {
+    m_framesInvalid++;
     return RESULT_TIMEOUT;
   }
 
@@ -57,9 +57,15 @@ namespace core {
 namespace network {
 class CActiveSocket;
 class CPassiveSocket;
+struct Datagram;
 }
 }
 
+/// UDP frames received with one system call
+#define ETLIDAR_FRAME_POOL 32
+/// UDP receive buffer, holds several revolutions
+#define ETLIDAR_RCVBUF_SIZE (1024 * 1024)
+
 using namespace core::common;
 using namespace core::base;
 
@@ -183,19 +189,6 @@ class ETLidarDriver : public DriverInterface {
   virtual result_t stop();
 
 
-  /**
-   * @brief Get a circle of laser data \n
-   * @param[in] nodebuffer Laser data
-   * @param[in] count      one circle of laser points
-   * @param[in] timeout    timeout
-   * @return return status
-   * @retval RESULT_OK       success
-   * @retval RESULT_FAILE    failed
-   * @note Before starting, you must start the start the scan successfully with the ::startScan function
-   */
-  virtual result_t grabScanData(node_info *nodebuffer, size_t &count,
-                                uint32_t timeout = DEFAULT_TIMEOUT) ;
-
   /**
    * @brief Get lidar scan frequency \n
    * @param[in] frequency    scanning frequency
@@ -380,6 +373,11 @@ class ETLidarDriver : public DriverInterface {
   */
   result_t getScanData();
 
+  /**
+  * @brief Print UDP frames lost in the kernel or rejected, at most once a second.
+  */
+  void reportFrameLoss();
+
   /**
    * @brief Turn on Lidar in Scanning thread \n
    * @param[in] force    Scan mode
@@ -438,6 +436,16 @@ class ETLidarDriver : public DriverInterface {
   bool            m_force_update;
   float           m_lastAngle;
   float           m_currentAngle;
+  uint64_t        m_frameStamp;     ///< 当前帧的接收时间，帧内各点相同
+  /* 帧池：一次系统调用收多帧，各帧在池内原地解析 */
+  uint8_t                  *m_framePool;
+  core::network::Datagram  *m_frames;         ///< ETLIDAR_FRAME_POOL个接收槽
+  int                       m_frameCount;     ///< 池中已收到的帧数
+  int                       m_frameNext;      ///< 下一个待解析的帧
+  uint32_t                  m_framesInvalid;  ///< 格式错误丢弃的帧数
+  uint32_t                  m_framesDropped;  ///< 已报告的内核丢帧数
+  uint32_t                  m_framesTruncated;///< 已报告的截断帧数
+  uint32_t                  m_dropReportTime; ///< 上次报告丢帧的时间
   /* ETLidar specific Variables */
   std::string               m_deviceIp;
   int                       port;
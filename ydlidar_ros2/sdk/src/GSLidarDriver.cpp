@@ -38,6 +38,8 @@
 #include "core/serial/common.h"
 #include "core/serial/serial.h"
 #include "core/network/ActiveSocket.h"
+#include "core/network/TcpServer.h"
+#include "core/common/ChannelCapture.h"
 #include "core/common/ydlidar_help.h"
 #include "ydlidar_config.h"
 
@@ -64,7 +66,6 @@ GSLidarDriver::GSLidarDriver(uint8_t type)
     m_intensities       = false;
     isAutoReconnect     = true;
     m_baudrate          = 230400;
-    scan_node_count     = 0;
     sample_rate         = 5000;
     m_PointTime         = 1e9 / 5000;
     trans_delay         = 0;
@@ -81,7 +82,7 @@ GSLidarDriver::GSLidarDriver(uint8_t type)
 
     nodeIndex = 0;
     globalRecvBuffer = new uint8_t[GSPACKSIZE];
-    scan_node_buf = new node_info[MAX_SCAN_NODES];
+    scan_node_buf.reserve(MAX_SCAN_NODES);
     for (int i=0; i<LIDAR_MAXCOUNT; ++i)
     {
         k0[i] = 0;
@@ -89,6 +90,8 @@ GSLidarDriver::GSLidarDriver(uint8_t type)
         b0[i] = 0;
         b1[i] = 0;
         bias[i] = 0;
+        m_luts[i].nodeCount = 0;
+        m_luts[i].model = 0;
     }
 }
 
@@ -110,10 +113,6 @@ GSLidarDriver::~GSLidarDriver()
         delete[] globalRecvBuffer;
         globalRecvBuffer = NULL;
     }
-    if (scan_node_buf) {
-        delete[] scan_node_buf;
-        scan_node_buf = NULL;
-    }
 }
 
 result_t GSLidarDriver::connect(const char *port_path, uint32_t baudrate) 
@@ -128,11 +127,24 @@ result_t GSLidarDriver::connect(const char *port_path, uint32_t baudrate)
             {
                 _comm = new CActiveSocket();
             }
+            else if (m_DeviceType == YDLIDAR_TYPE_TCP_SERVER)
+            {
+                _comm = new CTcpServer();
+            }
+            else if (m_DeviceType == YDLIDAR_TYPE_REPLAY)
+            {
+                _comm = new ChannelReplay(m_ReplayRealtime);
+            }
             else
             {
                 _comm = new serial::Serial(m_port, m_baudrate,
                     serial::Timeout::simpleTimeout(DEFAULT_TIMEOUT));
             }
+            //录制原始数据
+            if (!m_CaptureFile.empty())
+            {
+                _comm = new ChannelRecorder(_comm, m_CaptureFile);
+            }
             _comm->bindport(port_path, baudrate);
         }
         if (!_comm->open())
@@ -581,7 +593,6 @@ int GSLidarDriver::cacheScanData()
 {
     node_info      local_buf[GS_PACKMAXNODES];
     size_t         count = GS_PACKMAXNODES;
-    size_t         scan_count = 0;
     result_t       ans = RESULT_FAIL;
 
     int timeout_count = 0;
@@ -636,16 +647,13 @@ int GSLidarDriver::cacheScanData()
             timeout_count = 0;
             retryCount = 0;
 
-            {
-            //数据存入数组
-            ScopedLocker l(_lock);
-            gs_module_nodes nodes;
-            nodes.moduleNum = moduleNum;
-            nodes.pointCount = count;
-            memcpy(nodes.points, local_buf, count * SDKNODESIZE);
-            datas.push_back(nodes);
-            scan_count = 0;
-            }
+            //写入待交换的缓存后交换最新的模组数据
+            ScanNodes &scan = scan_node_buf.back();
+            scan.clear();
+            for (size_t i = 0; i < count; ++i)
+                scan.push(local_buf[i]);
+            scan_node_buf.publish();
+            _dataEvent.set();
         }
     }
 
@@ -841,20 +849,22 @@ PARSEHEAD:
                 m_pitchAngle = Angle_PAngle2;
             else
                 m_pitchAngle = Angle_PAngle;
+            //换算表随标定参数、型号和包点数变化
+            PixelLut &lut = m_luts[moduleNum];
+            if (lut.nodeCount != nodeCount || lut.model != model)
+                buildPixelLut(lut, model, nodeCount,
+                    k0[moduleNum], b0[moduleNum], k1[moduleNum], b1[moduleNum],
+                    m_pitchAngle + bias[moduleNum]);
         }
     } //end if (nodeIndex == 0)
 
-    (*node).stamp = getTime();
+    //每包只取一次时间，包内各点共用
+    if (nodeIndex == 0)
+        stamp = getTime();
+    (*node).stamp = stamp;
     
     if (CheckSumResult)
     {
-        //第1个点时间戳使用上一帧的最后1个点的时间戳
-        if (nodeIndex == 0)
-            (*node).stamp = stamp ? stamp : getTime();
-        else
-            (*node).stamp = getTime();
-        stamp = (*node).stamp;
-
         (*node).index = moduleNum;
         (*node).scanFreq = m_ScanFreq;
         (*node).qual = 0;
@@ -889,14 +899,15 @@ PARSEHEAD:
         double sampleAngle = 0;
         if (node->dist > 0)
         {
+            const PixelLut &lut = m_luts[moduleNum];
             if (YDLIDAR_GS1 == model)
-                angTransform2((*node).dist, nodeIndex, 
+                angTransform2(lut, (*node).dist, nodeIndex, 
                     &sampleAngle, &(*node).dist);
             else if (YDLIDAR_GS6 == model)
-                angTransform2((*node).dist, nodeCount - nodeIndex, 
+                angTransform2(lut, (*node).dist, nodeCount - nodeIndex, 
                     &sampleAngle, &(*node).dist);
             else
-                angTransform((*node).dist, nodeIndex, 
+                angTransform(lut, (*node).dist, nodeIndex, 
                     &sampleAngle, &(*node).dist);
         }
 
@@ -969,86 +980,90 @@ PARSEHEAD:
     return RESULT_OK;
 }
 
+void GSLidarDriver::buildPixelLut(PixelLut &lut, int model, int nodeCount,
+    double k0, double b0, double k1, double b1, double pitch)
+{
+    int count = std::min(std::max(nodeCount, 0), GS_PACKMAXNODES);
+
+    for (int n = 0; n <= count; ++n)
+    {
+        double pixelU, tempTheta;
+        if (YDLIDAR_GS1 == model || YDLIDAR_GS6 == model)
+        {
+            //单目：距离按像素视角投影到光轴
+            pixelU = count - n;
+            tempTheta = atan(k0 * pixelU - b0) * 180 / M_PI;
+            lut.theta[n] = tempTheta;
+            lut.scale[n] = 1.0 / cos(tempTheta * M_PI / 180);
+        }
+        else if (n < count / 2)
+        {
+            //左相机
+            pixelU = count / 2 - n;
+            if (b0 > 1)
+                tempTheta = k0 * pixelU - b0;
+            else
+                tempTheta = atan(k0 * pixelU - b0) * 180 / M_PI;
+            //相机坐标旋转俯仰角后 x = dist，y = (dist - Px) * tan(θ - 俯仰角)
+            lut.theta[n] = tempTheta;
+            lut.scale[n] = tan((tempTheta - pitch) * M_PI / 180);
+        }
+        else
+        {
+            //右相机
+            pixelU = count - n;
+            if (b1 > 1)
+                tempTheta = k1 * pixelU - b1;
+            else
+                tempTheta = atan(k1 * pixelU - b1) * 180 / M_PI;
+            lut.theta[n] = tempTheta;
+            lut.scale[n] = tan((tempTheta + pitch) * M_PI / 180);
+        }
+    }
+
+    lut.nodeCount = count;
+    lut.model = model;
+}
+
 void GSLidarDriver::angTransform(
+    const PixelLut &lut,
     uint16_t dist, 
     int n, 
     double *dstTheta, 
     uint16_t *dstDist)
 {
-    double pixelU = n, Dist, theta, tempTheta, tempDist, tempX, tempY;
-    uint8_t mdNum = moduleNum;
-    if (n < nodeCount / 2)
-    {
-      pixelU = nodeCount / 2 - pixelU;
-      if (b0[mdNum] > 1) {
-          tempTheta = k0[mdNum] * pixelU - b0[mdNum];
-      }
-      else
-      {
-          tempTheta = atan(k0[mdNum] * pixelU - b0[mdNum]) * 180 / M_PI;
-      }
-      tempDist = (dist - Angle_Px) / cos(((m_pitchAngle + bias[mdNum]) - (tempTheta)) * M_PI / 180);
-      tempTheta = tempTheta * M_PI / 180;
-      tempX = cos((m_pitchAngle + bias[mdNum]) * M_PI / 180) * tempDist * cos(tempTheta) + 
-        sin((m_pitchAngle + bias[mdNum]) * M_PI / 180) * (tempDist * sin(tempTheta));
-      tempY = -sin((m_pitchAngle + bias[mdNum]) * M_PI / 180) * tempDist * cos(tempTheta) + 
-        cos((m_pitchAngle + bias[mdNum]) * M_PI / 180) * (tempDist * sin(tempTheta));
-      tempX = tempX + Angle_Px;
-      tempY = tempY - Angle_Py; //5.315
-      Dist = sqrt(tempX * tempX + tempY * tempY);
-      theta = atan(tempY / tempX) * 180 / M_PI;
-    }
+    float tempX = dist;
+    float tempY = (dist - float(Angle_Px)) * lut.scale[n];
+    if (n < lut.nodeCount / 2)
+      tempY -= float(Angle_Py); //5.315
     else
-    {
-      pixelU = nodeCount - pixelU;
-      if (b1[mdNum] > 1)
-      {
-          tempTheta = k1[mdNum] * pixelU - b1[mdNum];
-      }
-      else
-      {
-          tempTheta = atan(k1[mdNum] * pixelU - b1[mdNum]) * 180 / M_PI;
-      }
-      tempDist = (dist - Angle_Px) / cos(((m_pitchAngle + bias[mdNum]) + (tempTheta)) * M_PI / 180);
-      tempTheta = tempTheta * M_PI / 180;
-      tempX = cos(-(m_pitchAngle + bias[mdNum]) * M_PI / 180) * tempDist * cos(tempTheta) + 
-        sin(-(m_pitchAngle + bias[mdNum]) * M_PI / 180) * (tempDist * sin(tempTheta));
-      tempY = -sin(-(m_pitchAngle + bias[mdNum]) * M_PI / 180) * tempDist * cos(tempTheta) + 
-        cos(-(m_pitchAngle + bias[mdNum]) * M_PI / 180) * (tempDist * sin(tempTheta));
-      tempX = tempX + Angle_Px;
-      tempY = tempY + Angle_Py; //5.315
-      Dist = sqrt(tempX * tempX + tempY * tempY);
-      theta = atan(tempY / tempX) * 180 / M_PI;
-    }
+      tempY += float(Angle_Py);
+    float theta = atanf(tempY / tempX) * float(180 / M_PI);
     if (theta < 0)
     {
       theta += 360;
     }
     *dstTheta = theta;
-    *dstDist = Dist;
+    *dstDist = sqrtf(tempX * tempX + tempY * tempY);
 
     // debug("%d %d %f %d", n, dist, (float)theta, (int)Dist);
 }
 
 void GSLidarDriver::angTransform2(
+    const PixelLut &lut,
     uint16_t dist, 
     int n, 
     double *dstTheta, 
     uint16_t *dstDist)
 {
-    double pixelU = nodeCount - n, Dist, theta, tempTheta;
-    uint8_t mdNum = moduleNum;
-
-    tempTheta = atan(k0[mdNum] * pixelU - b0[mdNum]) * 180 / M_PI;
-    Dist = dist / cos(tempTheta * M_PI / 180);
-    theta = tempTheta;
+    double theta = lut.theta[n];
 
     if (theta < 0)
     {
       theta += 360;
     }
     *dstTheta = theta;
-    *dstDist = Dist;
+    *dstDist = dist * lut.scale[n];
 }
 
 result_t GSLidarDriver::waitScanData(
@@ -1097,33 +1112,6 @@ result_t GSLidarDriver::waitScanData(
     return RESULT_FAIL;
 }
 
-result_t GSLidarDriver::grabScanData(
-    node_info *nodes,
-    size_t &count,
-    uint32_t timeout)
-{
-    uint32_t st = getms();
-    uint32_t wt = 0;
-    while ((wt = getms() - st) < timeout)
-    {
-        {
-            ScopedLocker l(_lock);
-            if (datas.size())
-            {
-                //从数组中取出点云数据
-                gs_module_nodes ns = datas.back();
-                datas.clear();
-                size_t size = min(int(count), ns.pointCount);
-                memcpy(nodes, ns.points, size * SDKNODESIZE);
-                count = size;
-                return RESULT_OK;
-            }
-        }
-        delay(1); //延时
-    }
-    return RESULT_TIMEOUT;
-}
-
 result_t GSLidarDriver::ascendScanData(node_info *nodebuffer, size_t count) {
     float inc_origin_angle = (float)360.0 / count;
     int i = 0;
@@ -1284,6 +1272,7 @@ result_t GSLidarDriver::getDevicePara(gs_device_para &info, uint32_t timeout) {
         b0[mdNum] = info.b0 / 10000.00;
         b1[mdNum] = info.b1 / 10000.00;
         bias[mdNum] = double(info.bias) * 0.1;
+        m_luts[mdNum].nodeCount = 0; //标定参数变化，换算表需重建
 
         // debug("k0 %lf k1 %lf b0 %lf b1 %lf bias %lf", 
             // k0[mdNum], k1[mdNum], b0[mdNum], b1[mdNum], bias[mdNum]);
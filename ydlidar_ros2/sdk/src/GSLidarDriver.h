@@ -194,19 +194,6 @@ namespace ydlidar
      */
     result_t stop();
 
-    /*!
-     * @brief 获取激光数据 \n
-     * @param[in] nodebuffer 激光点信息
-     * @param[in] count      一圈激光点数
-     * @param[in] timeout    超时时间
-     * @return 返回执行结果
-     * @retval RESULT_OK       获取成功
-     * @retval RESULT_FAILE    获取失败
-     * @note 获取之前，必须使用::startScan函数开启扫描
-     */
-    result_t grabScanData(node_info *nodebuffer, size_t &count,
-                          uint32_t timeout = DEFAULT_TIMEOUT);
-
     /*!
      * @brief 补偿激光角度 \n
      * 把角度限制在0到360度之间
@@ -393,11 +380,33 @@ namespace ydlidar
      */
     result_t checkAutoConnecting();
 
+    /// 单个模组的逐像素换算表。
+    /// 标定参数只随设备信息变化，与距离无关的三角函数在建表时算好，
+    /// 每个点只剩查表、一次乘加、sqrt和atan
+    struct PixelLut {
+      int nodeCount; ///< 建表时的包点数，0表示需要重建
+      int model;     ///< 建表时的雷达型号，决定换算方式
+      float theta[GS_PACKMAXNODES + 1]; ///< angTransform2: 像素角度(°)
+      /// angTransform: 像素的tan(θ∓俯仰角)；angTransform2: 1/cos(θ)
+      float scale[GS_PACKMAXNODES + 1];
+    };
+
+    /*!
+     * @brief  按模组的标定参数、型号和包点数重建换算表
+     * @param pitch 俯仰角与模组偏差之和(°)
+     */
+    static void buildPixelLut(PixelLut &lut, int model, int nodeCount,
+                              double k0, double b0, double k1, double b1,
+                              double pitch);
+
     /*!
-     * @brief  换算得出点的距离和角度
+     * @brief  按换算表得出点的距离和角度，与具体模组无关，
+     * benchmark/gs_transform_check对照原双精度算法校验
      */
-    void angTransform(uint16_t dist, int n, double *dstTheta, uint16_t *dstDist);
-    void angTransform2(uint16_t dist, int n, double *dstTheta, uint16_t *dstDist);
+    static void angTransform(const PixelLut &lut, uint16_t dist, int n,
+                             double *dstTheta, uint16_t *dstDist);
+    static void angTransform2(const PixelLut &lut, uint16_t dist, int n,
+                              double *dstTheta, uint16_t *dstDist);
 
     /**
      * @brief 串口错误信息
@@ -504,13 +513,13 @@ namespace ydlidar
     double b0[LIDAR_MAXCOUNT];
     double b1[LIDAR_MAXCOUNT];
     double bias[LIDAR_MAXCOUNT];
+    PixelLut m_luts[LIDAR_MAXCOUNT]; //各模组的逐像素换算表
     int m_models[LIDAR_MAXCOUNT] = {0};
     int model = YDLIDAR_GS2; //雷达型号
     uint8_t moduleNum = 0; // 模块编号
     uint8_t moduleCount = 1; // 当前模组数量
     int nodeCount = 0; //当前包点数
     uint64_t stamp = 0; //时间戳
-    std::list<gs_module_nodes> datas; //各模组数据
     double m_pitchAngle = Angle_PAngle;
     uint32_t lastStamp = 0; //上一次时间
   };
@@ -35,6 +35,7 @@
 #include <algorithm>
 #include "SDMLidarDriver.h"
 #include "core/serial/common.h"
+#include "core/common/ChannelCapture.h"
 #include "ydlidar_config.h"
 
 using namespace impl;
@@ -42,7 +43,7 @@ using namespace impl;
 namespace ydlidar
 {
 
-SDMLidarDriver::SDMLidarDriver() 
+SDMLidarDriver::SDMLidarDriver(uint8_t type)
     : _serial(NULL)
 {
     // 串口配置参数
@@ -54,12 +55,12 @@ SDMLidarDriver::SDMLidarDriver()
     retryCount = 0;
     m_SingleChannel = false;
     m_LidarType = TYPE_SDM;
+    m_DeviceType = type;
 
     nodeIndex = 0;
     recvBuff = std::vector<uint8_t>(SDKSDMPCSSIZE, 0);
 
-    scan_node_count = 0;
-    scan_node_buf = new node_info[SDK_SDM_POINT_COUNT * 5];
+    scan_node_buf.reserve(SDK_SDM_POINT_COUNT * 5);
 }
 
 SDMLidarDriver::~SDMLidarDriver()
@@ -82,12 +83,6 @@ SDMLidarDriver::~SDMLidarDriver()
         delete _serial;
         _serial = NULL;
     }
-
-    if (scan_node_buf)
-    {
-        delete[] scan_node_buf;
-        scan_node_buf = NULL;
-    }
 }
 
 result_t SDMLidarDriver::connect(const char *port, uint32_t baudrate)
@@ -98,10 +93,24 @@ result_t SDMLidarDriver::connect(const char *port, uint32_t baudrate)
         ScopedLocker l(_cmd_lock);
         if (!_serial)
         {
-            _serial = new serial::Serial(
-                m_port,
-                m_baudrate,
-                serial::Timeout::simpleTimeout(DEFAULT_TIMEOUT));
+            if (m_DeviceType == YDLIDAR_TYPE_REPLAY)
+            {
+                _serial = new core::common::ChannelReplay(m_ReplayRealtime);
+            }
+            else
+            {
+                _serial = new serial::Serial(
+                    m_port,
+                    m_baudrate,
+                    serial::Timeout::simpleTimeout(DEFAULT_TIMEOUT));
+            }
+            //录制原始数据
+            if (!m_CaptureFile.empty())
+            {
+                _serial = new core::common::ChannelRecorder(
+                    _serial, m_CaptureFile);
+            }
+            _serial->bindport(port, baudrate);
         }
         if (!_serial->open())
         {
@@ -469,7 +478,6 @@ int SDMLidarDriver::cacheScanData()
 {
     node_info local_buf[SDK_SDM_POINT_COUNT];
     size_t count = SDK_SDM_POINT_COUNT;
-    size_t scan_count = 0;
     result_t ret = RESULT_FAIL;
 
     int timeout_count = 0;
@@ -521,11 +529,12 @@ int SDMLidarDriver::cacheScanData()
             retryCount = 0;
 
             // printf("[YDLIDAR] SDM points Stored in buffer %lu\n", count);
-            ScopedLocker l(_lock);
-            memcpy(scan_node_buf, local_buf, sizeof(node_info) * SDK_SDM_POINT_COUNT);
-            scan_node_count = SDK_SDM_POINT_COUNT; // 一个包固定1个点
+            // 一个包固定1个点
+            ScanNodes &scan = scan_node_buf.back();
+            scan.clear();
+            scan.push(local_buf[0]);
+            scan_node_buf.publish();
             _dataEvent.set();
-            scan_count = 0;
         }
     }
 
@@ -685,31 +694,6 @@ result_t SDMLidarDriver::waitScanData(
     return RESULT_FAIL;
 }
 
-result_t SDMLidarDriver::grabScanData(
-    node_info *nodebuffer,
-    size_t &count,
-    uint32_t timeout)
-{
-    switch (_dataEvent.wait(timeout))
-    {
-    case Event::EVENT_TIMEOUT:
-        count = 0;
-        return RESULT_TIMEOUT;
-    case Event::EVENT_OK:
-    {
-        ScopedLocker l(_lock);
-        size_t size_to_copy = min(count, scan_node_count);
-        memcpy(nodebuffer, scan_node_buf, size_to_copy * SDKNODESIZE);
-        count = size_to_copy;
-        scan_node_count = 0;
-        return RESULT_OK;
-    }
-    default:
-        count = 0;
-        return RESULT_FAIL;
-    }
-}
-
 /**
  * @brief 设置雷达异常自动重新连接 \n
  * @param[in] enable    是否开启自动重连:
@@ -131,7 +131,7 @@ class SDMLidarDriver : public DriverInterface
 {
 public:
   //构造函数
-  SDMLidarDriver();
+  SDMLidarDriver(uint8_t type = YDLIDAR_TYPE_SERIAL);
   //析构函数
   virtual ~SDMLidarDriver();
   /*!
@@ -217,20 +217,6 @@ public:
   */
   result_t stop();
 
-  /*!
-  * @brief 获取激光数据 \n
-  * @param[in] nodebuffer 激光点信息
-  * @param[in] count      一圈激光点数
-  * @param[in] timeout    超时时间
-  * @return 返回执行结果
-  * @retval RESULT_OK       获取成功
-  * @retval RESULT_FAILE    获取失败
-  * @note 获取之前，必须使用::startScan函数开启扫描
-  */
-  result_t grabScanData(node_info *nodebuffer, size_t &count,
-                        uint32_t timeout = DEFAULT_TIMEOUT) ;
-
-
   /*!
   * @brief 补偿激光角度 \n
   * 把角度限制在0到360度之间
@@ -443,7 +429,7 @@ public:
   virtual result_t getDeviceInfo(device_info &info, uint32_t timeout = DEFAULT_TIMEOUT);
 
 private:
-  serial::Serial *_serial = nullptr; //串口
+  core::common::ChannelDevice *_serial = nullptr; //串口或回放通道
   std::vector<uint8_t> recvBuff; //一包数据缓存
   device_health health_;
 };
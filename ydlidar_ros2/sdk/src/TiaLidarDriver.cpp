@@ -31,8 +31,7 @@ TiaLidarDriver::TiaLidarDriver()
     socket_data->SetSocketType(CSimpleSocket::SocketTypeUdp);
     socket_cmd->SetConnectTimeout(DEFAULT_CONNECTION_TIMEOUT_SEC,
                                   DEFAULT_CONNECTION_TIMEOUT_USEC);
-    scan_node_buf = new node_info[LIDAR_MAXNODES];
-    scan_node_count = 0;
+    scan_node_buf.reserve(LIDAR_MAXNODES);
     nodeIndex = 0;
     retryCount = 0;
     isAutoReconnect = true;
@@ -64,10 +63,6 @@ TiaLidarDriver::~TiaLidarDriver()
         socket_cmd = NULL;
     }
 
-    if (scan_node_buf) {
-        delete[] scan_node_buf;
-        scan_node_buf = nullptr;
-    }
 }
 
 result_t TiaLidarDriver::connect(const char *ip, uint32_t port)
@@ -380,44 +375,6 @@ void TiaLidarDriver::deleteThread()
     }
 }
 
-result_t TiaLidarDriver::grabScanData(
-        node_info *nodebuffer,
-        size_t &count,
-        uint32_t timeout)
-{
-    result_t ret = RESULT_FAIL;
-    switch (_dataEvent.wait(timeout))
-    {
-    case Event::EVENT_TIMEOUT:
-        count = 0;
-        return RESULT_TIMEOUT;
-
-    case Event::EVENT_OK:
-    {
-        if (scan_node_count == 0)
-        {
-            ret = RESULT_FAIL;
-        }
-        else
-        {
-            ScopedLocker l(_lock);
-            size_t size_to_copy = std::min(count, scan_node_count);
-            memcpy(nodebuffer, scan_node_buf, size_to_copy * sizeof(node_info));
-            count = size_to_copy;
-            scan_node_count = 0;
-            ret = RESULT_OK;
-        }
-        _dataEvent.set(false); //重置事件状态
-        break;
-    }
-    default:
-        count = 0;
-        return RESULT_FAIL;
-    }
-
-    return ret;
-}
-
 result_t TiaLidarDriver::getScanFrequency(
         scan_frequency &frequency,
         uint32_t timeout)
@@ -500,14 +457,13 @@ result_t TiaLidarDriver::checkAutoConnecting()
 
 int TiaLidarDriver::parseScanDataThread()
 {
-    node_info      local_scan[LIDAR_MAXNODES];
+    ScanNodes     *local_scan = &scan_node_buf.back();
     node_info      local_buf[TIA_PACKMAXNODES];
     size_t         count = TIA_PACKMAXNODES;
-    size_t         scan_count = 0;
     result_t       ans = RESULT_FAIL;
     int timeout_count = 0;
 
-    memset(local_scan, 0, sizeof(local_scan));
+    local_scan->clear();
     lastZeroTime = getms();
     lastPackIndex = 0;
 
@@ -533,7 +489,7 @@ int TiaLidarDriver::parseScanDataThread()
                     ans = checkAutoConnecting(); //重连
                     if (IS_OK(ans)) {
                         timeout_count = 0;
-                        local_scan[0].sync = NODE_UNSYNC;
+                        local_scan->clear();
                     } else {
                         m_isScanning = false;
                         return RESULT_FAIL;
@@ -543,7 +499,7 @@ int TiaLidarDriver::parseScanDataThread()
             else
             {
                 timeout_count ++;
-                local_scan[0].sync = NODE_UNSYNC;
+                local_scan->clear();
                 error("Timout count [%d]", timeout_count);
             }
         }
@@ -555,18 +511,16 @@ int TiaLidarDriver::parseScanDataThread()
             {
                 if (NODE_SYNC == local_buf[i].sync)
                 {
+                    if (!local_scan->empty())
                     {
-                        ScopedLocker l(_lock);
-                        memcpy(scan_node_buf, local_scan, scan_count * SDKNODESIZE);
-                        scan_node_count = scan_count;
+                        scan_node_buf.publish();
+                        local_scan = &scan_node_buf.back();
                         _dataEvent.set();
                     }
-                    scan_count = 0;
+                    local_scan->clear();
                 }
 
-                local_scan[scan_count++] = local_buf[i];
-                if (scan_count >= LIDAR_MAXNODES)
-                    scan_count = 0;
+                local_scan->push(local_buf[i]);
             }
         }
     }
@@ -825,6 +779,9 @@ result_t TiaLidarDriver::getScanData(node_info* nodes, size_t& count)
         warn("Data packet lost,current packet index [%u],last packet index [%u]",
             packIndex, lastPackIndex);
     lastPackIndex = packIndex;
+    //无设备时间戳时每包只取一次时间，包内各点共用
+    if (!stamp)
+        stamp = getTime();
 
     //大端序
     uint16_t h = 0; //头
@@ -866,7 +823,7 @@ result_t TiaLidarDriver::getScanData(node_info* nodes, size_t& count)
             idx += 2;
             invalid = (!as && !p && (!d || d==0xFFFF)); //全为0表示是无效数据
 
-            nodes[index].stamp = stamp ? stamp : getTime();
+            nodes[index].stamp = stamp;
             //角度变小超过1°则认为是零位点
             if (m_lastAngle - a > 1.0 * 100.0)
             {
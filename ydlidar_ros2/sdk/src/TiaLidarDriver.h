@@ -134,18 +134,6 @@ public:
     // //停止雷达
     // virtual result_t stop();
     /*!
-  * @brief 获取激光数据 \n
-  * @param[in] nodebuffer 激光点信息
-  * @param[in] count      一圈激光点数
-  * @param[in] timeout    超时时间
-  * @return 返回执行结果
-  * @retval RESULT_OK       获取成功
-  * @retval RESULT_FAILE    获取失败
-  * @note 获取之前，必须使用::startScan函数开启扫描
-  */
-    virtual result_t grabScanData(node_info *nodebuffer, size_t &count,
-                                  uint32_t timeout = SDK_TIMEOUT) ;
-    /*!
   * @brief 获取激光雷达当前扫描频率 \n
   * @param[in] frequency    扫描频率
   * @param[in] timeout      超时时间
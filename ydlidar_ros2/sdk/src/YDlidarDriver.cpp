@@ -27,6 +27,9 @@
 #include "core/serial/common.h"
 #include "core/serial/serial.h"
 #include "core/network/ActiveSocket.h"
+#include "core/network/TcpServer.h"
+#include "core/common/ChannelCapture.h"
+#include "core/base/trace.h"
 #include "YDlidarDriver.h"
 #include "ydlidar_config.h"
 
@@ -49,7 +52,6 @@ namespace ydlidar
     m_baudrate = 230400;
     m_SupportMotorDtrCtrl = true;
     m_HeartBeat = false;
-    scan_node_count = 0;
     sample_rate = 5000;
     m_PointTime = 1e9 / 5000;
     trans_delay = 0;
@@ -84,7 +86,10 @@ namespace ydlidar
     healthBuffer = reinterpret_cast<uint8_t *>(&health_);
     nodeIndex = 0;
     globalRecvBuffer = new uint8_t[sizeof(tri_node_package)];
-    scan_node_buf = new node_info[MAX_SCAN_NODES];
+    m_recvBuf.resize(RECV_BUFFER_SIZE);
+    m_recvHead = 0;
+    m_recvTail = 0;
+    scan_node_buf.reserve(MAX_SCAN_NODES);
     package_index = 0;
     has_package_error = false;
 
@@ -122,12 +127,6 @@ namespace ydlidar
         delete[] globalRecvBuffer;
         globalRecvBuffer = NULL;
       }
-
-      if (scan_node_buf)
-      {
-        delete[] scan_node_buf;
-        scan_node_buf = NULL;
-      }
     }
   }
 
@@ -144,12 +143,26 @@ namespace ydlidar
         {
           _serial = new CActiveSocket();
         }
+        else if (m_DeviceType == YDLIDAR_TYPE_TCP_SERVER)
+        {
+          //由Wi-Fi串口桥主动连接，数据直接进入解析缓存
+          _serial = new CTcpServer();
+        }
+        else if (m_DeviceType == YDLIDAR_TYPE_REPLAY)
+        {
+          _serial = new ChannelReplay(m_ReplayRealtime);
+        }
         else
         {
           _serial = new serial::Serial(
             m_port, m_baudrate,
             serial::Timeout::simpleTimeout(DEFAULT_TIMEOUT/2));
         }
+        //录制原始数据
+        if (!m_CaptureFile.empty())
+        {
+          _serial = new ChannelRecorder(_serial, m_CaptureFile);
+        }
         _serial->bindport(port_path, baudrate);
       }
       if (!_serial->open())
@@ -157,6 +170,7 @@ namespace ydlidar
         setDriverError(NotOpenError);
         return RESULT_FAIL;
       }
+      clearRecvBuffer();
       m_isConnected = true;
     }
 
@@ -214,6 +228,7 @@ namespace ydlidar
       return;
     }
 
+    clearRecvBuffer();
     size_t len = _serial->available();
 
     if (len)
@@ -511,12 +526,14 @@ namespace ydlidar
         }
       }
 
-      //重连串口
+      //重连串口，重试间隔从10ms起逐次加倍，串口短暂断开时可尽快恢复
+      uint32_t retryDelay = 10;
       while (isscanning() &&
              connect(m_port.c_str(), m_baudrate) != RESULT_OK)
       {
         setDriverError(NotOpenError);
-        delay(300);
+        delay(retryDelay);
+        retryDelay = std::min<uint32_t>(retryDelay * 2, 300);
       }
       //如果未连接串口或者已停止扫描，则返回
       if (!isconnected() || !isscanning())
@@ -614,10 +631,10 @@ namespace ydlidar
   {
     node_info local_buf[128];
     size_t count = 128;
-    node_info local_scan[MAX_SCAN_NODES];
-    size_t scan_count = 0;
+    //直接在待交换的缓存中组帧，一圈完成后交换指针
+    ScanNodes *local_scan = &scan_node_buf.back();
     result_t ans = RESULT_FAIL;
-    memset(local_scan, 0, sizeof(local_scan));
+    local_scan->clear();
 
     int timeout_count = 0;
     retryCount = 0;
@@ -631,6 +648,8 @@ namespace ydlidar
     {
       count = 128;
       ans = waitScanData(local_buf, count, DEFAULT_TIMEOUT / 2);
+      //等待数据的时间不计入
+      YDLIDAR_TRACE_SCOPE("cacheScanData");
       if (!IS_OK(ans))
       {
         if (timeout_count > DEFAULT_TIMEOUT_COUNT)
@@ -653,7 +672,7 @@ namespace ydlidar
             if (IS_OK(ans))
             {
               timeout_count = 0;
-              local_scan[0].sync = NODE_UNSYNC;
+              local_scan->clear();
             }
             else
             {
@@ -665,7 +684,7 @@ namespace ydlidar
         else
         {
           timeout_count++;
-          local_scan[0].sync = NODE_UNSYNC;
+          local_scan->clear();
 
           if (m_driverErrno == NoError)
             setDriverError(TimeoutError);
@@ -691,25 +710,22 @@ namespace ydlidar
       {
         if (local_buf[pos].sync & LIDAR_RESP_SYNCBIT)
         {
-          if (local_scan[0].sync & LIDAR_RESP_SYNCBIT)
+          if (!local_scan->empty() &&
+              (local_scan->sync()[0] & LIDAR_RESP_SYNCBIT))
           {
-            ScopedLocker l(_lock);
-            local_scan[0].delayTime = local_buf[pos].delayTime;
+            local_scan->packet(0).delayTime = local_buf[pos].delayTime;
             //TODO: 将下一圈的第一个点的采集时间作为当前圈数据的采集时间
 
-            memcpy(scan_node_buf, local_scan, scan_count * sizeof(node_info));
-            scan_node_count = scan_count;
+            scan_node_buf.publish();
+            local_scan = &scan_node_buf.back();
             _dataEvent.set();
+            core::base::Trace::instant("revolution");
           }
 
-          scan_count = 0;
-        }
-        local_scan[scan_count++] = local_buf[pos];
-
-        if (scan_count == _countof(local_scan))
-        {
-          scan_count -= 1;
+          local_scan->clear();
         }
+        //超出一圈最大点数的点丢弃
+        local_scan->push(local_buf[pos]);
       }
 
       KeepLiveHeartBeat();
@@ -783,305 +799,251 @@ namespace ydlidar
     }
   }
 
-  result_t YDlidarDriver::parseResponseHeader(
-      uint8_t *packageBuffer,
-      uint32_t timeout)
+  result_t YDlidarDriver::fillRecvBuffer(size_t size, uint32_t timeout)
   {
-    int recvPos = 0;
+    size_t buffered = m_recvTail - m_recvHead;
+    if (buffered >= size)
+      return RESULT_OK;
+
+    //未解析的数据移到缓存头部
+    if (m_recvHead)
+    {
+      if (buffered)
+        memmove(&m_recvBuf[0], &m_recvBuf[m_recvHead], buffered);
+      m_recvHead = 0;
+      m_recvTail = buffered;
+    }
+
     uint32_t startTs = getms();
     uint32_t waitTime = 0;
-    m_BlockRevSize = 0;
-    package_Sample_Num = 0;
-    uint8_t package_type = 0;
-    result_t ans = RESULT_TIMEOUT;
-
-    while ((waitTime = getms() - startTs) <= timeout)
+    while (m_recvTail < size)
     {
-      size_t remainSize = TRI_PACKHEADSIZE - recvPos;
+      if ((waitTime = getms() - startTs) > timeout)
+        return RESULT_TIMEOUT;
+
+      size_t remainSize = size - m_recvTail;
       size_t recvSize = 0;
-      ans = waitForData(remainSize, timeout - waitTime, &recvSize);
+      result_t ans = waitForData(remainSize, timeout - waitTime, &recvSize);
       if (!IS_OK(ans))
-      {
         return ans;
-      }
 
-      if (recvSize > remainSize)
+      //一次读取串口中已有的全部数据
+      size_t freeSize = m_recvBuf.size() - m_recvTail;
+      if (recvSize > freeSize)
+        recvSize = freeSize;
+      if (recvSize < remainSize)
         recvSize = remainSize;
 
-      ans = getData(globalRecvBuffer, recvSize);
-
-      for (size_t pos = 0; pos < recvSize; ++pos)
-      {
-        uint8_t currentByte = globalRecvBuffer[pos];
-        switch (recvPos)
-        {
-        case 0:
-          if (currentByte != PH1)
-          {
-            checkBlockStatus(currentByte);
-            continue;
-          }
-          break;
-
-        case 1:
-        {
-          CheckSumCal = PH;
-          if (currentByte == PH2)
-          {
-            if (m_driverErrno == BlockError)
-            {
-              setDriverError(NoError);
-            }
-          }
-          else if (currentByte == PH1) // 防止出现连续0xAA
-          {
-            continue;
-          }
-          else if (currentByte == PH3) // 时间戳标识
-          {
-            recvPos = 0;
-            size_t lastPos = pos - 1;
-            // 解析时间戳（共8个字节）
-            int remainSize = SIZE_STAMPPACKAGE - (recvSize - pos + 1); // 计算剩余应读字节数
-            if (remainSize > 0)
-            {
-              size_t lastSize = recvSize;
-              ans = waitForData(remainSize, timeout - waitTime, &recvSize);
-              if (!IS_OK(ans))
-                return ans;
-              if (recvSize > remainSize)
-                recvSize = remainSize;
-              getData(&globalRecvBuffer[lastSize], recvSize);
-              recvSize += lastSize;
-              pos = TRI_PACKHEADSIZE;
-            }
-            else
-            {
-              pos += 6;
-            }
-            // 时间戳校验和检测
-            uint8_t csc = 0; // 计算校验和
-            uint8_t csr = 0; // 实际校验和
-            for (int i = 0; i < SIZE_STAMPPACKAGE; ++i)
-            {
-              if (i == 2)
-                csr = globalRecvBuffer[lastPos + i];
-              else
-                csc ^= globalRecvBuffer[lastPos + i];
-            }
-            if (csc != csr)
-            {
-              error("Checksum error c[0x%02X] != r[0x%02X]", csc, csr);
-            }
-            else
-            {
-              stamp_package sp;
-              memcpy(&sp, &globalRecvBuffer[lastPos], SIZE_STAMPPACKAGE);
-              stamp = uint64_t(sp.stamp) * 1000000; // 毫秒转纳秒需要×1000000
-              // debug("stamp: 0x%"PRIx64" -> 0x%"PRIx64"", sp.stamp, stamp);
-              // 测试扫描时长
-              // static uint32_t s_scanTime = 0;
-              // if (s_scanTime > 0)
-              // {
-              //     uint32_t dt = sp.stamp - s_scanTime;
-              //     if (dt < 44 || dt > 57)
-              //     {
-                      // error("单帧时长[%u]ms超出标准[%u~%u]",
-                      //     dt, 44, 57);
-              //     }
-              // }
-              // s_scanTime = sp.stamp;
-            }
-            continue;
-          }
-          else
-          {
-            has_package_error = true;
-            recvPos = 0;
-            continue;
-          }
-          break;
-        }
-        case 2:
-          SampleNumlAndCTCal = currentByte;
-          package_type = currentByte & 0x01; // 是否是零位包标识
-          if (package_type == CT_RingStart)
-          {
-            scan_frequence = (currentByte & 0xFE) >> 1;
-          }
-          break;
-
-        case 3:
-          SampleNumlAndCTCal += (currentByte * 0x100);
-          package_Sample_Num = currentByte;
-          break;
-
-        case 4:
-          if (currentByte & LIDAR_RESP_CHECKBIT)
-          {
-            FirstSampleAngle = currentByte;
-          }
-          else
-          {
-            has_package_error = true;
-            recvPos = 0;
-            continue;
-          }
-          break;
-
-        case 5:
-          FirstSampleAngle += currentByte * 0x100;
-          CheckSumCal ^= FirstSampleAngle;
-          FirstSampleAngle = FirstSampleAngle >> 1;
-          break;
-
-        case 6:
-          if (currentByte & LIDAR_RESP_CHECKBIT)
-          {
-            LastSampleAngle = currentByte;
-          }
-          else
-          {
-            has_package_error = true;
-            recvPos = 0;
-            continue;
-          }
-
-          break;
-
-        case 7:
-          LastSampleAngle = currentByte * 0x100 + LastSampleAngle;
-          LastSampleAngleCal = LastSampleAngle;
-          LastSampleAngle = LastSampleAngle >> 1;
+      ans = getData(&m_recvBuf[m_recvTail], recvSize);
+      if (IS_FAIL(ans))
+        return ans;
+      m_recvTail += recvSize;
+    }
 
-          if (package_Sample_Num == 1)
-          {
-            IntervalSampleAngle = 0;
-          }
-          else
-          {
-            if (LastSampleAngle < FirstSampleAngle)
-            {
-              if ((FirstSampleAngle > 270 * 64) && (LastSampleAngle < 90 * 64))
-              {
-                IntervalSampleAngle = (float)((360 * 64 + LastSampleAngle -
-                                               FirstSampleAngle) /
-                                              ((
-                                                   package_Sample_Num - 1) *
-                                               1.0));
-                IntervalSampleAngle_LastPackage = IntervalSampleAngle;
-              }
-              else
-              {
-                IntervalSampleAngle = IntervalSampleAngle_LastPackage;
-              }
-            }
-            else
-            {
-              IntervalSampleAngle = (float)((LastSampleAngle - FirstSampleAngle) / ((
-                                                                                        package_Sample_Num - 1) *
-                                                                                    1.0));
-              IntervalSampleAngle_LastPackage = IntervalSampleAngle;
-            }
-          }
-          break;
+    return RESULT_OK;
+  }
 
-        case 8:
-          CheckSum = currentByte;
-          break;
-        case 9:
-          CheckSum += (currentByte * 0x100);
-          break;
-        }
+  void YDlidarDriver::clearRecvBuffer()
+  {
+    m_recvHead = 0;
+    m_recvTail = 0;
+  }
 
-        packageBuffer[recvPos++] = currentByte;
-      }
+  // 点云数据按16位小端字异或，每次处理8字节
+  static uint16_t xorSampleWords(const uint8_t *data, size_t size)
+  {
+    uint64_t acc = 0;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+      uint64_t v;
+      memcpy(&v, data + i, sizeof(v));
+      acc ^= v;
+    }
+    acc ^= acc >> 32;
+    acc ^= acc >> 16;
 
-      if (recvPos == TRI_PACKHEADSIZE)
-      {
-        ans = RESULT_OK;
-        break;
-      }
+    uint16_t cs = uint16_t(acc);
+    for (; i + 1 < size; i += 2)
+      cs ^= uint16_t(data[i] | (data[i + 1] << 8));
+    return cs;
+  }
 
-      ans = RESULT_TIMEOUT;
+  // 带强度的三角雷达点云数据每点3字节，强度字节单独参与异或
+  static uint16_t xorSampleTriples(const uint8_t *data, size_t size)
+  {
+    uint8_t lo = 0;
+    uint8_t hi = 0;
+    for (size_t i = 0; i + 2 < size; i += 3)
+    {
+      lo ^= data[i] ^ data[i + 1];
+      hi ^= data[i + 2];
     }
-
-    return ans;
+    return uint16_t(lo | (hi << 8));
   }
 
-  result_t YDlidarDriver::parseResponseScanData(
+  result_t YDlidarDriver::parseResponseHeader(
       uint8_t *packageBuffer,
       uint32_t timeout)
   {
-    int recvPos = 0;
     uint32_t startTs = getms();
     uint32_t waitTime = 0;
+    m_BlockRevSize = 0;
+    package_Sample_Num = 0;
     result_t ans = RESULT_TIMEOUT;
 
     while ((waitTime = getms() - startTs) <= timeout)
     {
-      size_t remainSize = package_Sample_Num * PackageSampleBytes - recvPos;
-      size_t recvSize = 0;
-      ans = waitForData(remainSize, timeout - waitTime, &recvSize);
+      ans = fillRecvBuffer(2, timeout - waitTime);
+      if (!IS_OK(ans))
+        return ans;
+
+      // 在缓存中整块查找包头，跳过的字节只做阻塞检测
+      const uint8_t *data = &m_recvBuf[m_recvHead];
+      size_t size = m_recvTail - m_recvHead;
+      const uint8_t *head = reinterpret_cast<const uint8_t *>(
+          memchr(data, PH1, size));
+      size_t skip = head ? size_t(head - data) : size;
+      for (size_t i = 0; i < skip; ++i)
+        checkBlockStatus(data[i]);
+      m_recvHead += skip;
+      if (!head || m_recvTail - m_recvHead < 2)
+        continue;
+
+      uint8_t flag = head[1];
+      if (flag == PH1) // 防止出现连续0xAA
+      {
+        m_recvHead++;
+        continue;
+      }
+      else if (flag == PH3) // 时间戳标识
+      {
+        // 解析时间戳（共8个字节）
+        ans = fillRecvBuffer(SIZE_STAMPPACKAGE, timeout - waitTime);
+        if (!IS_OK(ans))
+          return ans;
 
+        const uint8_t *buf = &m_recvBuf[m_recvHead];
+        // 时间戳校验和检测
+        uint8_t csc = 0; // 计算校验和
+        uint8_t csr = buf[2]; // 实际校验和
+        for (size_t i = 0; i < SIZE_STAMPPACKAGE; ++i)
+        {
+          if (i != 2)
+            csc ^= buf[i];
+        }
+        if (csc != csr)
+        {
+          error("Checksum error c[0x%02X] != r[0x%02X]", csc, csr);
+        }
+        else
+        {
+          stamp_package sp;
+          memcpy(&sp, buf, SIZE_STAMPPACKAGE);
+          stamp = uint64_t(sp.stamp) * 1000000; // 毫秒转纳秒需要×1000000
+        }
+        m_recvHead += SIZE_STAMPPACKAGE;
+        continue;
+      }
+      else if (flag != PH2)
+      {
+        has_package_error = true;
+        m_recvHead += 2;
+        continue;
+      }
+
+      if (m_driverErrno == BlockError)
+      {
+        setDriverError(NoError);
+      }
+
+      ans = fillRecvBuffer(TRI_PACKHEADSIZE, timeout - waitTime);
       if (!IS_OK(ans))
         return ans;
 
-      if (recvSize > remainSize)
-        recvSize = remainSize;
+      const uint8_t *buf = &m_recvBuf[m_recvHead];
+      if (!(buf[4] & LIDAR_RESP_CHECKBIT) ||
+          !(buf[6] & LIDAR_RESP_CHECKBIT))
+      {
+        has_package_error = true;
+        m_recvHead += 2;
+        continue;
+      }
 
-      getData(globalRecvBuffer, recvSize);
+      memcpy(packageBuffer, buf, TRI_PACKHEADSIZE);
+      m_recvHead += TRI_PACKHEADSIZE;
 
-      for (size_t pos = 0; pos < recvSize; ++pos)
+      CheckSumCal = PH;
+      SampleNumlAndCTCal = uint16_t(buf[2] | (buf[3] << 8));
+      if ((buf[2] & 0x01) == CT_RingStart) // 是否是零位包标识
+      {
+        scan_frequence = (buf[2] & 0xFE) >> 1;
+      }
+      package_Sample_Num = buf[3];
+
+      FirstSampleAngle = uint16_t(buf[4] | (buf[5] << 8));
+      CheckSumCal ^= FirstSampleAngle;
+      FirstSampleAngle = FirstSampleAngle >> 1;
+
+      LastSampleAngleCal = uint16_t(buf[6] | (buf[7] << 8));
+      LastSampleAngle = LastSampleAngleCal >> 1;
+
+      if (package_Sample_Num == 1)
+      {
+        IntervalSampleAngle = 0;
+      }
+      else
       {
-        if (m_intensities && !isTOFLidar(m_LidarType))
+        if (LastSampleAngle < FirstSampleAngle)
         {
-          if (recvPos % 3 == 2)
+          if ((FirstSampleAngle > 270 * 64) && (LastSampleAngle < 90 * 64))
           {
-            Valu8Tou16 += globalRecvBuffer[pos] * 0x100;
-            CheckSumCal ^= Valu8Tou16;
-          }
-          else if (recvPos % 3 == 1)
-          {
-            Valu8Tou16 = globalRecvBuffer[pos];
+            IntervalSampleAngle = (float)((360 * 64 + LastSampleAngle -
+                                           FirstSampleAngle) /
+                                          ((package_Sample_Num - 1) * 1.0));
+            IntervalSampleAngle_LastPackage = IntervalSampleAngle;
           }
           else
           {
-            CheckSumCal ^= globalRecvBuffer[pos];
+            IntervalSampleAngle = IntervalSampleAngle_LastPackage;
           }
         }
         else
         {
-          if (recvPos % 2 == 1)
-          {
-            Valu8Tou16 += globalRecvBuffer[pos] * 0x100;
-            CheckSumCal ^= Valu8Tou16;
-          }
-          else
-          {
-            Valu8Tou16 = globalRecvBuffer[pos];
-          }
+          IntervalSampleAngle = (float)((LastSampleAngle - FirstSampleAngle) /
+                                        ((package_Sample_Num - 1) * 1.0));
+          IntervalSampleAngle_LastPackage = IntervalSampleAngle;
         }
-
-        packageBuffer[TRI_PACKHEADSIZE + recvPos] = globalRecvBuffer[pos];
-        recvPos++;
       }
 
-      if (package_Sample_Num * PackageSampleBytes == recvPos)
-      {
-        ans = RESULT_OK;
-        break;
-      }
-    }
-
-    if (package_Sample_Num * PackageSampleBytes != recvPos)
-    {
-      return RESULT_FAIL;
+      CheckSum = uint16_t(buf[8] | (buf[9] << 8));
+      return RESULT_OK;
     }
 
     return ans;
   }
 
+  result_t YDlidarDriver::parseResponseScanData(
+      uint8_t *packageBuffer,
+      uint32_t timeout)
+  {
+    size_t size = package_Sample_Num * PackageSampleBytes;
+    result_t ans = fillRecvBuffer(size, timeout);
+    if (!IS_OK(ans))
+      return ans;
+
+    // 整包拷贝并计算校验和
+    const uint8_t *data = &m_recvBuf[m_recvHead];
+    memcpy(packageBuffer + TRI_PACKHEADSIZE, data, size);
+    if (m_intensities && !isTOFLidar(m_LidarType))
+      CheckSumCal ^= xorSampleTriples(data, size);
+    else
+      CheckSumCal ^= xorSampleWords(data, size);
+    m_recvHead += size;
+
+    return RESULT_OK;
+  }
+
   // 解析时间戳数据（云鲸雷达）
   bool YDlidarDriver::parseStampData(uint32_t timeout)
   {
@@ -1156,6 +1118,8 @@ namespace ydlidar
       }
       calcuteCheckSum(node);
       calcutePackageCT();
+      //每包只取一次时间，包内各点共用
+      packageStamp = stamp ? stamp : getTime();
 
       // if ((ct & 0x01) == CT_RingStart)
       //   parseStampData(); //解析时间戳
@@ -1254,7 +1218,7 @@ namespace ydlidar
     int32_t correctAngle = 0;
     (*node).qual = Node_Default_Quality;
     (*node).delayTime = 0;
-    (*node).stamp = stamp ? stamp : getTime();
+    (*node).stamp = packageStamp;
     (*node).scanFreq = scan_frequence;
     (*node).is = 0;
 
@@ -1412,8 +1376,8 @@ namespace ydlidar
       // 如果是零位包点
       if (node.sync & LIDAR_RESP_SYNCBIT)
       {
-        // 计算延时时间
-        size_t size = _serial->available();
+        // 计算延时时间（含已读入缓存但未解析的数据）
+        size_t size = _serial->available() + (m_recvTail - m_recvHead);
         uint64_t delayTime = 0;
         if (size > TRI_PACKHEADSIZE)
         {
@@ -1446,31 +1410,6 @@ namespace ydlidar
     return RESULT_FAIL;
   }
 
-  result_t YDlidarDriver::grabScanData(
-      node_info *nodes,
-      size_t &count,
-      uint32_t timeout)
-  {
-    switch (_dataEvent.wait(timeout))
-    {
-    case Event::EVENT_TIMEOUT:
-      count = 0;
-      return RESULT_TIMEOUT;
-    case Event::EVENT_OK:
-    {
-      ScopedLocker l(_lock);
-      size_t size_to_copy = min(count, scan_node_count);
-      memcpy(nodes, scan_node_buf, size_to_copy * sizeof(node_info));
-      count = size_to_copy;
-      scan_node_count = 0;
-      return RESULT_OK;
-    }
-    default:
-      count = 0;
-      return RESULT_FAIL;
-    }
-  }
-
   result_t YDlidarDriver::ascendScanData(node_info *nodebuffer, size_t count)
   {
     float inc_origin_angle = (float)360.0 / count;
@@ -1931,6 +1870,7 @@ namespace ydlidar
 
   result_t YDlidarDriver::createThread()
   {
+    clearRecvBuffer();
     m_thread = new std::thread(&YDlidarDriver::cacheScanData, this);
     if (!m_thread)
     {
@@ -2038,15 +1978,14 @@ namespace ydlidar
   {
     ScopedLocker l(_cmd_lock);
 
+    //不等待电机稳定，由收到的第一圈数据判断雷达是否就绪
     if (m_SupportMotorDtrCtrl)
     {
       setDTR();
-      delay(500);
     }
     else
     {
       clearDTR();
-      delay(500);
     }
 
     return RESULT_OK;
@@ -2062,12 +2001,10 @@ namespace ydlidar
     if (m_SupportMotorDtrCtrl)
     {
       clearDTR();
-      delay(500);
     }
     else
     {
       setDTR();
-      delay(500);
     }
 
     return RESULT_OK;
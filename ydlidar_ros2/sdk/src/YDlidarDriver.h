@@ -41,6 +41,7 @@
 #include <stdlib.h>
 #include <atomic>
 #include <map>
+#include <vector>
 #include <core/common/ChannelDevice.h>
 #include <core/base/locker.h>
 #include <core/base/thread.h>
@@ -195,19 +196,6 @@ class YDlidarDriver : public DriverInterface {
    */
   virtual result_t stop();
 
-  /**
-   * @brief Get a circle of laser data \n
-   * @param[in] nodebuffer Laser data
-   * @param[in] count      one circle of laser points
-   * @param[in] timeout    timeout
-   * @return return status
-   * @retval RESULT_OK       success
-   * @retval RESULT_FAILE    failed
-   * @note Before starting, you must start the start the scan successfully with the ::startScan function
-   */
-  virtual result_t grabScanData(node_info *nodebuffer, size_t &count,
-                                uint32_t timeout = DEFAULT_TIMEOUT) ;
-
   /**
    * @brief Normalized angle \n
    * Normalize the angel between 0 and 360
@@ -420,6 +408,21 @@ class YDlidarDriver : public DriverInterface {
   result_t parseResponseScanData(uint8_t *packageBuffer,
                                  uint32_t timeout = DEFAULT_TIMEOUT);
 
+  /**
+   * @brief make sure at least size bytes are in the receive buffer
+   * @note reads everything the channel has in one call, so the packet
+   * parser works on whole packets instead of one read per field
+   * @param size     required buffered bytes
+   * @param timeout  timeout
+   * @return status
+   */
+  result_t fillRecvBuffer(size_t size, uint32_t timeout = DEFAULT_TIMEOUT);
+
+  /**
+   * @brief drop unparsed bytes in the receive buffer
+   */
+  void clearRecvBuffer();
+
   //解析时间戳数据（云鲸雷达）
   bool parseStampData(uint32_t timeout = DEFAULT_TIMEOUT / 10);
 
@@ -628,6 +631,12 @@ class YDlidarDriver : public DriverInterface {
   uint8_t package_Sample_Num;
 
   uint8_t *globalRecvBuffer;
+  enum {
+    RECV_BUFFER_SIZE = 4096, /**< batch receive buffer size */
+  };
+  std::vector<uint8_t> m_recvBuf; //批量接收缓存
+  size_t m_recvHead; //未解析数据起始位置
+  size_t m_recvTail; //已接收数据结束位置
   bool has_device_header;
   uint8_t last_device_byte;
   int         asyncRecvPos;
@@ -646,6 +655,7 @@ class YDlidarDriver : public DriverInterface {
 
   uint32_t m_dataPos = 0; //记录当前解析到的数据的位置（解析是否带强度信息专用）
   uint64_t stamp = 0; //时间戳
+  uint64_t packageStamp = 0; //当前包的时间戳，包内各点相同
   bool hasStamp = true; //是否有时间戳数据
 };
 
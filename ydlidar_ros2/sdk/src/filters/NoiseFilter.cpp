@@ -59,6 +59,20 @@ double NoiseFilter::calcTargetOffset(
     return offset;
 }
 
+//点2到两点连线的垂直偏移量，同calcTargetOffset，使用直角坐标计算
+static inline float targetOffset(float x1, float y1, float x2, float y2)
+{
+    float dx = x2 - x1;
+    float dy = y2 - y1;
+    float len = sqrtf(dx * dx + dy * dy);
+
+    if (len == 0.0f) {
+        return y2;
+    }
+
+    return (x2 * y1 - x1 * y2) / len;
+}
+
 bool NoiseFilter::isRangeValid(const LaserConfig &config,
                                double reading) const {
     if (reading >= config.min_range && reading <= config.max_range) {
@@ -88,23 +102,20 @@ void NoiseFilter::filter_noise(
         return;
     }
 
+    m_scan.assign(in.points);
+    const float *ranges = m_scan.range.data();
+    const float *xs = m_scan.x.data();
+    const float *ys = m_scan.y.data();
+
     std::vector<bool> maskedPoints;
-    double lastRange = in.points[0].range;
-    double lastAngle = in.points[0].angle;
-    double lastInclineRange = lastRange;
     const int nrPoints = in.points.size();
     maskedPoints.resize(nrPoints, false);
-    double lastIncline = 0;
-    bool hasFirst = false;
 
     //copy attributes to filtered scan
     out = in;
     int pointCount  = 0;
-    double lastOffset = 0;
-    double lastDistance = lastRange;
-    double preAngle = lastAngle;
-    double lastDiff = 0;
-    bool isIncrease = false;
+    double lastDistance = ranges[0];
+    int lastValid = 0; //上一个有效点的索引
     int minIndex = 0;
     double minIndexDistance = 0;
     double maxDistance = 0;
@@ -112,20 +123,12 @@ void NoiseFilter::filter_noise(
     float filter_offset = 0.05;
 
     for (int i = 0; i < nrPoints; i++) {
-        double current_range = in.points[i].range;//current lidar distance
-        double current_angle = in.points[i].angle;//current lidar angle
+        double current_range = ranges[i];//current lidar distance
 
         if (isRangeValid(in.config, current_range)) {
-
-            double offset;
-
-            if (isRangeValid(in.config, lastRange)) {
-                offset = calcTargetOffset(lastRange, lastAngle, current_range,
-                                          current_angle);//calculate offset distance
-            } else {
-                offset = calcTargetOffset(lastDistance, preAngle, current_range,
-                                          current_angle);//calculate offset distance
-            }
+            //上一个点有效时即为上一个有效点
+            double offset = targetOffset(xs[lastValid], ys[lastValid],
+                                         xs[i], ys[i]);//calculate offset distance
 
             double Diff = current_range - lastDistance;//distance difference
 
@@ -179,17 +182,15 @@ void NoiseFilter::filter_noise(
 
             } else {
                 if (pointCount >= 2) {
-                    bool isincre = (in.points[minIndex].range - lastDistance) < 0;
-
                     for (int j = minIndex - nonMaskedNeighbours; j <= i + nonMaskedNeighbours;
                          j++) {
                         if (j >= 0 && j < nrPoints) {
-                            double offset = calcTargetOffset(in.points[j].range, in.points[j].angle,
-                                                             lastDistance,
-                                                             preAngle);//calculate offset distance
+                            double offset = targetOffset(xs[j], ys[j],
+                                                         xs[lastValid],
+                                                         ys[lastValid]);//calculate offset distance
 
-                            if (in.points[j].range > maxDistance) {
-                                maxDistance = in.points[j].range;
+                            if (ranges[j] > maxDistance) {
+                                maxDistance = ranges[j];
                             }
 
                             if (offset < filter_offset && maxDistance > filter_offset &&
@@ -205,14 +206,9 @@ void NoiseFilter::filter_noise(
                 maxDistance = 0.0;
             }
 
-            lastOffset = offset;//last offset
-            lastDiff = Diff;//last distance difference
             lastDistance = current_range;//last distance
-            preAngle = current_angle;
+            lastValid = i;
         }
-
-        lastAngle = current_angle;//last angle
-        lastRange = current_range;//last range
     }
 
     //mark all masked points as invalid in scan
@@ -262,10 +258,14 @@ void NoiseFilter::filter_tail(
         return;
     }
 
+    m_scan.assign(in.points);
+    const float *ranges = m_scan.range.data();
+    const float *cs = m_scan.cosA.data();
+    const float *ss = m_scan.sinA.data();
+    const float *xs = m_scan.x.data();
+    const float *ys = m_scan.y.data();
+
     std::vector<bool> maskedPoints;
-    double lastRange = in.points[0].range;
-    double lastAngle = in.points[0].angle;
-    double lastInclineRange = lastRange;
     const int size = in.points.size();
     maskedPoints.resize(size, false);
     double lastIncline = 0;
@@ -276,6 +276,28 @@ void NoiseFilter::filter_tail(
     double lastDistance = 0;
     int max_skip_step = 5 * maskedNeighbours;
 
+    //预先计算与上一个点的夹角正余弦和两点连线的偏移量，主循环中不再调用三角函数
+    m_deltaSin.resize(size);
+    m_deltaCos.resize(size);
+    m_pairOffset.resize(size);
+    float *deltaSin = m_deltaSin.data();
+    float *deltaCos = m_deltaCos.data();
+    float *pairOffset = m_pairOffset.data();
+    deltaSin[0] = 0.0f;
+    deltaCos[0] = 1.0f;
+    pairOffset[0] = 0.0f;
+
+    for (int i = 1; i < size; i++) {
+        //sin(a-b) = sin(a)cos(b) - cos(a)sin(b)
+        //cos(a-b) = cos(a)cos(b) + sin(a)sin(b)
+        deltaSin[i] = ss[i] * cs[i - 1] - cs[i] * ss[i - 1];
+        deltaCos[i] = cs[i] * cs[i - 1] + ss[i] * ss[i - 1];
+    }
+
+    for (int i = 1; i < size; i++) {
+        pairOffset[i] = targetOffset(xs[i - 1], ys[i - 1], xs[i], ys[i]);
+    }
+
     if (max_skip_step > 7) {
         max_skip_step = 7;
     }
@@ -287,18 +309,16 @@ void NoiseFilter::filter_tail(
 
     for (int i = 0; i < size; i++)
     {
-        double range = in.points[i].range;//current lidar distance
-        double angle = in.points[i].angle;//current lidar angle
+        double range = ranges[i];//current lidar distance
 
         if (isRangeValid(in.config, range)
                 /*&& isRangeValid(in.config, lastDistance)*/)
         {
             if (maskedFilter && isRangeValid(in.config, lastDistance))
             {
-                const double incline = calcInclineAngle(
-                            in.points[i].range,
-                            lastDistance,
-                            angle - lastAngle);
+                //同calcInclineAngle，夹角为当前点与上一个点的角度差
+                const double incline = atan2(deltaSin[i] * lastDistance,
+                                             range - deltaCos[i] * lastDistance);
 
                 if (!hasFirst) {
                     hasFirst = true;
@@ -315,7 +335,7 @@ void NoiseFilter::filter_tail(
                     for (int j = -maskedNeighbours; j < maskedNeighbours; j++)
                     {
                         if ((int(i) + j < 0)
-                                || ((int(i) + j) > size)) {
+                                || ((int(i) + j) >= size)) {
                             continue;
                         }
                         if (i + j - 1 < 0) {
@@ -323,10 +343,7 @@ void NoiseFilter::filter_tail(
                         }
 
                         //如果当前点相邻N点中有偏移量较大的点则认为是噪点
-                        double offset = calcTargetOffset(in.points[i + j - 1].range,
-                                in.points[i + j - 1].angle,
-                                in.points[i + j].range,
-                                in.points[i + j].angle); //calculate offset distance
+                        double offset = pairOffset[i + j]; //calculate offset distance
                         if (offset < 0.2) {
                             maskedPoints[i + j] = true;
                             isValid = true;
@@ -355,7 +372,6 @@ void NoiseFilter::filter_tail(
                     maskedPoints[i] = true;
                 }
 
-                lastInclineRange = range;
                 lastIncline = incline;
             }
 
@@ -368,9 +384,6 @@ void NoiseFilter::filter_tail(
                 isNextBlock = true;
             }
         }
-
-        lastAngle = angle;//last angle
-        lastRange = range;//last range
     }
 
     /*for (int i = 0; i < m_block_vct.size(); i++) {
@@ -451,6 +464,12 @@ void NoiseFilter::filter_tail2(
         return;
     }
 
+    m_scan.assign(in.points);
+    const float *ranges = m_scan.range.data();
+    const float *angles = m_scan.angle.data();
+    const float *xs = m_scan.x.data();
+    const float *ys = m_scan.y.data();
+
     //1、找出连续（至少3个）点倾斜角朝向原点（极点）的点序列
     //2、判断该点序列首尾点组成的角度范围是否在光斑对应角度范围内
     //3、判断该点序列的强度信息是否满足约定条件（未找到规律，暂未使用）
@@ -459,7 +478,7 @@ void NoiseFilter::filter_tail2(
     std::vector<bool> noises; //是否为噪点的标记
     size_t size = in.points.size(); //一圈点数
     size_t lastIndex = 0; //上一个有效点的索引位置
-    LaserPoint lastP; //上一个点信息
+    float lastX = .0, lastY = .0, lastA = .0; //上一个点信息
     float lastIncline = .0; //上一个倾斜角
     float lastAngle = 90.0; //上一个夹角
     size_t pos = 0; //标记拖尾起始点下标位置
@@ -471,36 +490,27 @@ void NoiseFilter::filter_tail2(
     //主循环函数
     for (size_t i = 0; i < sizeEx; ++i)
     {
-        const LaserPoint& p = in.points.at(i % size);
+        const size_t k = i % size;
 
-        if (!isRangeValid(in.config, p.range))
+        if (!isRangeValid(in.config, ranges[k]))
         {
             continue;
         }
 
         if (i != 0)
         {
-            //计算两点连线、两点中间点到原点连线的倾斜角（弧度值）
-            float incline2 = calcTargetAngle(
-                        lastP.range,
-                        lastP.angle,
-                        p.range,
-                        p.angle);
-            float incline3 = calcTargetAngle(
-                        (lastP.range + p.range) / 2.0f,
-                        (lastP.angle + p.angle) / 2.0f,
-                        0.0f,
-                        0.0f);
+            //计算两点连线的倾斜角（弧度值）
+            float incline2 = atan2f(ys[k] - lastY, xs[k] - lastX);
+            //两点中间点到原点连线的方向即两点角度的平均值
+            float incline3 = (lastA + angles[k]) / 2.0f;
             //转角度值
             incline2 = ydlidar::core::math::to_degrees(incline2);
             incline3 = ydlidar::core::math::to_degrees(incline3);
 
             float incline = incline2;
 
-            //计算两点连线和两点中间点到原点连线的夹角
-            float angle = fabs(incline2 - incline3);
-            if (angle > 180.0f)
-                angle = 360.0f - angle;
+            //计算两点连线和两点中间点到原点连线的夹角（锐角）
+            float angle = fmodf(fabs(incline2 - incline3), 180.0f);
             if (angle > 90.0f)
                 angle = 180.0f - angle;
 
@@ -533,7 +543,7 @@ void NoiseFilter::filter_tail2(
                         size_t validCount = 0;
                         for (size_t j=pos; j<=i; ++j)
                         {
-                            if (isRangeValid(in.config, in.points[i % size].range))
+                            if (isRangeValid(in.config, ranges[i % size]))
                                 validCount += 1;
                         }
                         if (validCount >= MIN_NOISEPOINT_COUNT)
@@ -563,7 +573,9 @@ void NoiseFilter::filter_tail2(
         }
 
         lastIndex = i;
-        lastP = p;
+        lastX = xs[k];
+        lastY = ys[k];
+        lastA = angles[k];
     }
 
     //处理被标记的点
@@ -1,6 +1,7 @@
 #ifndef NOISEFILTER_H
 #define NOISEFILTER_H
 #include "FilterInterface.h"
+#include "ScanArrays.h"
 
 #define MAX_INCLUDE_ANGLE 12.0f //最大夹角
 #define MAX_INCLINE_ANGLE 7.0f //最大倾斜角
@@ -102,6 +103,11 @@ protected:
 
     float maxIncludeAngle = MAX_INCLUDE_ANGLE;
     float maxInclineAngle = MAX_INCLINE_ANGLE;
+
+    ScanArrays m_scan; //输入点的连续数组形式
+    std::vector<float> m_deltaSin; //与上一个点夹角的正弦
+    std::vector<float> m_deltaCos; //与上一个点夹角的余弦
+    std::vector<float> m_pairOffset; //与上一个点连线的偏移量
 };
 
 #endif // NOISEFILTER_H
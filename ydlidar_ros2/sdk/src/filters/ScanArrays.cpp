@@ -0,0 +1,40 @@
+#include <math.h>
+#include "ScanArrays.h"
+
+void ScanArrays::assign(const std::vector<LaserPoint> &points)
+{
+    const size_t size = points.size();
+    range.resize(size);
+    angle.resize(size);
+    cosA.resize(size);
+    sinA.resize(size);
+    x.resize(size);
+    y.resize(size);
+
+    if (!size) {
+        return;
+    }
+
+    //LaserPoint为紧凑结构体，先拆分成连续数组
+    const LaserPoint *p = &points[0];
+    float *r = &range[0];
+    float *a = &angle[0];
+    for (size_t i = 0; i < size; ++i) {
+        r[i] = p[i].range;
+        a[i] = p[i].angle;
+    }
+
+    float *c = &cosA[0];
+    float *s = &sinA[0];
+    for (size_t i = 0; i < size; ++i) {
+        c[i] = cosf(a[i]);
+        s[i] = sinf(a[i]);
+    }
+
+    float *px = &x[0];
+    float *py = &y[0];
+    for (size_t i = 0; i < size; ++i) {
+        px[i] = r[i] * c[i];
+        py[i] = r[i] * s[i];
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef SCANARRAYS_H
+#define SCANARRAYS_H
+#include <vector>
+#include "core/common/ydlidar_protocol.h"
+
+
+//一圈点的结构体数组形式（SoA），各字段连续存放以便编译器向量化
+struct ScanArrays
+{
+    std::vector<float> range;
+    std::vector<float> angle;
+    std::vector<float> cosA; //cos(angle)
+    std::vector<float> sinA; //sin(angle)
+    std::vector<float> x; //直角坐标
+    std::vector<float> y;
+
+    size_t size() const {
+        return range.size();
+    }
+
+    //从点数组拆分，每个点的正余弦只计算一次；容量在多圈之间复用
+    void assign(const std::vector<LaserPoint> &points);
+};
+
+#endif // SCANARRAYS_H
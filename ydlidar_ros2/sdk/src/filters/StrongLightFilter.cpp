@@ -47,27 +47,48 @@ void StrongLightFilter::filter(
     // 将遍历范围扩大到原数组的104%以便处理首尾部分的点
     int sizeEx = int(size * 1.04);
     int startI = -1;  // 标记拖尾起始点下标位置
-    LaserPoint lastP; // 上一个点信息
+
+    // 预先计算每个点与上一个点连线的距离和夹角，主循环中只做判断
+    m_scan.assign(out.points);
+    const float *ranges = m_scan.range.data();
+    const float *xs = m_scan.x.data();
+    const float *ys = m_scan.y.data();
+    m_lineDist.resize(size);
+    m_lineAngleOk.resize(size);
+    float *lineDist = m_lineDist.data();
+    uint8_t *lineAngleOk = m_lineAngleOk.data();
+    // 锐角小于阈值即夹角余弦的绝对值大于阈值的余弦，不需要反余弦
+    const float cosMaxAngle = cos(ydlidar::core::math::from_degrees(maxAngle));
+    for (int k = 0; k < size; ++k)
+    {
+        int l = k > 0 ? k - 1 : size - 1; // 上一个点
+        float vx = xs[l] - xs[k]; // 两点连线
+        float vy = ys[l] - ys[k];
+        float mx = (xs[k] + xs[l]) / 2.0f; // 两点中点到原点连线
+        float my = (ys[k] + ys[l]) / 2.0f;
+        float len = sqrtf(vx * vx + vy * vy);
+        // 计算两点连线到原点的距离（直角坐标系），同Point::calcDist
+        if (IS_ZERO(vx) && IS_ZERO(vy))
+            lineDist[k] = sqrtf(xs[k] * xs[k] + ys[k] * ys[k]);
+        else
+            lineDist[k] = fabsf(xs[l] * ys[k] - xs[k] * ys[l]) / len;
+        // 计算两线段组成直线的夹角（直角坐标系），同Point::calcAngle
+        float dot = vx * mx + vy * my;
+        lineAngleOk[k] = fabsf(dot) > cosMaxAngle * len * sqrtf(mx * mx + my * my);
+    }
 
     // 主循环函数
     for (int i = 0; i < sizeEx; ++i)
     {
-        const LaserPoint &p = out.points.at(i % size);
+        const int k = i % size;
         if (i != 0)
         {
-            
-            Point p1 = Point::polar2Angular(Point(p.angle, p.range));
-            Point p2 = Point::polar2Angular(Point(lastP.angle, lastP.range));
-            Point p3 = Point(0, 0); //原点
-            Point p4 = Point((p1.x + p2.x) / 2.0f, (p1.y + p2.y) / 2.0f); //两点中点
-            // 计算两点连线到原点的距离（直角坐标系）
-            float d = Point::calcDist(p3, p1, p2);
-            //计算两线段组成直线的夹角（直角坐标系）
-            float a = Point::calcAngle(p1, p2, p3, p4);
+            float d = lineDist[k];
+            bool a = lineAngleOk[k] != 0;
 
             // printf("点[%d]距离[%.03f]\n", i % size, d);
             // 如果当前距离小于标准，且角度小于标准，则认为是拖尾点
-            if (d < maxDist && a < maxAngle)
+            if (d < maxDist && a)
             {
                 // 如果起始点无效则标记
                 if (-1 == startI)
@@ -75,9 +96,9 @@ void StrongLightFilter::filter(
             }
             // 如果点的距离是在增加的，且当前距离小于2倍标准，且角度小于标准，则认为是拖尾点
             else if (-1 != startI &&
-                p.range > lastP.range &&
-                d < maxDist * 2 && 
-                a < maxAngle)
+                ranges[k] > ranges[k > 0 ? k - 1 : size - 1] &&
+                d < maxDist * 2 &&
+                a)
             {
                 // 无处理
             }
@@ -99,7 +120,6 @@ void StrongLightFilter::filter(
                 startI = -1;
             }
         }
-        lastP = p;
     }
 
     // 处理被标记的点
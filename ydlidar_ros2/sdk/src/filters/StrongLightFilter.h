@@ -1,6 +1,7 @@
 #ifndef STRONGLIGHTFILTER_H
 #define STRONGLIGHTFILTER_H
 #include "FilterInterface.h"
+#include "ScanArrays.h"
 
 
 //强光滤波器（拖尾滤波器）
@@ -51,6 +52,10 @@ protected:
     float maxDist = 0.05; //最大距离阈值，单位米（此值可根据需要自己修改）
     float maxAngle = 12.0; //最大角度阈值，单位°（此值可根据需要自己修改）
     int minNoise = 2; //最小连续噪点数（此值可根据需要自己修改）
+
+    ScanArrays m_scan; //排序后点的连续数组形式
+    std::vector<float> m_lineDist; //与上一个点连线到原点的距离
+    std::vector<uint8_t> m_lineAngleOk; //与上一个点连线和中点连线的夹角是否小于阈值
 };
 
 #endif // STRONGLIGHTFILTER_H
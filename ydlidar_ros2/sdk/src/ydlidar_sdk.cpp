@@ -23,6 +23,7 @@
 //
 
 #include <sstream>
+#include <algorithm>
 #include "ydlidar_sdk.h"
 #include "CYdLidar.h"
 #include "ydlidar_config.h"
@@ -126,6 +127,12 @@ bool turnOn(YDLidar *lidar) {
   return false;
 }
 
+/// 每个调用线程复用一份中间结果，点数组容量在多圈之间保留
+static LaserScan &scratchScan() {
+  static thread_local LaserScan scan;
+  return scan;
+}
+
 bool doProcessSimple(YDLidar *lidar, LaserFan *outscan) {
   if (lidar == NULL || lidar->lidar == NULL || outscan == NULL) {
     return false;
@@ -137,7 +144,7 @@ bool doProcessSimple(YDLidar *lidar, LaserFan *outscan) {
   CYdLidar *drv = static_cast<CYdLidar *>(lidar->lidar);
 
   if (drv) {
-    LaserScan scan;
+    LaserScan &scan = scratchScan();
     bool ret = drv->doProcessSimple(scan);
     outscan->config = scan.config;
     outscan->stamp = scan.stamp;
@@ -150,6 +157,40 @@ bool doProcessSimple(YDLidar *lidar, LaserFan *outscan) {
   return false;
 }
 
+bool doProcessSimpleInto(YDLidar *lidar, LaserFan *outscan, uint32_t capacity,
+                         uint32_t *total) {
+  if (total) {
+    *total = 0;
+  }
+
+  if (lidar == NULL || lidar->lidar == NULL || outscan == NULL ||
+      (outscan->points == NULL && capacity > 0)) {
+    return false;
+  }
+
+  outscan->npoints = 0;
+  CYdLidar *drv = static_cast<CYdLidar *>(lidar->lidar);
+
+  if (drv) {
+    LaserScan &scan = scratchScan();
+    bool ret = drv->doProcessSimple(scan);
+    size_t count = std::min(scan.points.size(), static_cast<size_t>(capacity));
+    outscan->config = scan.config;
+    outscan->stamp = scan.stamp;
+    outscan->npoints = count;
+    std::copy(scan.points.begin(), scan.points.begin() + count, outscan->points);
+
+    //截断时调用者据此判断缓存是否不足
+    if (total) {
+      *total = scan.points.size();
+    }
+
+    return ret;
+  }
+
+  return false;
+}
+
 bool turnOff(YDLidar *lidar) {
   if (lidar == NULL || lidar->lidar == NULL) {
     return false;
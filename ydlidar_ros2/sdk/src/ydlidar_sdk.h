@@ -220,6 +220,36 @@ YDLIDAR_API bool turnOn(YDLidar *lidar);
  * @return true if successfully started, otherwise false.
  */
 YDLIDAR_API bool doProcessSimple(YDLidar *lidar, LaserFan *outscan);
+/**
+ * @brief Get the LiDAR Scan Data into a caller owned buffer.
+ * Unlike ::doProcessSimple nothing is allocated, so it can be called at the
+ * full scan rate for a long time without fragmenting the heap.
+ * @param[in] lidar          LiDAR instance
+ * @param[in,out] outscan    LiDAR Scan Data, outscan->points is the caller's
+ * buffer. It is filled in place and never freed or reallocated, so do not
+ * call ::LaserFanDestroy on it unless it came from malloc.
+ * @param[in] capacity       number of points outscan->points can hold
+ * @param[out] total         number of points in the revolution before
+ * truncation, may be NULL
+ * @return true if successfully started, otherwise false.
+ * @note A revolution with more than capacity points is truncated,
+ * outscan->npoints is the number of points written and *total is larger
+ * than outscan->npoints. Size the buffer for sample rate / scan frequency
+ * points at the lowest scan frequency.
+ * @par usage
+ * @code
+ * static LaserPoint points[5000];
+ * LaserFan scan;
+ * uint32_t total = 0;
+ * LaserFanInit(&scan);
+ * scan.points = points;
+ * while (os_isOk() && doProcessSimpleInto(laser, &scan, 5000, &total)) {
+ *   //use scan.points[0, scan.npoints), total > scan.npoints if truncated
+ * }
+ * @endcode
+ */
+YDLIDAR_API bool doProcessSimpleInto(YDLidar *lidar, LaserFan *outscan,
+                                     uint32_t capacity, uint32_t *total);
 /**
  * @brief Stop the device scanning thread and disable motor.
  * @return true if successfully Stoped, otherwise false.
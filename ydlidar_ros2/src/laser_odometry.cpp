@@ -0,0 +1,373 @@
+/*
+ *  YDLIDAR SYSTEM
+ *  YDLIDAR ROS 2 Node
+ *
+ *  Copyright 2017 - 2020 EAI TEAM
+ *  http://www.eaibot.com
+ *
+ */
+
+#include "laser_odometry.h"
+#include <math.h>
+#include <algorithm>
+
+namespace ydlidar_ros2 {
+
+//粗层栅格边长为精细层的倍数
+static const int COARSE_FACTOR = 4;
+//高斯核的标准差和半径，以格为单位，各层相同，只需算一次
+static const double KERNEL_SIGMA = 1.5;
+static const int KERNEL_RADIUS = 5;
+static const int KERNEL_SIZE = 2 * KERNEL_RADIUS + 1;
+//粗搜索保留的候选数，粗层得分不是精细层的上界，多留几个避免错过
+static const size_t COARSE_CANDIDATES = 3;
+static const int REFINE_ITERATIONS = 5;
+//有效点太少时无法可靠匹配
+static const size_t MIN_POINTS = 30;
+
+namespace {
+
+struct Kernel {
+  uint8_t values[KERNEL_SIZE * KERNEL_SIZE];
+
+  Kernel() {
+    for (int dy = -KERNEL_RADIUS; dy <= KERNEL_RADIUS; dy++) {
+      for (int dx = -KERNEL_RADIUS; dx <= KERNEL_RADIUS; dx++) {
+        double d2 = dx * dx + dy * dy;
+        values[(dy + KERNEL_RADIUS) * KERNEL_SIZE + dx + KERNEL_RADIUS] =
+          static_cast<uint8_t>(lround(255.0 * exp(-d2 / (2.0 * KERNEL_SIGMA * KERNEL_SIGMA))));
+      }
+    }
+  }
+};
+
+}  // namespace
+
+static double normalizeAngle(double a) {
+  return atan2(sin(a), cos(a));
+}
+
+Pose2D composePose(const Pose2D &a, const Pose2D &b) {
+  const double c = cos(a.yaw);
+  const double s = sin(a.yaw);
+  Pose2D r;
+  r.x = a.x + c * b.x - s * b.y;
+  r.y = a.y + s * b.x + c * b.y;
+  r.yaw = normalizeAngle(a.yaw + b.yaw);
+  return r;
+}
+
+Pose2D invertPose(const Pose2D &a) {
+  const double c = cos(a.yaw);
+  const double s = sin(a.yaw);
+  Pose2D r;
+  r.x = -(c * a.x + s * a.y);
+  r.y = -(-s * a.x + c * a.y);
+  r.yaw = -a.yaw;
+  return r;
+}
+
+LaserOdometry::LaserOdometry(const LaserOdometryConfig &config)
+  : config_(config),
+    max_point_range_(1.0f),
+    has_key_(false),
+    score_(0.0) {
+  if (config_.resolution <= 0.0) {
+    config_.resolution = 0.025;
+  }
+  if (config_.max_points < static_cast<int>(MIN_POINTS)) {
+    config_.max_points = MIN_POINTS;
+  }
+}
+
+void LaserOdometry::reset(const Pose2D &pose) {
+  has_key_ = false;
+  key_pose_ = pose;
+  relative_ = Pose2D();
+  score_ = 0.0;
+}
+
+void LaserOdometry::selectPoints(const LaserScan &scan) {
+  const int bins = config_.max_points;
+  const double bin_scale = bins / (2.0 * M_PI);
+  const float max_range = std::min<float>(config_.max_range, scan.config.max_range);
+  xs_.clear();
+  ys_.clear();
+  bin_used_.assign(bins, 0);
+  max_point_range_ = 1.0f;
+
+  //每个角度格只取一个点，近处密集的点不会主导匹配
+  for (size_t i = 0; i < scan.points.size(); i++) {
+    const LaserPoint &p = scan.points[i];
+    if (p.range <= 0.0f || p.range < scan.config.min_range || p.range > max_range) {
+      continue;
+    }
+    int bin = static_cast<int>((p.angle + M_PI) * bin_scale);
+    bin = std::min(std::max(bin, 0), bins - 1);
+    if (bin_used_[bin]) {
+      continue;
+    }
+    bin_used_[bin] = 1;
+    xs_.push_back(p.range * cosf(p.angle));
+    ys_.push_back(p.range * sinf(p.angle));
+    max_point_range_ = std::max(max_point_range_, p.range);
+  }
+}
+
+void LaserOdometry::buildGrid(Grid &grid, double resolution, int window) {
+  float min_x = key_xs_[0], max_x = key_xs_[0];
+  float min_y = key_ys_[0], max_y = key_ys_[0];
+  for (size_t i = 1; i < key_xs_.size(); i++) {
+    min_x = std::min(min_x, key_xs_[i]);
+    max_x = std::max(max_x, key_xs_[i]);
+    min_y = std::min(min_y, key_ys_[i]);
+    max_y = std::max(max_y, key_ys_[i]);
+  }
+
+  //边缘留出核半径和两倍搜索窗口，越界的点钳到边缘后只会落在0值格上
+  const int margin = 2 * window + KERNEL_RADIUS + 2;
+  grid.resolution = resolution;
+  grid.window = window;
+  grid.origin_x = (floor(min_x / resolution) - margin) * resolution;
+  grid.origin_y = (floor(min_y / resolution) - margin) * resolution;
+  grid.width = static_cast<int>(ceil((max_x - grid.origin_x) / resolution)) + margin + 1;
+  grid.height = static_cast<int>(ceil((max_y - grid.origin_y) / resolution)) + margin + 1;
+  grid.cells.assign(static_cast<size_t>(grid.width) * grid.height, 0);
+
+  static const Kernel kernel;
+  for (size_t i = 0; i < key_xs_.size(); i++) {
+    const int cx = static_cast<int>(lround((key_xs_[i] - grid.origin_x) / resolution));
+    const int cy = static_cast<int>(lround((key_ys_[i] - grid.origin_y) / resolution));
+    for (int dy = 0; dy < KERNEL_SIZE; dy++) {
+      uint8_t *row = &grid.cells[(cy + dy - KERNEL_RADIUS) * grid.width + cx - KERNEL_RADIUS];
+      const uint8_t *k = &kernel.values[dy * KERNEL_SIZE];
+      for (int dx = 0; dx < KERNEL_SIZE; dx++) {
+        row[dx] = std::max(row[dx], k[dx]);
+      }
+    }
+  }
+}
+
+void LaserOdometry::setKeyframe() {
+  key_xs_.assign(xs_.begin(), xs_.end());
+  key_ys_.assign(ys_.begin(), ys_.end());
+  const double coarse_resolution = config_.resolution * COARSE_FACTOR;
+  buildGrid(coarse_, coarse_resolution,
+            std::max(1, static_cast<int>(ceil(config_.search_linear / coarse_resolution))));
+  //精细层只在粗层最优解的一格范围内搜索
+  buildGrid(fine_, config_.resolution, COARSE_FACTOR / 2 + 1);
+  has_key_ = true;
+}
+
+void LaserOdometry::projectPoints(const Grid &grid, double yaw, double x, double y,
+                                  int border) {
+  const float inv = 1.0 / grid.resolution;
+  const float fc = cos(yaw) * inv;
+  const float fs = sin(yaw) * inv;
+  const float ox = (x - grid.origin_x) * inv + 0.5f;
+  const float oy = (y - grid.origin_y) * inv + 0.5f;
+  const float lo = border;
+  const float hi_x = grid.width - 1 - border;
+  const float hi_y = grid.height - 1 - border;
+  const int width = grid.width;
+  const size_t n = xs_.size();
+  cells_.resize(n);
+  const float *xs = xs_.data();
+  const float *ys = ys_.data();
+  int32_t *cells = cells_.data();
+
+  //无分支，编译器可向量化
+  for (size_t i = 0; i < n; i++) {
+    float u = xs[i] * fc - ys[i] * fs + ox;
+    float v = xs[i] * fs + ys[i] * fc + oy;
+    u = std::min(std::max(u, lo), hi_x);
+    v = std::min(std::max(v, lo), hi_y);
+    cells[i] = static_cast<int32_t>(v) * width + static_cast<int32_t>(u);
+  }
+}
+
+void LaserOdometry::searchAngle(const Grid &grid, double yaw, double x, double y,
+                                size_t keep, std::vector<Candidate> &best) {
+  const int window = grid.window;
+  projectPoints(grid, yaw, x, y, window);
+  const size_t n = cells_.size();
+  const int32_t *cells = cells_.data();
+
+  for (int dy = -window; dy <= window; dy++) {
+    for (int dx = -window; dx <= window; dx++) {
+      //平移是整格偏移，得分只是查表求和
+      const uint8_t *base = grid.cells.data() + dy * grid.width + dx;
+      uint32_t score = 0;
+      for (size_t i = 0; i < n; i++) {
+        score += base[cells[i]];
+      }
+
+      if (best.size() >= keep && score <= best.back().score) {
+        continue;
+      }
+      Candidate candidate = {x + dx * grid.resolution, y + dy * grid.resolution, yaw, score};
+      if (best.size() >= keep) {
+        best.pop_back();
+      }
+      std::vector<Candidate>::iterator it = best.begin();
+      while (it != best.end() && it->score >= score) {
+        ++it;
+      }
+      best.insert(it, candidate);
+    }
+  }
+}
+
+uint32_t LaserOdometry::evaluate(const Grid &grid, const Pose2D &rel) {
+  projectPoints(grid, rel.yaw, rel.x, rel.y, 0);
+  uint32_t score = 0;
+  for (size_t i = 0; i < cells_.size(); i++) {
+    score += grid.cells[cells_[i]];
+  }
+  return score;
+}
+
+void LaserOdometry::refine(Pose2D &rel) {
+  const Grid &grid = fine_;
+  const double inv = 1.0 / grid.resolution;
+  const uint8_t *cells = grid.cells.data();
+
+  for (int iteration = 0; iteration < REFINE_ITERATIONS; iteration++) {
+    const double c = cos(rel.yaw);
+    const double s = sin(rel.yaw);
+    double h[6] = {0, 0, 0, 0, 0, 0}; // H的上三角：xx xy xt yy yt tt
+    double b[3] = {0, 0, 0};
+
+    for (size_t i = 0; i < xs_.size(); i++) {
+      const double rx = c * xs_[i] - s * ys_[i];
+      const double ry = s * xs_[i] + c * ys_[i];
+      double u = (rel.x + rx - grid.origin_x) * inv;
+      double v = (rel.y + ry - grid.origin_y) * inv;
+      u = std::min(std::max(u, 0.0), grid.width - 2.0);
+      v = std::min(std::max(v, 0.0), grid.height - 2.0);
+      const int iu = static_cast<int>(u);
+      const int iv = static_cast<int>(v);
+      const double fu = u - iu;
+      const double fv = v - iv;
+      const uint8_t *p = cells + iv * grid.width + iu;
+      const double m00 = p[0], m10 = p[1];
+      const double m01 = p[grid.width], m11 = p[grid.width + 1];
+
+      //双线性插值及其梯度，归一化到0..1
+      const double m = ((1 - fv) * ((1 - fu) * m00 + fu * m10) +
+                        fv * ((1 - fu) * m01 + fu * m11)) / 255.0;
+      const double gx = ((1 - fv) * (m10 - m00) + fv * (m11 - m01)) * inv / 255.0;
+      const double gy = ((1 - fu) * (m01 - m00) + fu * (m11 - m10)) * inv / 255.0;
+      const double gt = gx * -ry + gy * rx;
+      const double r = 1.0 - m;
+
+      h[0] += gx * gx;
+      h[1] += gx * gy;
+      h[2] += gx * gt;
+      h[3] += gy * gy;
+      h[4] += gy * gt;
+      h[5] += gt * gt;
+      b[0] += gx * r;
+      b[1] += gy * r;
+      b[2] += gt * r;
+    }
+
+    //3x3对称矩阵求逆，加少量阻尼防止退化（如长走廊）
+    h[0] += 1e-3;
+    h[3] += 1e-3;
+    h[5] += 1e-3;
+    const double c0 = h[3] * h[5] - h[4] * h[4];
+    const double c1 = h[2] * h[4] - h[1] * h[5];
+    const double c2 = h[1] * h[4] - h[2] * h[3];
+    const double det = h[0] * c0 + h[1] * c1 + h[2] * c2;
+    if (fabs(det) < 1e-12) {
+      return;
+    }
+    const double i11 = h[0] * h[5] - h[2] * h[2];
+    const double i12 = h[1] * h[2] - h[0] * h[4];
+    const double i22 = h[0] * h[3] - h[1] * h[1];
+    const double dx = (c0 * b[0] + c1 * b[1] + c2 * b[2]) / det;
+    const double dy = (c1 * b[0] + i11 * b[1] + i12 * b[2]) / det;
+    const double dt = (c2 * b[0] + i12 * b[1] + i22 * b[2]) / det;
+
+    //单步不超过一格，避免跳出收敛域
+    if (fabs(dx) > grid.resolution || fabs(dy) > grid.resolution) {
+      return;
+    }
+    rel.x += dx;
+    rel.y += dy;
+    rel.yaw = normalizeAngle(rel.yaw + dt);
+  }
+}
+
+bool LaserOdometry::update(const LaserScan &scan, const Pose2D &motion, Pose2D &pose) {
+  selectPoints(scan);
+  const Pose2D guess = composePose(relative_, motion);
+
+  if (xs_.size() < MIN_POINTS) {
+    relative_ = guess;
+    pose = composePose(key_pose_, relative_);
+    score_ = 0.0;
+    return false;
+  }
+
+  if (!has_key_) {
+    relative_ = Pose2D();
+    setKeyframe();
+    pose = key_pose_;
+    score_ = 1.0;
+    return true;
+  }
+
+  //角度步长使最远的点移动约一格
+  const double far = max_point_range_;
+  const double coarse_step = coarse_.resolution / far;
+  const double fine_step = fine_.resolution / far;
+  const int coarse_steps = static_cast<int>(ceil(config_.search_angular / coarse_step));
+  const int fine_steps = static_cast<int>(ceil(0.5 * coarse_step / fine_step));
+
+  candidates_.clear();
+  for (int k = -coarse_steps; k <= coarse_steps; k++) {
+    searchAngle(coarse_, guess.yaw + k * coarse_step, guess.x, guess.y,
+                COARSE_CANDIDATES, candidates_);
+  }
+
+  fine_best_.clear();
+  for (size_t i = 0; i < candidates_.size(); i++) {
+    for (int k = -fine_steps; k <= fine_steps; k++) {
+      searchAngle(fine_, candidates_[i].yaw + k * fine_step, candidates_[i].x,
+                  candidates_[i].y, 1, fine_best_);
+    }
+  }
+
+  Pose2D best;
+  best.x = fine_best_[0].x;
+  best.y = fine_best_[0].y;
+  best.yaw = normalizeAngle(fine_best_[0].yaw);
+  uint32_t best_score = fine_best_[0].score;
+
+  Pose2D refined = best;
+  refine(refined);
+  uint32_t refined_score = evaluate(fine_, refined);
+  if (refined_score >= best_score) {
+    best = refined;
+    best_score = refined_score;
+  }
+
+  score_ = best_score / (255.0 * xs_.size());
+  const bool matched = score_ >= config_.min_score;
+  relative_ = matched ? best : guess;
+  pose = composePose(key_pose_, relative_);
+
+  //走远、转多或匹配失败时以当前圈作为新的参考帧
+  if (!matched || hypot(relative_.x, relative_.y) > config_.keyframe_distance ||
+      fabs(relative_.yaw) > config_.keyframe_angle) {
+    key_pose_ = pose;
+    relative_ = Pose2D();
+    setKeyframe();
+  }
+
+  return matched;
+}
+
+}  // namespace ydlidar_ros2
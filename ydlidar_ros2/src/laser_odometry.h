@@ -0,0 +1,139 @@
+/*
+ *  YDLIDAR SYSTEM
+ *  YDLIDAR ROS 2 Node
+ *
+ *  Copyright 2017 - 2020 EAI TEAM
+ *  http://www.eaibot.com
+ *
+ */
+
+#ifndef YDLIDAR_LASER_ODOMETRY_H
+#define YDLIDAR_LASER_ODOMETRY_H
+
+#include <stdint.h>
+#include <vector>
+#include "src/CYdLidar.h"
+
+namespace ydlidar_ros2 {
+
+/// 平面位姿，yaw单位为弧度
+struct Pose2D {
+  double x = 0.0;
+  double y = 0.0;
+  double yaw = 0.0;
+};
+
+/// a ∘ b：先a后b
+Pose2D composePose(const Pose2D &a, const Pose2D &b);
+/// a的逆
+Pose2D invertPose(const Pose2D &a);
+
+struct LaserOdometryConfig {
+  double resolution = 0.025;        ///< 精细层栅格边长(m)，粗层为其4倍
+  double max_range = 8.0;           ///< 参与匹配的最远距离(m)
+  int max_points = 400;             ///< 每圈参与匹配的点数，按角度分格抽取
+  double search_linear = 0.2;       ///< 在预测位置附近搜索的平移范围(m)
+  double search_angular = 0.26;     ///< 在预测朝向附近搜索的旋转范围(rad)
+  double keyframe_distance = 0.15;  ///< 相对参考帧移动超过此距离后更换参考帧(m)
+  double keyframe_angle = 0.17;     ///< 或转动超过此角度(rad)
+  double min_score = 0.35;          ///< 匹配得分低于此值时不采用，按预测推算
+};
+
+/**
+ * @brief Laser odometry by correlative scan matching against a reference scan.
+ *
+ * The reference (key) scan is rendered once into two lookup grids, a
+ * fine one and a 4x coarser one, where every cell holds a precomputed
+ * Gaussian of the distance to the nearest reference point. A scan is
+ * matched by:
+ * - an exhaustive search around the predicted pose on the coarse grid;
+ * - a finer search around the best few coarse candidates;
+ * - a few Gauss-Newton steps on the bilinearly interpolated fine grid.
+ *
+ * Per candidate rotation the points are rotated once and converted to
+ * cell indices. Every translation is then an integer offset, so the
+ * score is a sum of byte lookups.
+ *
+ * Matching is against the key scan rather than the previous one, so
+ * standing still does not drift. The key scan is replaced after moving
+ * keyframe_distance or turning keyframe_angle.
+ */
+class LaserOdometry {
+ public:
+  explicit LaserOdometry(const LaserOdometryConfig &config = LaserOdometryConfig());
+
+  /**
+   * @brief Match a revolution.
+   * @param scan revolution in the laser frame
+   * @param motion predicted laser motion since the previous revolution,
+   * e.g. from wheel odometry, identity if unknown
+   * @param[out] pose laser pose in the odometry frame
+   * @return true if the scan matched, false if the prediction was used
+   */
+  bool update(const LaserScan &scan, const Pose2D &motion, Pose2D &pose);
+
+  /// Score of the last match, 0..1.
+  double score() const {
+    return score_;
+  }
+
+  /// Drop the key scan and restart from pose.
+  void reset(const Pose2D &pose = Pose2D());
+
+ private:
+  /// 预计算的查找栅格，格值为到最近参考点距离的高斯函数(0..255)
+  struct Grid {
+    double resolution = 0.0;
+    double origin_x = 0.0;  ///< 格(0,0)中心的坐标
+    double origin_y = 0.0;
+    int width = 0;
+    int height = 0;
+    int window = 0;         ///< 本层搜索的最大格偏移
+    std::vector<uint8_t> cells;
+  };
+
+  struct Candidate {
+    double x;
+    double y;
+    double yaw;
+    uint32_t score;
+  };
+
+  /// 抽取参与匹配的点
+  void selectPoints(const LaserScan &scan);
+  /// 当前点作为参考帧，重建各层栅格
+  void setKeyframe();
+  void buildGrid(Grid &grid, double resolution, int window);
+  /// 固定朝向，在(x, y)附近的平移窗口内穷举，best中保留得分最高的keep个
+  void searchAngle(const Grid &grid, double yaw, double x, double y, size_t keep,
+                   std::vector<Candidate> &best);
+  /// 各点旋转平移后换算为格序号，写入cells_
+  void projectPoints(const Grid &grid, double yaw, double x, double y, int border);
+  /// 在精细层上用高斯牛顿法做亚格优化
+  void refine(Pose2D &rel);
+  uint32_t evaluate(const Grid &grid, const Pose2D &rel);
+
+  LaserOdometryConfig config_;
+  Grid coarse_;
+  Grid fine_;
+
+  //当前圈的点，按坐标分量分开存放，便于向量化
+  std::vector<float> xs_;
+  std::vector<float> ys_;
+  std::vector<float> key_xs_;
+  std::vector<float> key_ys_;
+  std::vector<int32_t> cells_;       ///< 当前朝向下各点所在格的序号
+  std::vector<uint8_t> bin_used_;
+  std::vector<Candidate> candidates_;
+  std::vector<Candidate> fine_best_;
+  float max_point_range_;
+
+  bool has_key_;
+  Pose2D key_pose_;   ///< 参考帧在里程计坐标系中的位姿
+  Pose2D relative_;   ///< 当前帧相对参考帧的位姿
+  double score_;
+};
+
+}  // namespace ydlidar_ros2
+
+#endif  // YDLIDAR_LASER_ODOMETRY_H
@@ -0,0 +1,146 @@
+/*
+ *  YDLIDAR SYSTEM
+ *  YDLIDAR ROS 2 Node
+ *
+ *  Copyright 2017 - 2020 EAI TEAM
+ *  http://www.eaibot.com
+ *
+ */
+
+#include "range_image.h"
+#include <math.h>
+#include <string.h>
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#endif
+
+namespace ydlidar_ros2 {
+
+//编码时复用的中间缓存，只在扫描线程中使用
+static thread_local std::vector<uint16_t> t_quant;
+static thread_local std::vector<uint8_t> t_planes;
+
+bool rangeImageHasLz4() {
+#ifdef HAVE_LZ4
+  return true;
+#else
+  return false;
+#endif
+}
+
+void encodeRangeImage(const LaserScan &scan, float resolution,
+                      std::vector<uint8_t> &out) {
+  RangeImageHeader header;
+  header.magic = RANGE_IMAGE_MAGIC;
+  header.version = RANGE_IMAGE_VERSION;
+  header.flags = 0;
+  header.reserved = 0;
+  header.angle_min = scan.config.min_angle;
+  header.angle_increment = scan.config.angle_increment;
+  header.resolution = resolution;
+
+  //与LaserScan相同的分格方式
+  int size = 0;
+  if (scan.config.angle_increment > 0) {
+    size = (scan.config.max_angle - scan.config.min_angle) / scan.config.angle_increment + 1;
+  }
+  if (size < 0 || size > RANGE_IMAGE_MAX_COUNT) {
+    size = 0;
+  }
+  header.count = size;
+  header.payload_size = 2 * size;
+
+  t_quant.assign(size, 0);
+  const float scale = 1.0f / resolution;
+  for (size_t i = 0; i < scan.points.size(); i++) {
+    const LaserPoint &p = scan.points[i];
+    int index = std::ceil((p.angle - scan.config.min_angle) / scan.config.angle_increment);
+    if (index < 0 || index >= size || p.range < scan.config.min_range ||
+        p.range > scan.config.max_range) {
+      continue;
+    }
+    float q = p.range * scale + 0.5f;
+    if (q >= 1.0f && q <= 65535.0f) {
+      t_quant[index] = static_cast<uint16_t>(q);
+    }
+  }
+
+  //相邻差值做zigzag，低字节和高字节分两段存放
+  t_planes.resize(header.payload_size);
+  uint8_t *lo = t_planes.data();
+  uint8_t *hi = lo + size;
+  uint16_t prev = 0;
+  for (int i = 0; i < size; i++) {
+    int16_t delta = static_cast<int16_t>(t_quant[i] - prev);
+    uint16_t zz = static_cast<uint16_t>((delta << 1) ^ (delta >> 15));
+    lo[i] = zz & 0xff;
+    hi[i] = zz >> 8;
+    prev = t_quant[i];
+  }
+
+#ifdef HAVE_LZ4
+  const int bound = LZ4_compressBound(header.payload_size);
+  out.resize(sizeof(header) + bound);
+  int n = LZ4_compress_default(reinterpret_cast<const char *>(t_planes.data()),
+                               reinterpret_cast<char *>(out.data() + sizeof(header)),
+                               header.payload_size, bound);
+  if (n > 0) {
+    header.flags |= RANGE_IMAGE_FLAG_LZ4;
+    out.resize(sizeof(header) + n);
+    memcpy(out.data(), &header, sizeof(header));
+    return;
+  }
+#endif
+
+  out.resize(sizeof(header) + header.payload_size);
+  memcpy(out.data(), &header, sizeof(header));
+  memcpy(out.data() + sizeof(header), t_planes.data(), header.payload_size);
+}
+
+bool decodeRangeImage(const uint8_t *data, size_t size,
+                      RangeImageHeader &header, std::vector<float> &ranges) {
+  if (size < sizeof(header)) {
+    return false;
+  }
+  memcpy(&header, data, sizeof(header));
+  //先限制个数，2*count不会溢出
+  if (header.magic != RANGE_IMAGE_MAGIC || header.version != RANGE_IMAGE_VERSION ||
+      header.count > RANGE_IMAGE_MAX_COUNT ||
+      header.payload_size != 2 * header.count) {
+    return false;
+  }
+  data += sizeof(header);
+  size -= sizeof(header);
+
+  const uint8_t *planes = data;
+  if (header.flags & RANGE_IMAGE_FLAG_LZ4) {
+#ifdef HAVE_LZ4
+    t_planes.resize(header.payload_size);
+    int n = LZ4_decompress_safe(reinterpret_cast<const char *>(data),
+                                reinterpret_cast<char *>(t_planes.data()),
+                                size, header.payload_size);
+    if (n != static_cast<int>(header.payload_size)) {
+      return false;
+    }
+    planes = t_planes.data();
+#else
+    return false;
+#endif
+  } else if (size < header.payload_size) {
+    return false;
+  }
+
+  const uint8_t *lo = planes;
+  const uint8_t *hi = planes + header.count;
+  ranges.resize(header.count);
+  uint16_t value = 0;
+  for (uint32_t i = 0; i < header.count; i++) {
+    uint16_t zz = lo[i] | (hi[i] << 8);
+    int16_t delta = static_cast<int16_t>((zz >> 1) ^ -(zz & 1));
+    value = static_cast<uint16_t>(value + delta);
+    ranges[i] = value * header.resolution;
+  }
+  return true;
+}
+
+}  // namespace ydlidar_ros2
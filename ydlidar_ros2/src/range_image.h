@@ -0,0 +1,77 @@
+/*
+ *  YDLIDAR SYSTEM
+ *  YDLIDAR ROS 2 Node
+ *
+ *  Copyright 2017 - 2020 EAI TEAM
+ *  http://www.eaibot.com
+ *
+ */
+
+#ifndef YDLIDAR_RANGE_IMAGE_H
+#define YDLIDAR_RANGE_IMAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "src/CYdLidar.h"
+
+namespace ydlidar_ros2 {
+
+/// 距离图格式名，写入sensor_msgs/CompressedImage的format字段
+#define RANGE_IMAGE_FORMAT "ydlidar_range_image"
+#define RANGE_IMAGE_MAGIC 0x49524459 // "YDRI"
+#define RANGE_IMAGE_VERSION 1
+#define RANGE_IMAGE_FLAG_LZ4 0x01
+/// 距离个数上限，解码时据此拒绝异常的头
+#define RANGE_IMAGE_MAX_COUNT 0x100000
+
+/**
+ * @brief Compact encoding of one revolution for low bandwidth links.
+ *
+ * The revolution is binned like sensor_msgs/LaserScan and every range is
+ * quantized to a uint16 multiple of the resolution, 0 meaning no return.
+ * Neighbouring ranges are close, so the values are stored as zigzag
+ * deltas split into a low byte plane and a high byte plane; the high
+ * plane is almost all zeros. The planes are LZ4 compressed when the
+ * driver was built with liblz4 (::RANGE_IMAGE_FLAG_LZ4).
+ *
+ * Layout, little endian: ::RangeImageHeader, then the payload.
+ */
+#pragma pack(push, 1)
+struct RangeImageHeader {
+  uint32_t magic;           ///< ::RANGE_IMAGE_MAGIC
+  uint8_t version;          ///< ::RANGE_IMAGE_VERSION
+  uint8_t flags;            ///< ::RANGE_IMAGE_FLAG_LZ4
+  uint16_t reserved;
+  uint32_t count;           ///< 距离个数，不超过::RANGE_IMAGE_MAX_COUNT
+  uint32_t payload_size;    ///< 压缩前的字节数，为2*count
+  float angle_min;          ///< 第一个距离的角度(rad)
+  float angle_increment;    ///< 角度间隔(rad)
+  float resolution;         ///< 距离量化单位(m)
+};
+#pragma pack(pop)
+
+/// Whether ::encodeRangeImage can compress.
+bool rangeImageHasLz4();
+
+/**
+ * @brief Encode a revolution.
+ * @param resolution quantization step in meters, ranges outside
+ * [min_range, max_range] or beyond 65535 * resolution are dropped
+ * @param out encoded bytes, capacity is reused between calls
+ */
+void encodeRangeImage(const LaserScan &scan, float resolution,
+                      std::vector<uint8_t> &out);
+
+/**
+ * @brief Decode a buffer produced by ::encodeRangeImage.
+ * @param ranges ranges in meters, 0 for no return
+ * @return false if the buffer is malformed or needs LZ4 which is not
+ * available
+ */
+bool decodeRangeImage(const uint8_t *data, size_t size,
+                      RangeImageHeader &header, std::vector<float> &ranges);
+
+}  // namespace ydlidar_ros2
+
+#endif  // YDLIDAR_RANGE_IMAGE_H
@@ -0,0 +1,601 @@
+/*
+ *  YDLIDAR SYSTEM
+ *  YDLIDAR ROS 2 Node
+ *
+ *  Copyright 2017 - 2020 EAI TEAM
+ *  http://www.eaibot.com
+ *
+ */
+
+#ifdef _MSC_VER
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+#endif
+
+#include "ydlidar_component.h"
+#include "range_image.h"
+#include <math.h>
+#include "rclcpp_components/register_node_macro.hpp"
+#include "core/base/trace.h"
+
+#define ROS2Verision "1.0.1"
+
+/// 将一圈点写入激光消息，消息中的数组容量在多圈之间复用
+static void fillScanMsg(const LaserScan &scan, const std::string &frame_id,
+                        sensor_msgs::msg::LaserScan &msg) {
+  msg.header.stamp.sec = RCL_NS_TO_S(scan.stamp);
+  msg.header.stamp.nanosec = scan.stamp - RCL_S_TO_NS(msg.header.stamp.sec);
+  msg.header.frame_id = frame_id;
+  msg.angle_min = scan.config.min_angle;
+  msg.angle_max = scan.config.max_angle;
+  msg.angle_increment = scan.config.angle_increment;
+  msg.scan_time = scan.config.scan_time;
+  msg.time_increment = scan.config.time_increment;
+  msg.range_min = scan.config.min_range;
+  msg.range_max = scan.config.max_range;
+
+  int size = (scan.config.max_angle - scan.config.min_angle)/ scan.config.angle_increment + 1;
+  if (size < 0) {
+    size = 0;
+  }
+  //assign而不是resize，复用的消息中需要清零上一圈的数据
+  msg.ranges.assign(size, 0.0f);
+  msg.intensities.assign(size, 0.0f);
+
+  for (size_t i = 0; i < scan.points.size(); i++) {
+    const LaserPoint &p = scan.points[i];
+    int index = std::ceil((p.angle - scan.config.min_angle)/scan.config.angle_increment);
+    if (index >= 0 && index < size && p.range >= scan.config.min_range) {
+      msg.ranges[index] = p.range;
+      msg.intensities[index] = p.intensity;
+    }
+  }
+}
+
+/// 按角度分格，每格只保留最近的点，返回保留的点序号（按角度顺序）
+static const std::vector<int> &selectCloudPoints(const LaserScan &scan, size_t bins) {
+  //只在扫描线程中使用，容量在多圈之间复用
+  static thread_local std::vector<int> best;
+  best.assign(bins, -1);
+  const float span = scan.config.max_angle - scan.config.min_angle;
+
+  for (size_t i = 0; i < scan.points.size(); i++) {
+    const LaserPoint &p = scan.points[i];
+    if (p.range < scan.config.min_range || p.range > scan.config.max_range) {
+      continue;
+    }
+    int bin = static_cast<int>((p.angle - scan.config.min_angle) / span * bins);
+    if (bin < 0 || bin >= static_cast<int>(bins)) {
+      continue;
+    }
+    if (best[bin] < 0 || p.range < scan.points[best[bin]].range) {
+      best[bin] = static_cast<int>(i);
+    }
+  }
+
+  //去掉空格，就地压缩
+  size_t n = 0;
+  for (size_t b = 0; b < bins; b++) {
+    if (best[b] >= 0) {
+      best[n++] = best[b];
+    }
+  }
+  best.resize(n);
+  return best;
+}
+
+/// 将一圈有效点写入点云消息，先按最大点数分配再截断，不逐点push_back。
+/// max_points大于0且有效点更多时按角度均匀分格降采样，每格保留最近的点（障碍物边缘不丢）
+static void fillCloudMsg(const LaserScan &scan, const std::string &frame_id,
+                         int max_points, sensor_msgs::msg::PointCloud &msg) {
+  msg.header.stamp.sec = RCL_NS_TO_S(scan.stamp);
+  msg.header.stamp.nanosec = scan.stamp - RCL_S_TO_NS(msg.header.stamp.sec);
+  msg.header.frame_id = frame_id;
+
+  msg.channels.resize(2);
+  const int idx_intensity = 0;
+  msg.channels[idx_intensity].name = "intensities";
+  const int idx_timestamp = 1;
+  msg.channels[idx_timestamp].name = "stamps";
+
+  const size_t count = scan.points.size();
+  msg.points.resize(count);
+  msg.channels[idx_intensity].values.resize(count);
+  msg.channels[idx_timestamp].values.resize(count);
+  geometry_msgs::msg::Point32 *points = msg.points.data();
+  float *intensities = msg.channels[idx_intensity].values.data();
+  float *stamps = msg.channels[idx_timestamp].values.data();
+  size_t n = 0;
+
+  if (max_points > 0 && count > static_cast<size_t>(max_points) &&
+      scan.config.max_angle > scan.config.min_angle) {
+    const std::vector<int> &selected = selectCloudPoints(scan, max_points);
+    for (size_t k = 0; k < selected.size(); k++) {
+      const size_t i = selected[k];
+      const LaserPoint &p = scan.points[i];
+      points[n].x = p.range * cos(p.angle);
+      points[n].y = p.range * sin(p.angle);
+      points[n].z = 0.0;
+      intensities[n] = p.intensity;
+      stamps[n] = i * scan.config.time_increment;
+      n++;
+    }
+  } else {
+    for (size_t i = 0; i < count; i++) {
+      const LaserPoint &p = scan.points[i];
+      if (p.range >= scan.config.min_range &&
+          p.range <= scan.config.max_range) {
+        points[n].x = p.range * cos(p.angle);
+        points[n].y = p.range * sin(p.angle);
+        points[n].z = 0.0;
+        intensities[n] = p.intensity;
+        stamps[n] = i * scan.config.time_increment;
+        n++;
+      }
+    }
+  }
+
+  msg.points.resize(n);
+  msg.channels[idx_intensity].values.resize(n);
+  msg.channels[idx_timestamp].values.resize(n);
+}
+
+/// 一圈距离编码为紧凑的距离图，供带宽有限的远程查看
+static void fillRangeImageMsg(const LaserScan &scan, const std::string &frame_id,
+                              float resolution, sensor_msgs::msg::CompressedImage &msg) {
+  msg.header.stamp.sec = RCL_NS_TO_S(scan.stamp);
+  msg.header.stamp.nanosec = scan.stamp - RCL_S_TO_NS(msg.header.stamp.sec);
+  msg.header.frame_id = frame_id;
+  msg.format = RANGE_IMAGE_FORMAT;
+  ydlidar_ros2::encodeRangeImage(scan, resolution, msg.data);
+}
+
+/// 底盘位姿写入里程计消息。速度为底盘坐标系中的速度，
+/// 匹配失败时位姿由预测推算，协方差相应放大
+static void fillOdomMsg(const ydlidar_ros2::Pose2D &pose, const ydlidar_ros2::Pose2D &velocity, bool matched,
+                        uint64_t stamp, const std::string &odom_frame,
+                        const std::string &base_frame, nav_msgs::msg::Odometry &msg) {
+  msg.header.stamp.sec = RCL_NS_TO_S(stamp);
+  msg.header.stamp.nanosec = stamp - RCL_S_TO_NS(msg.header.stamp.sec);
+  msg.header.frame_id = odom_frame;
+  msg.child_frame_id = base_frame;
+  msg.pose.pose.position.x = pose.x;
+  msg.pose.pose.position.y = pose.y;
+  msg.pose.pose.position.z = 0.0;
+  msg.pose.pose.orientation.x = 0.0;
+  msg.pose.pose.orientation.y = 0.0;
+  msg.pose.pose.orientation.z = sin(pose.yaw / 2);
+  msg.pose.pose.orientation.w = cos(pose.yaw / 2);
+  msg.twist.twist.linear.x = velocity.x;
+  msg.twist.twist.linear.y = velocity.y;
+  msg.twist.twist.linear.z = 0.0;
+  msg.twist.twist.angular.x = 0.0;
+  msg.twist.twist.angular.y = 0.0;
+  msg.twist.twist.angular.z = velocity.yaw;
+
+  //平面运动，z、roll、pitch不可观
+  const double linear = matched ? 1e-4 : 1e-1;
+  const double angular = matched ? 1e-3 : 1.0;
+  const double unused = 1e6;
+  const double diagonal[6] = {linear, linear, unused, unused, unused, angular};
+  for (size_t i = 0; i < 36; i++) {
+    msg.pose.covariance[i] = i % 7 ? 0.0 : diagonal[i / 7];
+    msg.twist.covariance[i] = msg.pose.covariance[i];
+  }
+}
+
+/// 没有订阅者时不组装消息
+template<typename MessageT>
+static bool hasSubscribers(const rclcpp::Publisher<MessageT> &pub) {
+  return pub.get_subscription_count() + pub.get_intra_process_subscription_count() > 0;
+}
+
+/// 进程内通信时以unique_ptr发布，同一容器内的订阅者直接接收不拷贝；
+/// 否则复用预分配的消息。这些消息含字符串和序列，不是定长类型，
+/// 中间件不会借出内存，也不能在未构造的借用内存上赋值
+template<typename MessageT, typename FillT>
+static void publishMsg(rclcpp::Publisher<MessageT> &pub, MessageT &cache,
+                       bool intra_process, FillT fill) {
+  if (intra_process) {
+    auto msg = std::make_unique<MessageT>();
+    fill(*msg);
+    pub.publish(std::move(msg));
+  } else {
+    fill(cache);
+    pub.publish(cache);
+  }
+}
+
+
+namespace ydlidar_ros2 {
+
+YdlidarNode::YdlidarNode(const rclcpp::NodeOptions &options)
+  : Node("ydlidar_ros2_driver_node", options),
+    intra_process_(options.use_intra_process_comms()),
+    running_(true) {
+  RCLCPP_INFO(get_logger(), "[YDLIDAR INFO] Current ROS Driver Version: %s\n", ((std::string)ROS2Verision).c_str());
+
+  declareParameters();
+
+  laser_pub_ = create_publisher<sensor_msgs::msg::LaserScan>("scan", rclcpp::SensorDataQoS());
+  pc_pub_ = create_publisher<sensor_msgs::msg::PointCloud>("point_cloud", rclcpp::SensorDataQoS());
+  if (range_image_) {
+    range_image_pub_ = create_publisher<sensor_msgs::msg::CompressedImage>("scan_range_image", rclcpp::SensorDataQoS());
+    if (!rangeImageHasLz4()) {
+      RCLCPP_WARN(get_logger(), "[YDLIDAR] Built without liblz4, range images are not compressed");
+    }
+  }
+  if (laser_odometry_) {
+    laser_odom_pub_ = create_publisher<nav_msgs::msg::Odometry>("laser_odom", rclcpp::SensorDataQoS());
+    if (!wheel_topic_.empty()) {
+      wheel_odom_sub_ = create_subscription<nav_msgs::msg::Odometry>(
+        wheel_topic_, rclcpp::SensorDataQoS(),
+        [this](const nav_msgs::msg::Odometry::SharedPtr msg) {
+          const auto &q = msg->pose.pose.orientation;
+          Pose2D pose;
+          pose.x = msg->pose.pose.position.x;
+          pose.y = msg->pose.pose.position.y;
+          pose.yaw = atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.y * q.y + q.z * q.z));
+          std::lock_guard<std::mutex> lock(wheel_lock_);
+          wheel_pose_ = pose;
+          has_wheel_ = true;
+        });
+    }
+  }
+
+  auto stop_scan_service =
+    [this](const std::shared_ptr<rmw_request_id_t> request_header,
+  const std::shared_ptr<std_srvs::srv::Empty::Request> req,
+  std::shared_ptr<std_srvs::srv::Empty::Response> response) -> bool
+  {
+    std::lock_guard<std::mutex> lock(lidar_lock_);
+    return lidars_.turnOff();
+  };
+
+  stop_service_ = create_service<std_srvs::srv::Empty>("stop_scan",stop_scan_service);
+
+  auto start_scan_service =
+    [this](const std::shared_ptr<rmw_request_id_t> request_header,
+  const std::shared_ptr<std_srvs::srv::Empty::Request> req,
+  std::shared_ptr<std_srvs::srv::Empty::Response> response) -> bool
+  {
+    std::lock_guard<std::mutex> lock(lidar_lock_);
+    return lidars_.turnOn();
+  };
+
+  start_service_ = create_service<std_srvs::srv::Empty>("start_scan",start_scan_service);
+
+  //雷达启动较慢，放到扫描线程中，不阻塞容器加载其他节点
+  scan_thread_ = std::thread(&YdlidarNode::scanLoop, this);
+}
+
+YdlidarNode::~YdlidarNode() {
+  running_ = false;
+  if (scan_thread_.joinable()) {
+    scan_thread_.join();
+  }
+
+  RCLCPP_INFO(get_logger(), "[YDLIDAR INFO] Now YDLIDAR is stopping .......");
+  lidars_.turnOff();
+  lidars_.disconnecting();
+}
+
+void YdlidarNode::declareParameters() {
+  std::string str_optvalue = "/dev/ydlidar";
+  declare_parameter("port", str_optvalue);
+  get_parameter("port", str_optvalue);
+  ///lidar port
+  laser_.setlidaropt(LidarPropSerialPort, str_optvalue.c_str(), str_optvalue.size());
+  ///merged lidars, same configuration on other ports
+  std::vector<std::string> merge_ports;
+  declare_parameter("merge_ports", merge_ports);
+  get_parameter("merge_ports", merge_ports);
+  ///mounting pose of each lidar: x(m) y(m) yaw(°), main lidar first
+  std::vector<double> mount_poses;
+  declare_parameter("mount_poses", mount_poses);
+  get_parameter("mount_poses", mount_poses);
+
+  for (size_t i = 0; i <= merge_ports.size(); i++) {
+    CYdLidar *lidar = &laser_;
+    if (i > 0) {
+      merge_lidars_.emplace_back(new CYdLidar());
+      lidar = merge_lidars_.back().get();
+      lidar->setlidaropt(LidarPropSerialPort, merge_ports[i - 1].c_str(), merge_ports[i - 1].size());
+    }
+    LidarMount mount;
+    if (mount_poses.size() >= 3 * (i + 1)) {
+      mount.x = mount_poses[3 * i];
+      mount.y = mount_poses[3 * i + 1];
+      mount.yaw = mount_poses[3 * i + 2] * M_PI / 180.0;
+    }
+    lidars_.addLidar(lidar, mount);
+  }
+  ///ignore array
+  str_optvalue = "";
+  declare_parameter("ignore_array", str_optvalue);
+  get_parameter("ignore_array", str_optvalue);
+  lidars_.setlidaropt(LidarPropIgnoreArray, str_optvalue.c_str(), str_optvalue.size());
+  ///raw data capture file, main lidar only
+  str_optvalue = "";
+  declare_parameter("capture_file", str_optvalue);
+  get_parameter("capture_file", str_optvalue);
+  laser_.setlidaropt(LidarPropCaptureFile, str_optvalue.c_str(), str_optvalue.size());
+  ///cached device profile file, shared by every lidar
+  str_optvalue = "";
+  declare_parameter("profile_file", str_optvalue);
+  get_parameter("profile_file", str_optvalue);
+  lidars_.setlidaropt(LidarPropProfileFile, str_optvalue.c_str(), str_optvalue.size());
+
+  frame_id_ = "laser_frame";
+  declare_parameter("frame_id", frame_id_);
+  get_parameter("frame_id", frame_id_);
+
+  //////////////////////int property/////////////////
+  /// lidar baudrate
+  int optval = 230400;
+  declare_parameter("baudrate", optval);
+  get_parameter("baudrate", optval);
+  lidars_.setlidaropt(LidarPropSerialBaudrate, &optval, sizeof(int));
+  /// tof lidar
+  optval = TYPE_TRIANGLE;
+  declare_parameter("lidar_type", optval);
+  get_parameter("lidar_type", optval);
+  lidars_.setlidaropt(LidarPropLidarType, &optval, sizeof(int));
+  /// device type
+  optval = YDLIDAR_TYPE_SERIAL;
+  declare_parameter("device_type", optval);
+  get_parameter("device_type", optval);
+  lidars_.setlidaropt(LidarPropDeviceType, &optval, sizeof(int));
+  /// sample rate
+  optval = 9;
+  declare_parameter("sample_rate", optval);
+  get_parameter("sample_rate", optval);
+  lidars_.setlidaropt(LidarPropSampleRate, &optval, sizeof(int));
+  /// abnormal count
+  optval = 4;
+  declare_parameter("abnormal_check_count", optval);
+  get_parameter("abnormal_check_count", optval);
+  lidars_.setlidaropt(LidarPropAbnormalCheckCount, &optval, sizeof(int));
+
+  /// Intenstiy bit count
+  optval = 8;
+  declare_parameter("intensity_bit", optval);
+  get_parameter("intensity_bit", optval);
+  lidars_.setlidaropt(LidarPropIntenstiyBit, &optval, sizeof(int));
+     
+  //////////////////////bool property/////////////////
+  /// fixed angle resolution
+  bool b_optvalue = false;
+  declare_parameter("fixed_resolution", b_optvalue);
+  get_parameter("fixed_resolution", b_optvalue);
+  lidars_.setlidaropt(LidarPropFixedResolution, &b_optvalue, sizeof(bool));
+  /// rotate 180
+  b_optvalue = true;
+  declare_parameter("reversion", b_optvalue);
+  get_parameter("reversion", b_optvalue);
+  lidars_.setlidaropt(LidarPropReversion, &b_optvalue, sizeof(bool));
+  /// Counterclockwise
+  b_optvalue = true;
+  declare_parameter("inverted", b_optvalue);
+  get_parameter("inverted", b_optvalue);
+  lidars_.setlidaropt(LidarPropInverted, &b_optvalue, sizeof(bool));
+  b_optvalue = true;
+  declare_parameter("auto_reconnect", b_optvalue);
+  get_parameter("auto_reconnect", b_optvalue);
+  lidars_.setlidaropt(LidarPropAutoReconnect, &b_optvalue, sizeof(bool));
+  /// one-way communication
+  b_optvalue = false;
+  declare_parameter("isSingleChannel", b_optvalue);
+  get_parameter("isSingleChannel", b_optvalue);
+  lidars_.setlidaropt(LidarPropSingleChannel, &b_optvalue, sizeof(bool));
+  /// intensity
+  // b_optvalue = false;
+  // declare_parameter("intensity", b_optvalue);
+  // get_parameter("intensity", b_optvalue);
+  // lidars_.setlidaropt(LidarPropIntenstiy, &b_optvalue, sizeof(bool));
+  for (size_t i = 0; i < lidars_.size(); i++) {
+    lidars_.lidar(i)->setAutoIntensity(true);
+  }
+  /// Motor DTR
+  b_optvalue = false;
+  declare_parameter("support_motor_dtr", b_optvalue);
+  get_parameter("support_motor_dtr", b_optvalue);
+  lidars_.setlidaropt(LidarPropSupportMotorDtrCtrl, &b_optvalue, sizeof(bool));
+  /// replay capture file at recorded pace
+  b_optvalue = true;
+  declare_parameter("replay_realtime", b_optvalue);
+  get_parameter("replay_realtime", b_optvalue);
+  lidars_.setlidaropt(LidarPropReplayRealtime, &b_optvalue, sizeof(bool));
+
+  //////////////////////float property/////////////////
+  /// unit: °
+  float f_optvalue = 180.0f;
+  declare_parameter("angle_max", f_optvalue);
+  get_parameter("angle_max", f_optvalue);
+  lidars_.setlidaropt(LidarPropMaxAngle, &f_optvalue, sizeof(float));
+  f_optvalue = -180.0f;
+  declare_parameter("angle_min", f_optvalue);
+  get_parameter("angle_min", f_optvalue);
+  lidars_.setlidaropt(LidarPropMinAngle, &f_optvalue, sizeof(float));
+  /// unit: m
+  f_optvalue = 64.f;
+  declare_parameter("range_max", f_optvalue);
+  get_parameter("range_max", f_optvalue);
+  lidars_.setlidaropt(LidarPropMaxRange, &f_optvalue, sizeof(float));
+  f_optvalue = 0.1f;
+  declare_parameter("range_min", f_optvalue);
+  get_parameter("range_min", f_optvalue);
+  lidars_.setlidaropt(LidarPropMinRange, &f_optvalue, sizeof(float));
+  /// unit: Hz
+  f_optvalue = 10.f;
+  declare_parameter("frequency", f_optvalue);
+  get_parameter("frequency", f_optvalue);
+  lidars_.setlidaropt(LidarPropScanFrequency, &f_optvalue, sizeof(float));
+
+  bool invalid_range_is_inf = false;
+  declare_parameter("invalid_range_is_inf", invalid_range_is_inf);
+  get_parameter("invalid_range_is_inf", invalid_range_is_inf);
+
+  /// 点云最大点数，0不降采样
+  cloud_max_points_ = 0;
+  declare_parameter("cloud_max_points", cloud_max_points_);
+  get_parameter("cloud_max_points", cloud_max_points_);
+
+  /// 额外发布压缩的距离图
+  range_image_ = false;
+  declare_parameter("range_image", range_image_);
+  get_parameter("range_image", range_image_);
+  range_image_resolution_ = 0.002;
+  declare_parameter("range_image_resolution", range_image_resolution_);
+  get_parameter("range_image_resolution", range_image_resolution_);
+  if (range_image_resolution_ <= 0.0) {
+    range_image_resolution_ = 0.002;
+  }
+
+  /// 激光里程计，发布laser_odom
+  laser_odom_ = false;
+  declare_parameter("laser_odom", laser_odom_);
+  get_parameter("laser_odom", laser_odom_);
+  wheel_topic_ = "odom";
+  declare_parameter("laser_odom_wheel_topic", wheel_topic_);
+  get_parameter("laser_odom_wheel_topic", wheel_topic_);
+  odom_frame_ = "odom";
+  declare_parameter("odom_frame", odom_frame_);
+  get_parameter("odom_frame", odom_frame_);
+  base_frame_ = "base_footprint";
+  declare_parameter("base_frame", base_frame_);
+  get_parameter("base_frame", base_frame_);
+  ///pose of frame_id in base_frame: x(m) y(m) yaw(°)
+  std::vector<double> laser_pose;
+  declare_parameter("laser_odom_base_pose", laser_pose);
+  get_parameter("laser_odom_base_pose", laser_pose);
+  if (laser_pose.size() >= 3) {
+    laser_mount_.x = laser_pose[0];
+    laser_mount_.y = laser_pose[1];
+    laser_mount_.yaw = laser_pose[2] * M_PI / 180.0;
+  }
+  LaserOdometryConfig odom_config;
+  declare_parameter("laser_odom_resolution", odom_config.resolution);
+  get_parameter("laser_odom_resolution", odom_config.resolution);
+  declare_parameter("laser_odom_max_range", odom_config.max_range);
+  get_parameter("laser_odom_max_range", odom_config.max_range);
+  declare_parameter("laser_odom_min_score", odom_config.min_score);
+  get_parameter("laser_odom_min_score", odom_config.min_score);
+  if (laser_odom_) {
+    laser_odometry_.reset(new LaserOdometry(odom_config));
+  }
+
+
+}
+
+void YdlidarNode::scanLoop() {
+  bool ret;
+  {
+    std::lock_guard<std::mutex> lock(lidar_lock_);
+    ret = lidars_.initialize();
+    if (ret) {
+      ret = lidars_.turnOn();
+    }
+  }
+  if (!ret) {
+    for (size_t i = 0; i < lidars_.size(); i++) {
+      RCLCPP_ERROR(get_logger(), "%s\n", lidars_.lidar(i)->DescribeError());
+    }
+  }
+
+  //扫描数据和消息在循环外分配，每圈复用其中的数组容量
+  LaserScan scan;
+  sensor_msgs::msg::LaserScan scan_msg;
+  sensor_msgs::msg::PointCloud pc_msg;
+  sensor_msgs::msg::CompressedImage ri_msg;
+  nav_msgs::msg::Odometry odom_msg;
+
+  while (ret && running_ && rclcpp::ok()) {
+    bool got_scan;
+    bool scanning;
+    {
+      //每圈数据就绪立即发布，超时只为及时处理服务请求和退出
+      //多个雷达时合并为一圈，以主雷达为基准
+      std::lock_guard<std::mutex> lock(lidar_lock_);
+      got_scan = lidars_.waitScan(scan, 100);
+      scanning = lidars_.isScanning();
+    }
+
+    if (got_scan) {
+      YDLIDAR_TRACE_SCOPE("publishScan");
+      if (hasSubscribers(*laser_pub_)) {
+        publishMsg(*laser_pub_, scan_msg, intra_process_,
+          [&](sensor_msgs::msg::LaserScan &msg) {
+            fillScanMsg(scan, frame_id_, msg);
+          });
+      }
+      if (hasSubscribers(*pc_pub_)) {
+        publishMsg(*pc_pub_, pc_msg, intra_process_,
+          [&](sensor_msgs::msg::PointCloud &msg) {
+            fillCloudMsg(scan, frame_id_, cloud_max_points_, msg);
+          });
+      }
+      if (range_image_pub_ && hasSubscribers(*range_image_pub_)) {
+        publishMsg(*range_image_pub_, ri_msg, intra_process_,
+          [&](sensor_msgs::msg::CompressedImage &msg) {
+            fillRangeImageMsg(scan, frame_id_, range_image_resolution_, msg);
+          });
+      }
+      if (laser_odometry_) {
+        publishLaserOdom(scan, odom_msg);
+      }
+
+    } else if (!scanning) {
+      RCLCPP_ERROR(get_logger(), "Failed to get scan");
+    }
+  }
+}
+
+void YdlidarNode::publishLaserOdom(const LaserScan &scan, nav_msgs::msg::Odometry &msg) {
+  //两圈之间的底盘位移换算为雷达位移，作为匹配的预测
+  Pose2D motion;
+  {
+    std::lock_guard<std::mutex> lock(wheel_lock_);
+    if (has_wheel_) {
+      if (has_used_wheel_) {
+        const Pose2D base_motion = composePose(invertPose(used_wheel_pose_), wheel_pose_);
+        motion = composePose(composePose(invertPose(laser_mount_), base_motion), laser_mount_);
+      }
+      used_wheel_pose_ = wheel_pose_;
+      has_used_wheel_ = true;
+    }
+  }
+
+  Pose2D laser_pose;
+  bool matched;
+  {
+    YDLIDAR_TRACE_SCOPE("laserOdometry");
+    matched = laser_odometry_->update(scan, motion, laser_pose);
+  }
+
+  //里程计坐标系原点为底盘的起始位姿
+  const Pose2D base_pose = composePose(composePose(laser_mount_, laser_pose),
+                                       invertPose(laser_mount_));
+  Pose2D velocity;
+  if (last_odom_stamp_ && scan.stamp > last_odom_stamp_) {
+    const double dt = (scan.stamp - last_odom_stamp_) * 1e-9;
+    const Pose2D delta = composePose(invertPose(last_base_pose_), base_pose);
+    velocity.x = delta.x / dt;
+    velocity.y = delta.y / dt;
+    velocity.yaw = delta.yaw / dt;
+  }
+  last_base_pose_ = base_pose;
+  last_odom_stamp_ = scan.stamp;
+
+  if (hasSubscribers(*laser_odom_pub_)) {
+    publishMsg(*laser_odom_pub_, msg, intra_process_,
+      [&](nav_msgs::msg::Odometry &odom) {
+        fillOdomMsg(base_pose, velocity, matched, scan.stamp, odom_frame_, base_frame_, odom);
+      });
+  }
+}
+
+}  // namespace ydlidar_ros2
+
+RCLCPP_COMPONENTS_REGISTER_NODE(ydlidar_ros2::YdlidarNode)
@@ -0,0 +1,90 @@
+/*
+ *  YDLIDAR SYSTEM
+ *  YDLIDAR ROS 2 Node
+ *
+ *  Copyright 2017 - 2020 EAI TEAM
+ *  http://www.eaibot.com
+ *
+ */
+
+#ifndef YDLIDAR_COMPONENT_H
+#define YDLIDAR_COMPONENT_H
+
+#include "src/CYdLidar.h"
+#include "src/CYdLidarGroup.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rclcpp/rclcpp.hpp"
+#include "sensor_msgs/msg/laser_scan.hpp"
+#include "sensor_msgs/msg/point_cloud.hpp"
+#include "sensor_msgs/msg/compressed_image.hpp"
+#include "nav_msgs/msg/odometry.hpp"
+#include "std_srvs/srv/empty.hpp"
+#include "laser_odometry.h"
+
+namespace ydlidar_ros2 {
+
+/**
+ * @brief LiDAR driver node, loadable into a component container.
+ * @note The LiDARs are brought up and read on a thread of the node, the
+ * executor only serves the start/stop services. With intra-process
+ * communication enabled every revolution is published as a unique_ptr,
+ * so subscribers in the same container receive it without a copy.
+ */
+class YdlidarNode : public rclcpp::Node {
+ public:
+  explicit YdlidarNode(const rclcpp::NodeOptions &options = rclcpp::NodeOptions());
+  ~YdlidarNode();
+
+ private:
+  /// 读取参数并配置各雷达
+  void declareParameters();
+  /// 扫描线程：启动雷达后逐圈发布
+  void scanLoop();
+  /// 激光里程计匹配一圈并发布底盘位姿
+  void publishLaserOdom(const LaserScan &scan, nav_msgs::msg::Odometry &msg);
+
+  CYdLidar laser_;
+  std::vector<std::unique_ptr<CYdLidar>> merge_lidars_;
+  CYdLidarGroup lidars_;
+  std::string frame_id_;
+  bool intra_process_;
+  int cloud_max_points_;
+  bool range_image_;
+  double range_image_resolution_;
+
+  //激光里程计
+  bool laser_odom_;
+  std::string wheel_topic_;           ///< 轮式里程计话题，作为匹配的预测，空则不用
+  std::string odom_frame_;
+  std::string base_frame_;
+  Pose2D laser_mount_;                ///< 雷达在底盘坐标系中的位姿
+  std::unique_ptr<LaserOdometry> laser_odometry_;
+  Pose2D last_base_pose_;
+  uint64_t last_odom_stamp_ = 0;
+  std::mutex wheel_lock_;             ///< 轮式里程计回调与扫描线程共享
+  bool has_wheel_ = false;
+  Pose2D wheel_pose_;                 ///< 最新的轮式里程计位姿
+  Pose2D used_wheel_pose_;            ///< 上一圈使用的轮式里程计位姿
+  bool has_used_wheel_ = false;
+
+  rclcpp::Publisher<sensor_msgs::msg::LaserScan>::SharedPtr laser_pub_;
+  rclcpp::Publisher<sensor_msgs::msg::PointCloud>::SharedPtr pc_pub_;
+  rclcpp::Publisher<sensor_msgs::msg::CompressedImage>::SharedPtr range_image_pub_;
+  rclcpp::Publisher<nav_msgs::msg::Odometry>::SharedPtr laser_odom_pub_;
+  rclcpp::Subscription<nav_msgs::msg::Odometry>::SharedPtr wheel_odom_sub_;
+  rclcpp::Service<std_srvs::srv::Empty>::SharedPtr stop_service_;
+  rclcpp::Service<std_srvs::srv::Empty>::SharedPtr start_service_;
+
+  std::mutex lidar_lock_; //服务回调与扫描线程不能同时操作雷达
+  std::atomic<bool> running_;
+  std::thread scan_thread_;
+};
+
+}  // namespace ydlidar_ros2
+
+#endif  // YDLIDAR_COMPONENT_H